@@ -0,0 +1,161 @@
+#include "ArenaWorkflow.h"
+#include "MappedFile.h"
+#include "Metrics.h"
+
+#include <filesystem>
+
+namespace WorkspaceBuilder {
+    namespace Structs {
+
+        ArenaWorkflow::ArenaWorkflow(size_t initialSize)
+            : arena(new std::pmr::monotonic_buffer_resource(initialSize)) {
+            // The workflow itself is also placed in the arena
+            std::pmr::polymorphic_allocator<PmrWorkflow> allocator(arena.get());
+            workflow = allocator.allocate(1);
+            new (workflow) PmrWorkflow(std::pmr::polymorphic_allocator<char>(arena.get()));
+        }
+
+        ArenaWorkflow::~ArenaWorkflow() {
+            // Every string and vector of the workflow was allocated in the arena and a monotonic
+            //   arena ignores single frees, so the workflow destructor is skipped and the arena is released at once
+            workflow = nullptr;
+            arena.reset();
+        }
+
+        ArenaWorkflow::ArenaWorkflow(ArenaWorkflow&& other) noexcept
+            : arena(std::move(other.arena)), workflow(other.workflow) {
+            other.workflow = nullptr;
+        }
+
+        ArenaWorkflow& ArenaWorkflow::operator=(ArenaWorkflow&& other) noexcept {
+            if (this != &other) {
+                arena = std::move(other.arena);
+                workflow = other.workflow;
+                other.workflow = nullptr;
+            }
+
+            return *this;
+        }
+    }
+
+    namespace Functions {
+
+        // Line sink of DispatchLine that places what each line holds in the arena workflow
+        struct ArenaLineSink {
+            WorkspaceBuilder::Structs::PmrWorkflow& workflow;
+            bool verbose;
+            // Reused for the variables of every glyph
+            std::vector<WorkspaceBuilder::Structs::VariableView> blockVariables;
+
+            void OnGlobalVariable(std::string_view line, [[maybe_unused]] int lineNumber) {
+                WorkspaceBuilder::Structs::VariableView variable = ParseGlobalVariableLineView(line);
+                workflow.globalVariables.emplace_back(variable.key, variable.value, variable.type);
+            }
+
+            void OnComment(std::string_view text, int lineNumber) {
+                static const WorkspaceBuilder::Structs::Vector2 nullPosition = { 0.0, 0.0 };
+                workflow.comments.emplace_back(lineNumber, text, nullPosition);
+            }
+
+            void OnGlyph(std::string_view line, int lineNumber) {
+                WORKSPACE_BUILDER_VERBOSE(verbose, "Found Glyph on line " << lineNumber << ">>> " << line << '\n');
+
+                blockVariables.clear();
+                WorkspaceBuilder::Structs::BlockView view = ParseBlockLineView(line, blockVariables, verbose);
+
+                WorkspaceBuilder::Structs::PmrBlock& block = workflow.blocks.emplace_back();
+                block.id = view.id;
+                block.type = view.type;
+                block.hostMachine = view.hostMachine;
+                block.position = view.position;
+
+                block.variables.reserve(blockVariables.size());
+                for (const WorkspaceBuilder::Structs::VariableView& variable : blockVariables) {
+                    block.variables.emplace_back(variable.key, variable.value, variable.type);
+                }
+            }
+
+            void OnConnection(std::string_view line, [[maybe_unused]] int lineNumber) {
+                WorkspaceBuilder::Structs::ConnectionView view = ParseConnectionLineView(line, (int)workflow.connections.size(), verbose);
+                WorkspaceBuilder::Structs::PmrConnection& connection = workflow.connections.emplace_back(view.id, view.startBlock, view.outputStartBlock, view.endBlock, view.inputEndBlock);
+
+                // Port names are case insensitive
+                WorkspaceBuilder::SupportFunctions::ToLower(connection.outputStartBlock, connection.outputStartBlock.data());
+                WorkspaceBuilder::SupportFunctions::ToLower(connection.inputEndBlock, connection.inputEndBlock.data());
+            }
+        };
+
+        WorkspaceBuilder::Structs::ArenaWorkflow ParseWorkflowIntoArena(std::string_view buffer, bool verbose) {
+            // The parsed workflow takes about twice the text size
+            WorkspaceBuilder::Structs::ArenaWorkflow result(buffer.size() * 2 + 4096);
+            WorkspaceBuilder::Structs::LineCursor cursor;
+            ArenaLineSink sink = { result.Workflow(), verbose, {} };
+
+            WorkspaceBuilder::SupportFunctions::DispatchLines(buffer, cursor, sink);
+
+            return result;
+        }
+
+        WorkspaceBuilder::Structs::ArenaWorkflow LoadWorkflowIntoArena(const std::string& path, bool verbose) {
+            // Compressed files are parsed while they are inflated. Their text is about 5 times their size
+            if (WorkspaceBuilder::SupportFunctions::IsGzipPath(path)) {
+                std::error_code error;
+                uintmax_t fileSize = std::filesystem::file_size(path, error);
+
+                WorkspaceBuilder::Structs::ArenaWorkflow result(error ? 64 * 1024 : (size_t)fileSize * 10 + 4096);
+                WorkspaceBuilder::Structs::LineCursor cursor;
+                ArenaLineSink sink = { result.Workflow(), verbose, {} };
+
+                WorkspaceBuilder::SupportFunctions::DispatchGzipLines(path, cursor, sink);
+
+                return result;
+            }
+
+            WorkspaceBuilder::SupportFunctions::MappedFile file(path);
+
+            return ParseWorkflowIntoArena(file.View(), verbose);
+        }
+
+        WorkspaceBuilder::Structs::Workflow ConvertPmrWorkflowToWorkflow(const WorkspaceBuilder::Structs::PmrWorkflow& workflow) {
+            WorkspaceBuilder::Structs::Workflow result;
+
+            result.globalVariables.reserve(workflow.globalVariables.size());
+            for (const WorkspaceBuilder::Structs::PmrVariable& variable : workflow.globalVariables) {
+                result.globalVariables.push_back(WorkspaceBuilder::Functions::ConvertVariableViewToVariable({ variable.key, variable.value, variable.type }));
+            }
+
+            result.blocks.reserve(workflow.blocks.size());
+            for (const WorkspaceBuilder::Structs::PmrBlock& pmrBlock : workflow.blocks) {
+                WorkspaceBuilder::Structs::Block block;
+                block.id = pmrBlock.id;
+                block.type = std::string(pmrBlock.type);
+                block.hostMachine = std::string(pmrBlock.hostMachine);
+                block.position = pmrBlock.position;
+
+                for (const WorkspaceBuilder::Structs::PmrVariable& variable : pmrBlock.variables) {
+                    block.variables.push_back(WorkspaceBuilder::Functions::ConvertVariableViewToVariable({ variable.key, variable.value, variable.type }));
+                }
+                for (const WorkspaceBuilder::Structs::PmrPort& input : pmrBlock.inputs) {
+                    block.inputs.push_back({ std::string(input.name), input.type });
+                }
+                for (const WorkspaceBuilder::Structs::PmrPort& output : pmrBlock.outputs) {
+                    block.outputs.push_back({ std::string(output.name), output.type });
+                }
+
+                result.blocks.push_back(std::move(block));
+            }
+
+            result.connections.reserve(workflow.connections.size());
+            for (const WorkspaceBuilder::Structs::PmrConnection& connection : workflow.connections) {
+                result.connections.push_back({ connection.id, connection.startBlock, std::string(connection.outputStartBlock), connection.endBlock, std::string(connection.inputEndBlock) });
+            }
+
+            result.comments.reserve(workflow.comments.size());
+            for (const WorkspaceBuilder::Structs::PmrComment& comment : workflow.comments) {
+                result.comments.push_back({ comment.line, std::string(comment.text), comment.position });
+            }
+
+            return result;
+        }
+    }
+}
@@ -0,0 +1,206 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include <memory>
+#include <memory_resource>
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // Allocator aware versions of the workflow structures. Containers of them pass their memory resource
+        //   down to every string and vector, so a whole workflow can live in a single arena.
+
+        // Allocator aware Variable. Only the text is kept, ConvertPmrWorkflowToWorkflow decodes the value
+        struct PmrVariable {
+            using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+            std::pmr::string key;
+            std::pmr::string value;
+            WorkspaceBuilder::Enums::VariableType type = WorkspaceBuilder::Enums::VariableType::String;
+
+            explicit PmrVariable(const allocator_type& allocator = {}) : key(allocator), value(allocator) {}
+            PmrVariable(std::string_view key, std::string_view value, WorkspaceBuilder::Enums::VariableType type, const allocator_type& allocator = {})
+                : key(key, allocator), value(value, allocator), type(type) {}
+            PmrVariable(const PmrVariable& other, const allocator_type& allocator)
+                : key(other.key, allocator), value(other.value, allocator), type(other.type) {}
+            PmrVariable(PmrVariable&& other, const allocator_type& allocator)
+                : key(std::move(other.key), allocator), value(std::move(other.value), allocator), type(other.type) {}
+            PmrVariable(const PmrVariable&) = default;
+            PmrVariable(PmrVariable&&) = default;
+            PmrVariable& operator=(const PmrVariable&) = default;
+            PmrVariable& operator=(PmrVariable&&) = default;
+        };
+
+        // Allocator aware Input and Output
+        struct PmrPort {
+            using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+            std::pmr::string name;
+            WorkspaceBuilder::Enums::VariableType type = WorkspaceBuilder::Enums::VariableType::Data;
+
+            explicit PmrPort(const allocator_type& allocator = {}) : name(allocator) {}
+            PmrPort(std::string_view name, WorkspaceBuilder::Enums::VariableType type, const allocator_type& allocator = {})
+                : name(name, allocator), type(type) {}
+            PmrPort(const PmrPort& other, const allocator_type& allocator) : name(other.name, allocator), type(other.type) {}
+            PmrPort(PmrPort&& other, const allocator_type& allocator) : name(std::move(other.name), allocator), type(other.type) {}
+            PmrPort(const PmrPort&) = default;
+            PmrPort(PmrPort&&) = default;
+            PmrPort& operator=(const PmrPort&) = default;
+            PmrPort& operator=(PmrPort&&) = default;
+        };
+
+        // Allocator aware Comment
+        struct PmrComment {
+            using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+            int line = 0;
+            std::pmr::string text;
+            Vector2 position = { 0, 0 };
+
+            explicit PmrComment(const allocator_type& allocator = {}) : text(allocator) {}
+            PmrComment(int line, std::string_view text, Vector2 position, const allocator_type& allocator = {})
+                : line(line), text(text, allocator), position(position) {}
+            PmrComment(const PmrComment& other, const allocator_type& allocator)
+                : line(other.line), text(other.text, allocator), position(other.position) {}
+            PmrComment(PmrComment&& other, const allocator_type& allocator)
+                : line(other.line), text(std::move(other.text), allocator), position(other.position) {}
+            PmrComment(const PmrComment&) = default;
+            PmrComment(PmrComment&&) = default;
+            PmrComment& operator=(const PmrComment&) = default;
+            PmrComment& operator=(PmrComment&&) = default;
+        };
+
+        // Allocator aware Connection
+        struct PmrConnection {
+            using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+            int id = 0;
+            int startBlock = 0;
+            std::pmr::string outputStartBlock;
+            int endBlock = 0;
+            std::pmr::string inputEndBlock;
+
+            explicit PmrConnection(const allocator_type& allocator = {}) : outputStartBlock(allocator), inputEndBlock(allocator) {}
+            PmrConnection(int id, int startBlock, std::string_view outputStartBlock, int endBlock, std::string_view inputEndBlock, const allocator_type& allocator = {})
+                : id(id), startBlock(startBlock), outputStartBlock(outputStartBlock, allocator), endBlock(endBlock), inputEndBlock(inputEndBlock, allocator) {}
+            PmrConnection(const PmrConnection& other, const allocator_type& allocator)
+                : id(other.id), startBlock(other.startBlock), outputStartBlock(other.outputStartBlock, allocator), endBlock(other.endBlock), inputEndBlock(other.inputEndBlock, allocator) {}
+            PmrConnection(PmrConnection&& other, const allocator_type& allocator)
+                : id(other.id), startBlock(other.startBlock), outputStartBlock(std::move(other.outputStartBlock), allocator), endBlock(other.endBlock), inputEndBlock(std::move(other.inputEndBlock), allocator) {}
+            PmrConnection(const PmrConnection&) = default;
+            PmrConnection(PmrConnection&&) = default;
+            PmrConnection& operator=(const PmrConnection&) = default;
+            PmrConnection& operator=(PmrConnection&&) = default;
+        };
+
+        // Allocator aware Block
+        struct PmrBlock {
+            using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+            int id = 0;
+            std::pmr::string type;
+            std::pmr::string hostMachine;
+            Vector2 position = { 0, 0 };
+            std::pmr::vector<PmrVariable> variables;
+            std::pmr::vector<PmrPort> inputs;
+            std::pmr::vector<PmrPort> outputs;
+
+            explicit PmrBlock(const allocator_type& allocator = {})
+                : type(allocator), hostMachine(allocator), variables(allocator), inputs(allocator), outputs(allocator) {}
+            PmrBlock(const PmrBlock& other, const allocator_type& allocator)
+                : id(other.id), type(other.type, allocator), hostMachine(other.hostMachine, allocator), position(other.position),
+                variables(other.variables, allocator), inputs(other.inputs, allocator), outputs(other.outputs, allocator) {}
+            PmrBlock(PmrBlock&& other, const allocator_type& allocator)
+                : id(other.id), type(std::move(other.type), allocator), hostMachine(std::move(other.hostMachine), allocator), position(other.position),
+                variables(std::move(other.variables), allocator), inputs(std::move(other.inputs), allocator), outputs(std::move(other.outputs), allocator) {}
+            PmrBlock(const PmrBlock&) = default;
+            PmrBlock(PmrBlock&&) = default;
+            PmrBlock& operator=(const PmrBlock&) = default;
+            PmrBlock& operator=(PmrBlock&&) = default;
+        };
+
+        // Allocator aware Workflow
+        struct PmrWorkflow {
+            using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+            std::pmr::vector<PmrVariable> globalVariables;
+            std::pmr::vector<PmrBlock> blocks;
+            std::pmr::vector<PmrConnection> connections;
+            std::pmr::vector<PmrComment> comments;
+
+            explicit PmrWorkflow(const allocator_type& allocator = {})
+                : globalVariables(allocator), blocks(allocator), connections(allocator), comments(allocator) {}
+            PmrWorkflow(const PmrWorkflow& other, const allocator_type& allocator)
+                : globalVariables(other.globalVariables, allocator), blocks(other.blocks, allocator), connections(other.connections, allocator), comments(other.comments, allocator) {}
+            PmrWorkflow(PmrWorkflow&& other, const allocator_type& allocator)
+                : globalVariables(std::move(other.globalVariables), allocator), blocks(std::move(other.blocks), allocator), connections(std::move(other.connections), allocator), comments(std::move(other.comments), allocator) {}
+            PmrWorkflow(const PmrWorkflow&) = default;
+            PmrWorkflow(PmrWorkflow&&) = default;
+            PmrWorkflow& operator=(const PmrWorkflow&) = default;
+            PmrWorkflow& operator=(PmrWorkflow&&) = default;
+        };
+
+        // A workflow that lives entirely inside a monotonic arena.
+        //   Destroying it releases the whole arena at once, without freeing each string and vector.
+        class ArenaWorkflow {
+        public:
+            /**
+            * Creates an empty workflow in a new arena
+            *
+            * @param initialSize: Size of the first arena block. A good guess avoids growing the arena. Default = 64KB
+            */
+            explicit ArenaWorkflow(size_t initialSize = 64 * 1024);
+            ~ArenaWorkflow();
+
+            ArenaWorkflow(const ArenaWorkflow&) = delete;
+            ArenaWorkflow& operator=(const ArenaWorkflow&) = delete;
+            ArenaWorkflow(ArenaWorkflow&& other) noexcept;
+            ArenaWorkflow& operator=(ArenaWorkflow&& other) noexcept;
+
+            // The workflow stored in the arena
+            PmrWorkflow& Workflow() { return *workflow; }
+            const PmrWorkflow& Workflow() const { return *workflow; }
+
+            // The arena, for callers that want to add their own data with the same lifetime
+            std::pmr::memory_resource* Resource() const { return arena.get(); }
+
+        private:
+            std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+            PmrWorkflow* workflow = nullptr;
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Parses a wksp file content placing the whole workflow in a monotonic arena
+        *
+        * @param buffer: The wksp file content
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return The workflow and its arena. The result is the same as ParseWorkflowBuffer
+        *
+        * @throws Not a valid format > if a variable is declared and is not following the pattern 'key value'
+        */
+        WorkspaceBuilder::Structs::ArenaWorkflow ParseWorkflowIntoArena(std::string_view buffer, bool verbose = false);
+
+        /**
+        * Memory maps a wksp file and parses it into a monotonic arena. A .wksp.gz file is parsed while it is inflated instead
+        *
+        * @param path: The string address of a valid file
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return The workflow and its arena
+        *
+        * @throws Unable to open file> if the given path is invalid || Not a valid gzip file> if a .gz file is broken
+        */
+        WorkspaceBuilder::Structs::ArenaWorkflow LoadWorkflowIntoArena(const std::string& path, bool verbose = false);
+
+        /**
+        * Copies an allocator aware workflow into the standard workflow structure
+        *
+        * @param workflow: The workflow to be copied
+        * @return A VGL Workflow structure
+        */
+        WorkspaceBuilder::Structs::Workflow ConvertPmrWorkflowToWorkflow(const WorkspaceBuilder::Structs::PmrWorkflow& workflow);
+    }
+    #pragma endregion
+}
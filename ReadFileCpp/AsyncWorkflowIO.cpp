@@ -0,0 +1,302 @@
+#include "AsyncWorkflowIO.h"
+#include "GzipStream.h"
+#include "WorkflowWriter.h"
+
+#include <fstream>
+#include <memory>
+
+namespace WorkspaceBuilder {
+    namespace Structs {
+
+        // Reads the whole file on the calling thread. A memory mapping would move the disk wait into the parse
+        //   thread, where its pages are first touched
+        static std::string ReadWholeFile(const std::string& path) {
+            std::ifstream myFile(path, std::ios::in | std::ios::binary | std::ios::ate);
+
+            if (!myFile) {
+                throw std::runtime_error("LoadWorkflowAsync error >> Unable to open file");
+            }
+
+            std::string content((size_t)myFile.tellg(), '\0');
+            myFile.seekg(0);
+            myFile.read(&content[0], content.size());
+
+            if (myFile.fail()) {
+                throw std::runtime_error("LoadWorkflowAsync error >> Unable to read file");
+            }
+
+            return content;
+        }
+
+        // Writes a serialized workflow in text mode, like WriteWorkflowFile
+        static bool WriteWholeFile(const std::string& filename, const std::string& content) {
+            if (WorkspaceBuilder::SupportFunctions::IsGzipPath(filename)) {
+                WorkspaceBuilder::SupportFunctions::GzipWriter writer(filename);
+
+                if (!writer.IsOpen()) {
+                    return false;
+                }
+
+                writer.Write(content);
+                return writer.Close();
+            }
+
+            std::ofstream myFile(filename, std::ios::out);
+
+            if (!myFile) {
+                return false;
+            }
+
+            myFile.write(content.data(), content.size());
+            myFile.close();
+
+            return !myFile.fail();
+        }
+
+        class WorkflowIOPool::OperationGuard {
+        public:
+            explicit OperationGuard(WorkflowIOPool& pool) : pool(&pool) {}
+            ~OperationGuard() { if (pool) pool->EndOperation(); }
+
+            OperationGuard(const OperationGuard&) = delete;
+            OperationGuard& operator=(const OperationGuard&) = delete;
+
+            // The operation goes on in a stage already pushed, which ends it instead
+            void Release() { pool = nullptr; }
+
+        private:
+            WorkflowIOPool* pool;
+        };
+
+        WorkflowIOPool::WorkflowIOPool(int ioThreadCount, int parseThreadCount) {
+            if (parseThreadCount <= 0) {
+                parseThreadCount = (int)std::thread::hardware_concurrency();
+            }
+
+            StartThreads(ioQueue, ioThreadCount > 0 ? ioThreadCount : 1);
+            StartThreads(parseQueue, parseThreadCount > 0 ? parseThreadCount : 1);
+        }
+
+        WorkflowIOPool::~WorkflowIOPool() {
+            // An operation may still push its next stage into either queue, so both stop only after every operation ended
+            {
+                std::unique_lock<std::mutex> lock(operationMutex);
+                operationCondition.wait(lock, [&]() { return runningOperations == 0; });
+            }
+
+            StopThreads(ioQueue);
+            StopThreads(parseQueue);
+        }
+
+        void WorkflowIOPool::StartThreads(TaskQueue& queue, int threadCount) {
+            for (int i = 0; i < threadCount; i++) {
+                queue.threads.emplace_back([&queue]() {
+                    while (true) {
+                        std::function<void()> task;
+                        {
+                            std::unique_lock<std::mutex> lock(queue.mutex);
+                            queue.condition.wait(lock, [&]() { return queue.isStopping || !queue.tasks.empty(); });
+
+                            if (queue.tasks.empty()) return;
+
+                            task = std::move(queue.tasks.front());
+                            queue.tasks.pop_front();
+                        }
+
+                        // A throwing callback must not end the thread. The guard of the task already ended its operation
+                        try {
+                            task();
+                        }
+                        catch (...) {
+                        }
+                    }
+                });
+            }
+        }
+
+        void WorkflowIOPool::StopThreads(TaskQueue& queue) {
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.isStopping = true;
+            }
+            queue.condition.notify_all();
+
+            for (std::thread& thread : queue.threads) {
+                thread.join();
+            }
+        }
+
+        void WorkflowIOPool::Push(TaskQueue& queue, std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(std::move(task));
+            }
+            queue.condition.notify_one();
+        }
+
+        void WorkflowIOPool::BeginOperation() {
+            std::lock_guard<std::mutex> lock(operationMutex);
+            runningOperations++;
+        }
+
+        void WorkflowIOPool::EndOperation() {
+            std::lock_guard<std::mutex> lock(operationMutex);
+            if (--runningOperations == 0) {
+                operationCondition.notify_all();
+            }
+        }
+
+        void WorkflowIOPool::LoadWorkflowAsync(const std::string& path, LoadCallback callback) {
+            BeginOperation();
+            OperationGuard operation(*this);
+
+            // Inflating keeps a thread busy more than the disk does, so compressed files are read and parsed together on a parse thread
+            if (WorkspaceBuilder::SupportFunctions::IsGzipPath(path)) {
+                Push(parseQueue, [this, path, callback]() {
+                    OperationGuard operation(*this);
+                    WorkspaceBuilder::Structs::Workflow workflow;
+                    std::exception_ptr error;
+
+                    try {
+                        workflow = WorkspaceBuilder::Functions::LoadWorkflow(path);
+                    }
+                    catch (...) {
+                        error = std::current_exception();
+                    }
+
+                    callback(std::move(workflow), error);
+                });
+                operation.Release();
+                return;
+            }
+
+            // std::function must be copyable, so the buffer travels between the stages in a shared pointer
+            Push(ioQueue, [this, path, callback]() {
+                OperationGuard operation(*this);
+                std::shared_ptr<std::string> content;
+
+                try {
+                    content = std::make_shared<std::string>(ReadWholeFile(path));
+                }
+                catch (...) {
+                    callback(WorkspaceBuilder::Structs::Workflow(), std::current_exception());
+                    return;
+                }
+
+                Push(parseQueue, [this, content, callback]() {
+                    OperationGuard operation(*this);
+                    WorkspaceBuilder::Structs::Workflow workflow;
+                    std::exception_ptr error;
+
+                    try {
+                        workflow = WorkspaceBuilder::Functions::ParseWorkflowBuffer(*content);
+                    }
+                    catch (...) {
+                        error = std::current_exception();
+                    }
+
+                    callback(std::move(workflow), error);
+                });
+                operation.Release();
+            });
+            operation.Release();
+        }
+
+        std::future<WorkspaceBuilder::Structs::Workflow> WorkflowIOPool::LoadWorkflowAsync(const std::string& path) {
+            std::shared_ptr<std::promise<WorkspaceBuilder::Structs::Workflow>> promise = std::make_shared<std::promise<WorkspaceBuilder::Structs::Workflow>>();
+
+            LoadWorkflowAsync(path, [promise](WorkspaceBuilder::Structs::Workflow&& workflow, std::exception_ptr error) {
+                if (error) promise->set_exception(error);
+                else promise->set_value(std::move(workflow));
+            });
+
+            return promise->get_future();
+        }
+
+        void WorkflowIOPool::SaveWorkflowAsync(const std::string& filename, WorkspaceBuilder::Structs::Workflow workflow, SaveCallback callback) {
+            BeginOperation();
+            OperationGuard operation(*this);
+
+            std::shared_ptr<WorkspaceBuilder::Structs::Workflow> savedWorkflow = std::make_shared<WorkspaceBuilder::Structs::Workflow>(std::move(workflow));
+
+            Push(parseQueue, [this, filename, savedWorkflow, callback]() {
+                OperationGuard operation(*this);
+                std::shared_ptr<std::string> content = std::make_shared<std::string>();
+
+                try {
+                    WorkspaceBuilder::Functions::SerializeWorkflow(*savedWorkflow, *content);
+                }
+                catch (...) {
+                    callback(false);
+                    return;
+                }
+
+                Push(ioQueue, [this, filename, content, callback]() {
+                    OperationGuard operation(*this);
+                    bool isSaved = false;
+
+                    try {
+                        isSaved = WriteWholeFile(filename, *content);
+                    }
+                    catch (...) {
+                    }
+
+                    callback(isSaved);
+                });
+                operation.Release();
+            });
+            operation.Release();
+        }
+
+        std::future<bool> WorkflowIOPool::SaveWorkflowAsync(const std::string& filename, WorkspaceBuilder::Structs::Workflow workflow) {
+            std::shared_ptr<std::promise<bool>> promise = std::make_shared<std::promise<bool>>();
+
+            SaveWorkflowAsync(filename, std::move(workflow), [promise](bool isSaved) {
+                promise->set_value(isSaved);
+            });
+
+            return promise->get_future();
+        }
+
+        std::future<std::vector<std::string>> WorkflowIOPool::GetLinesFromFileAsync(const std::string& path) {
+            std::shared_ptr<std::promise<std::vector<std::string>>> promise = std::make_shared<std::promise<std::vector<std::string>>>();
+            BeginOperation();
+            OperationGuard operation(*this);
+
+            Push(ioQueue, [this, path, promise]() {
+                OperationGuard operation(*this);
+
+                try {
+                    promise->set_value(WorkspaceBuilder::SupportFunctions::GetLinesFromFile(path));
+                }
+                catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+            operation.Release();
+
+            return promise->get_future();
+        }
+
+        std::future<bool> WorkflowIOPool::SaveWkspfileAsync(const std::string& filename, std::vector<std::string> lines) {
+            std::shared_ptr<std::promise<bool>> promise = std::make_shared<std::promise<bool>>();
+            std::shared_ptr<std::vector<std::string>> savedLines = std::make_shared<std::vector<std::string>>(std::move(lines));
+            BeginOperation();
+            OperationGuard operation(*this);
+
+            Push(ioQueue, [this, filename, savedLines, promise]() {
+                OperationGuard operation(*this);
+
+                try {
+                    promise->set_value(WorkspaceBuilder::SupportFunctions::SaveWkspfile(filename, *savedLines));
+                }
+                catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+            operation.Release();
+
+            return promise->get_future();
+        }
+    }
+}
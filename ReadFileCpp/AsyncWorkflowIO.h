@@ -0,0 +1,117 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // Called on a pool thread when an asynchronous load finishes. error is null on success, workflow is empty on failure.
+        //   Callbacks should return quickly, the pool thread is busy until they do. An exception thrown by a callback is dropped
+        typedef std::function<void(Workflow&& workflow, std::exception_ptr error)> LoadCallback;
+        // Called on a pool thread when an asynchronous save finishes
+        typedef std::function<void(bool isSaved)> SaveCallback;
+
+        // Threads that run the workflow loads and saves of a service. Disk access runs on the I/O threads and
+        //   parsing and serialization on the parse threads, so while a workflow is parsed the next one is already
+        //   being read, and a thread waiting for the disk never holds a parse thread.
+        class WorkflowIOPool {
+        public:
+            /**
+            * Starts the pool threads
+            *
+            * @param ioThreadCount: Threads that read and write files. Default = 4
+            * @param parseThreadCount: Threads that parse and serialize workflows. 0 uses one per hardware thread
+            */
+            explicit WorkflowIOPool(int ioThreadCount = 4, int parseThreadCount = 0);
+            // Waits for every operation already started
+            ~WorkflowIOPool();
+
+            WorkflowIOPool(const WorkflowIOPool&) = delete;
+            WorkflowIOPool& operator=(const WorkflowIOPool&) = delete;
+
+            /**
+            * Reads a wksp file on an I/O thread and parses it on a parse thread
+            *
+            * @param path: The string address of a valid file
+            * @return The future workflow. It holds the error when the file can't be opened or parsed
+            */
+            std::future<WorkspaceBuilder::Structs::Workflow> LoadWorkflowAsync(const std::string& path);
+
+            /**
+            * Reads a wksp file on an I/O thread and parses it on a parse thread
+            *
+            * @param path: The string address of a valid file
+            * @param callback: Receives the workflow or the error
+            */
+            void LoadWorkflowAsync(const std::string& path, LoadCallback callback);
+
+            /**
+            * Serializes a workflow on a parse thread and writes it on an I/O thread. The text is the same SaveWorkflow writes
+            *
+            * @param filename: The path where the file will be saved
+            * @param workflow: The workflow. It is moved into the pool, so it can be changed right after the call
+            * @return The future result telling if the file was saved or not
+            */
+            std::future<bool> SaveWorkflowAsync(const std::string& filename, WorkspaceBuilder::Structs::Workflow workflow);
+
+            /**
+            * Serializes a workflow on a parse thread and writes it on an I/O thread. The text is the same SaveWorkflow writes
+            *
+            * @param filename: The path where the file will be saved
+            * @param workflow: The workflow. It is moved into the pool, so it can be changed right after the call
+            * @param callback: Receives true if the file was saved
+            */
+            void SaveWorkflowAsync(const std::string& filename, WorkspaceBuilder::Structs::Workflow workflow, SaveCallback callback);
+
+            /**
+            * Runs GetLinesFromFile on an I/O thread
+            *
+            * @param path: The string address of a valid file
+            * @return The future lines. It holds the error when the file can't be opened
+            */
+            std::future<std::vector<std::string>> GetLinesFromFileAsync(const std::string& path);
+
+            /**
+            * Runs SaveWkspfile on an I/O thread
+            *
+            * @param filename: The path where the file will be saved
+            * @param lines: The lines to be saved. They are moved into the pool
+            * @return The future result telling if the file was saved or not
+            */
+            std::future<bool> SaveWkspfileAsync(const std::string& filename, std::vector<std::string> lines);
+
+        private:
+            // Tasks run in order of arrival by a group of threads
+            struct TaskQueue {
+                std::mutex mutex;
+                std::condition_variable condition;
+                std::deque<std::function<void()>> tasks;
+                std::vector<std::thread> threads;
+                bool isStopping = false;
+            };
+
+            void StartThreads(TaskQueue& queue, int threadCount);
+            void StopThreads(TaskQueue& queue);
+            void Push(TaskQueue& queue, std::function<void()> task);
+            // Every operation is counted from its call until its last stage finishes, so the destructor can wait for it
+            void BeginOperation();
+            void EndOperation();
+
+            // Ends an operation when the stage holding it leaves, even by an exception
+            class OperationGuard;
+
+            TaskQueue ioQueue;
+            TaskQueue parseQueue;
+            std::mutex operationMutex;
+            std::condition_variable operationCondition;
+            int runningOperations = 0;
+        };
+    }
+    #pragma endregion
+}
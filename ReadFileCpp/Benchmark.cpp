@@ -0,0 +1,305 @@
+#include "WorkspaceBuilder.h"
+#include "ArenaWorkflow.h"
+#include "IncrementalParser.h"
+#include "Metrics.h"
+#include "ParseCache.h"
+#include "WorkflowGenerator.h"
+#include "WorkflowWriter.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <new>
+
+using namespace std;
+
+#pragma region Allocation counter
+// Every allocation of the benchmark process goes through here so each measure can report allocations per line.
+// The whole replaceable family is defined so each new pairs with the free function of its own allocator
+static std::atomic<unsigned long long> allocationCount(0);
+
+static void* CountedAllocate(size_t size) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::AllocationCounter, 1);
+
+    return malloc(size == 0 ? 1 : size);
+}
+
+static void* CountedAllocateAligned(size_t size, std::align_val_t alignment) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::AllocationCounter, 1);
+
+    size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    // aligned_alloc wants a size multiple of the alignment
+    return aligned_alloc(align, size == 0 ? align : (size + align - 1) / align * align);
+#endif
+}
+
+static void FreeAligned(void* memory) noexcept {
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
+
+void* operator new(size_t size) {
+    if (void* memory = CountedAllocate(size)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    if (void* memory = CountedAllocate(size)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    if (void* memory = CountedAllocateAligned(size, alignment)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    if (void* memory = CountedAllocateAligned(size, alignment)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocateAligned(size, alignment);
+}
+
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete[](void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+void operator delete[](void* memory, size_t) noexcept { free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { free(memory); }
+
+void operator delete(void* memory, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(memory); }
+#pragma endregion
+
+
+#pragma region Measures
+// Runs work iterations times and prints its best time, throughput and allocations per line
+void Measure(const string& name, int iterations, size_t bytes, size_t lines, const function<void()>& work) {
+    double bestSeconds = 0.0;
+    unsigned long long allocations = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        unsigned long long allocationsBefore = allocationCount.load();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+        work();
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        allocations = allocationCount.load() - allocationsBefore;
+
+        if (i == 0 || seconds < bestSeconds) bestSeconds = seconds;
+    }
+
+    cout << left << setw(34) << name << right << fixed
+        << setw(10) << setprecision(3) << bestSeconds * 1000.0 << " ms"
+        << setw(10) << setprecision(1) << bytes / bestSeconds / (1024.0 * 1024.0) << " MB/s"
+        << setw(14) << setprecision(0) << lines / bestSeconds << " lines/s"
+        << setw(10) << setprecision(2) << (lines == 0 ? 0.0 : (double)allocations / lines) << " allocs/line" << endl;
+}
+#pragma endregion
+
+
+#pragma region Main function
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    int iterations = 5;
+    string inputPath = "benchmark.wksp";
+    string outputPath = "benchmark_out.wksp";
+    string tracePath;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string option = argv[i];
+        int value = atoi(argv[i + 1]);
+
+        if (option == "--glyphs") options.glyphs = value;
+        else if (option == "--connections") options.connections = value;
+        else if (option == "--array-length") options.arrayLength = value;
+        else if (option == "--annotations") options.annotations = value;
+        else if (option == "--iterations") iterations = value > 0 ? value : 1;
+        else if (option == "--input") inputPath = argv[i + 1];
+        else if (option == "--output") outputPath = argv[i + 1];
+        else if (option == "--trace") tracePath = argv[i + 1];
+        else {
+            cout << "Usage: ReadFileCppBenchmark [--glyphs N] [--connections M] [--array-length K] [--annotations A] [--iterations I] [--input path] [--output path] [--trace path]" << endl;
+            return 1;
+        }
+    }
+
+#ifndef WORKSPACE_BUILDER_METRICS
+    // Without the metrics the parsers record no trace event, the file would be empty
+    if (!tracePath.empty()) {
+        cout << "Error: --trace needs WORKSPACE_BUILDER_METRICS, build the Metrics configuration" << endl;
+        return 1;
+    }
+#endif
+
+    try {
+        string text = GenerateWorkflow(options);
+        ofstream generatedFile(inputPath, ios::out | ios::binary);
+        generatedFile << text;
+        generatedFile.close();
+
+        if (generatedFile.fail()) {
+            cout << "Error: unable to write " << inputPath << endl;
+            return 1;
+        }
+
+        vector<string> workflowLines = WorkspaceBuilder::SupportFunctions::GetLinesFromFile(inputPath);
+        WorkspaceBuilder::Structs::Workflow workflow = WorkspaceBuilder::Functions::ParseWorkflow(workflowLines);
+        vector<string> glyphLines;
+        vector<string> connectionLines;
+        size_t glyphBytes = 0;
+        size_t connectionBytes = 0;
+
+        for (const string& line : workflowLines) {
+            WorkspaceBuilder::Enums::LineType lineType = WorkspaceBuilder::SupportFunctions::ClassifyLine(line);
+
+            if (lineType == WorkspaceBuilder::Enums::LineType::GlyphLine) {
+                glyphLines.push_back(line);
+                glyphBytes += line.size() + 1;
+            }
+            else if (lineType == WorkspaceBuilder::Enums::LineType::ConnectionLine) {
+                connectionLines.push_back(line);
+                connectionBytes += line.size() + 1;
+            }
+        }
+
+        cout << "Workflow: " << workflow.blocks.size() << " glyphs, " << workflow.connections.size() << " connections, "
+            << workflow.comments.size() << " comments, " << text.size() << " bytes, " << workflowLines.size() << " lines" << endl << endl;
+
+        size_t lineCount = workflowLines.size();
+        vector<string> convertedLines = WorkspaceBuilder::Functions::ConvertWorkflowToVectorString(workflow);
+        size_t convertedBytes = 0;
+        for (const string& line : convertedLines) convertedBytes += line.size() + 1;
+        string serialized;
+
+        WorkspaceBuilder::SupportFunctions::ResetMetrics();
+        WorkspaceBuilder::SupportFunctions::SetTraceEnabled(!tracePath.empty());
+
+        Measure("GetLinesFromFile", iterations, text.size(), lineCount, [&]() {
+            vector<string> lines = WorkspaceBuilder::SupportFunctions::GetLinesFromFile(inputPath);
+        });
+        Measure("ParseBlockLine", iterations, glyphBytes, glyphLines.size(), [&]() {
+            for (const string& line : glyphLines) WorkspaceBuilder::Functions::ParseBlockLine(line);
+        });
+        Measure("ParseConnectionLine", iterations, connectionBytes, connectionLines.size(), [&]() {
+            for (size_t i = 0; i < connectionLines.size(); i++) WorkspaceBuilder::Functions::ParseConnectionLine(connectionLines[i], (int)i, workflow.blocks);
+        });
+        Measure("ParseWorkflow", iterations, text.size(), lineCount, [&]() {
+            WorkspaceBuilder::Structs::Workflow parsed = WorkspaceBuilder::Functions::ParseWorkflow(workflowLines);
+        });
+        Measure("LoadWorkflow", iterations, text.size(), lineCount, [&]() {
+            WorkspaceBuilder::Structs::Workflow parsed = WorkspaceBuilder::Functions::LoadWorkflow(inputPath);
+        });
+        // The cost LoadWorkflowCached pays on every lookup, hits included
+        Measure("Sha256Hex", iterations, text.size(), lineCount, [&]() {
+            string hash = WorkspaceBuilder::SupportFunctions::Sha256Hex(text);
+        });
+
+        // An editor changing one glyph in the middle of the file and back. With the range the cost doesn't depend on the file size
+        size_t editedLine = 0;
+        for (size_t i = 0, glyph = 0; i < workflowLines.size(); i++) {
+            if (WorkspaceBuilder::SupportFunctions::ClassifyLine(workflowLines[i]) == WorkspaceBuilder::Enums::LineType::GlyphLine && glyph++ == glyphLines.size() / 2) {
+                editedLine = i;
+                break;
+            }
+        }
+        // Only the edited line changes, the rest of the text keeps its bytes
+        size_t editedEnd = 0;
+        for (size_t i = 0; i <= editedLine; i++) editedEnd = text.find('\n', editedEnd) + 1;
+        string editedText = text;
+        editedText.insert(editedEnd - 1, " -edited 1");
+        WorkspaceBuilder::Structs::Workflow updatedWorkflow = WorkspaceBuilder::Functions::ParseWorkflowBuffer(text);
+        WorkspaceBuilder::Structs::WorkflowSourceIndex sourceIndex = WorkspaceBuilder::Functions::BuildWorkflowSourceIndex(text);
+        bool isEdited = false;
+
+        Measure("UpdateWorkflow", iterations, text.size(), lineCount, [&]() {
+            isEdited = !isEdited;
+            WorkspaceBuilder::Functions::UpdateWorkflow(updatedWorkflow, sourceIndex, isEdited ? editedText : text);
+        });
+        Measure("UpdateWorkflow with a range", iterations, workflowLines[editedLine].size() + 1, 1, [&]() {
+            isEdited = !isEdited;
+            WorkspaceBuilder::Functions::UpdateWorkflow(updatedWorkflow, sourceIndex, isEdited ? editedText : text, editedLine, 1, 1);
+        });
+        // The same edit from an editor that flushes the shift only when it reads the comments or connection ids
+        sourceIndex.isShiftDeferred = true;
+        Measure("UpdateWorkflow deferred range", iterations, workflowLines[editedLine].size() + 1, 1, [&]() {
+            isEdited = !isEdited;
+            WorkspaceBuilder::Functions::UpdateWorkflow(updatedWorkflow, sourceIndex, isEdited ? editedText : text, editedLine, 1, 1);
+        });
+        Measure("ConvertWorkflowToVectorString", iterations, convertedBytes, convertedLines.size(), [&]() {
+            vector<string> lines = WorkspaceBuilder::Functions::ConvertWorkflowToVectorString(workflow);
+        });
+        Measure("SaveWkspfile", iterations, convertedBytes, convertedLines.size(), [&]() {
+            WorkspaceBuilder::SupportFunctions::SaveWkspfile(outputPath, convertedLines);
+        });
+        Measure("SerializeWorkflow", iterations, convertedBytes, convertedLines.size(), [&]() {
+            WorkspaceBuilder::Functions::SerializeWorkflow(workflow, serialized);
+        });
+        // The arena workflow is written as it is, without a copy into a Workflow
+        WorkspaceBuilder::Structs::ArenaWorkflow arena = WorkspaceBuilder::Functions::ParseWorkflowIntoArena(text);
+        Measure("SerializeWorkflow from an arena", iterations, convertedBytes, convertedLines.size(), [&]() {
+            WorkspaceBuilder::Functions::SerializeWorkflow(arena.Workflow(), serialized);
+        });
+        Measure("SaveWorkflow", iterations, convertedBytes, convertedLines.size(), [&]() {
+            WorkspaceBuilder::Functions::SaveWorkflow(outputPath, workflow);
+        });
+
+#ifdef WORKSPACE_BUILDER_METRICS
+        // Totals of every measure above, recorded by the parsers themselves
+        WorkspaceBuilder::Structs::MetricsSnapshot metrics = WorkspaceBuilder::SupportFunctions::GetMetrics();
+
+        cout << endl;
+        for (int phase = 0; phase < WorkspaceBuilder::Enums::PhaseCount; phase++) {
+            cout << left << setw(34) << WorkspaceBuilder::SupportFunctions::GetPhaseName((WorkspaceBuilder::Enums::MetricPhase)phase) << right << fixed
+                << setw(10) << setprecision(3) << metrics.phaseTime[phase] / 1e6 << " ms"
+                << setw(12) << metrics.phaseCalls[phase] << " scopes" << endl;
+        }
+        cout << "Lines: " << metrics.counters[WorkspaceBuilder::Enums::LineCounter]
+            << ", bytes: " << metrics.counters[WorkspaceBuilder::Enums::ByteCounter]
+            << ", blocks: " << metrics.counters[WorkspaceBuilder::Enums::BlockCounter]
+            << ", connections: " << metrics.counters[WorkspaceBuilder::Enums::ConnectionCounter]
+            << ", allocations: " << metrics.counters[WorkspaceBuilder::Enums::AllocationCounter] << endl;
+#endif
+
+        if (!tracePath.empty() && !WorkspaceBuilder::SupportFunctions::WriteChromeTrace(tracePath)) {
+            cout << "Error: unable to write " << tracePath << endl;
+            return 1;
+        }
+    }
+    catch (const std::exception& e) {
+        cout << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
+#pragma endregion
@@ -0,0 +1,313 @@
+#include "BinaryWorkflow.h"
+
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        static const char BinaryMagic[4] = { 'W', 'K', 'S', 'B' };
+        // Version 2 variables can have the Array type, which version 1 readers do not know
+        static const uint32_t BinaryVersion = 2;
+        // Read back as another value when the file was written with the other byte order
+        static const uint32_t BinaryByteOrderMark = 0x01020304;
+
+        // Position of a text in the string table
+        struct BinaryString {
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        struct BinaryHeader {
+            char magic[4];
+            uint32_t version;
+            uint32_t byteOrderMark;
+            uint32_t globalVariableCount;
+            uint32_t globalVariablesOffset;
+            uint32_t blockCount;
+            uint32_t blocksOffset;
+            uint32_t blockVariableCount;
+            uint32_t blockVariablesOffset;
+            uint32_t connectionCount;
+            uint32_t connectionsOffset;
+            uint32_t commentCount;
+            uint32_t commentsOffset;
+            uint32_t stringTableSize;
+            uint32_t stringTableOffset;
+        };
+
+        struct BinaryVariable {
+            BinaryString key;
+            BinaryString value;
+            int32_t type;
+        };
+
+        struct BinaryBlock {
+            int32_t id;
+            BinaryString type;
+            BinaryString hostMachine;
+            float x;
+            float y;
+            uint32_t firstVariable;
+            uint32_t variableCount;
+        };
+
+        struct BinaryConnection {
+            int32_t id;
+            int32_t startBlock;
+            BinaryString outputStartBlock;
+            int32_t endBlock;
+            BinaryString inputEndBlock;
+        };
+
+        struct BinaryComment {
+            int32_t line;
+            BinaryString text;
+            float x;
+            float y;
+        };
+
+        // Records are copied as they are, so they must not have padding
+        static_assert(sizeof(BinaryHeader) == 60, "BinaryHeader must not have padding");
+        static_assert(sizeof(BinaryVariable) == 20, "BinaryVariable must not have padding");
+        static_assert(sizeof(BinaryBlock) == 36, "BinaryBlock must not have padding");
+        static_assert(sizeof(BinaryConnection) == 28, "BinaryConnection must not have padding");
+        static_assert(sizeof(BinaryComment) == 20, "BinaryComment must not have padding");
+
+        // Builds the string table storing each distinct text once
+        class BinaryStringTable {
+        public:
+            BinaryString Add(const std::string& text) {
+                std::unordered_map<std::string, BinaryString>::iterator found = positions.find(text);
+                if (found != positions.end()) {
+                    return found->second;
+                }
+
+                BinaryString position = { (uint32_t)table.size(), (uint32_t)text.size() };
+                table.append(text);
+                positions.emplace(text, position);
+
+                return position;
+            }
+
+            const std::string& Data() const { return table; }
+
+        private:
+            std::string table;
+            std::unordered_map<std::string, BinaryString> positions;
+        };
+
+        template <typename Record>
+        static void AppendRecords(std::string& output, const std::vector<Record>& records) {
+            output.append((const char*)records.data(), records.size() * sizeof(Record));
+        }
+
+        bool SerializeBinaryWorkflow(const WorkspaceBuilder::Structs::Workflow& workflow, std::string& output) {
+            BinaryStringTable strings;
+            std::vector<BinaryVariable> globalVariables;
+            std::vector<BinaryBlock> blocks;
+            std::vector<BinaryVariable> blockVariables;
+            std::vector<BinaryConnection> connections;
+            std::vector<BinaryComment> comments;
+
+            globalVariables.reserve(workflow.globalVariables.size());
+            for (const WorkspaceBuilder::Structs::Variable& variable : workflow.globalVariables) {
+                globalVariables.push_back({ strings.Add(variable.key), strings.Add(variable.value), (int32_t)variable.type });
+            }
+
+            blocks.reserve(workflow.blocks.size());
+            for (const WorkspaceBuilder::Structs::Block& block : workflow.blocks) {
+                blocks.push_back({ block.id, strings.Add(block.type), strings.Add(block.hostMachine), block.position.x, block.position.y, (uint32_t)blockVariables.size(), (uint32_t)block.variables.size() });
+
+                for (const WorkspaceBuilder::Structs::Variable& variable : block.variables) {
+                    blockVariables.push_back({ strings.Add(variable.key), strings.Add(variable.value), (int32_t)variable.type });
+                }
+            }
+
+            connections.reserve(workflow.connections.size());
+            for (const WorkspaceBuilder::Structs::Connection& connection : workflow.connections) {
+                connections.push_back({ connection.id, connection.startBlock, strings.Add(connection.outputStartBlock), connection.endBlock, strings.Add(connection.inputEndBlock) });
+            }
+
+            comments.reserve(workflow.comments.size());
+            for (const WorkspaceBuilder::Structs::Comment& comment : workflow.comments) {
+                comments.push_back({ comment.line, strings.Add(comment.text), comment.position.x, comment.position.y });
+            }
+
+            output.clear();
+
+            // Every count, offset and string position is stored in 4 bytes. They are all at most the file size,
+            //   so a file that fits in 4GB can't overflow any of them
+            uint64_t fileSize = sizeof(BinaryHeader)
+                + (uint64_t)globalVariables.size() * sizeof(BinaryVariable)
+                + (uint64_t)blocks.size() * sizeof(BinaryBlock)
+                + (uint64_t)blockVariables.size() * sizeof(BinaryVariable)
+                + (uint64_t)connections.size() * sizeof(BinaryConnection)
+                + (uint64_t)comments.size() * sizeof(BinaryComment)
+                + strings.Data().size();
+
+            if (fileSize > UINT32_MAX) {
+                return false;
+            }
+
+            // Sections follow the header in this order. All records have 4 byte fields so every offset stays aligned
+            BinaryHeader header;
+            memcpy(header.magic, BinaryMagic, sizeof(BinaryMagic));
+            header.version = BinaryVersion;
+            header.byteOrderMark = BinaryByteOrderMark;
+            header.globalVariableCount = (uint32_t)globalVariables.size();
+            header.globalVariablesOffset = sizeof(BinaryHeader);
+            header.blockCount = (uint32_t)blocks.size();
+            header.blocksOffset = header.globalVariablesOffset + header.globalVariableCount * sizeof(BinaryVariable);
+            header.blockVariableCount = (uint32_t)blockVariables.size();
+            header.blockVariablesOffset = header.blocksOffset + header.blockCount * sizeof(BinaryBlock);
+            header.connectionCount = (uint32_t)connections.size();
+            header.connectionsOffset = header.blockVariablesOffset + header.blockVariableCount * sizeof(BinaryVariable);
+            header.commentCount = (uint32_t)comments.size();
+            header.commentsOffset = header.connectionsOffset + header.connectionCount * sizeof(BinaryConnection);
+            header.stringTableSize = (uint32_t)strings.Data().size();
+            header.stringTableOffset = header.commentsOffset + header.commentCount * sizeof(BinaryComment);
+
+            output.reserve((size_t)fileSize);
+            output.append((const char*)&header, sizeof(header));
+            AppendRecords(output, globalVariables);
+            AppendRecords(output, blocks);
+            AppendRecords(output, blockVariables);
+            AppendRecords(output, connections);
+            AppendRecords(output, comments);
+            output.append(strings.Data());
+
+            return true;
+        }
+
+        bool SaveBinaryWorkflow(const std::string& filename, const WorkspaceBuilder::Structs::Workflow& workflow) {
+            std::string output;
+
+            if (!SerializeBinaryWorkflow(workflow, output)) {
+                return false;
+            }
+
+            std::ofstream myFile(filename, std::ios::out | std::ios::binary);
+
+            if (!myFile) {
+                return false;
+            }
+
+            myFile.write(output.data(), output.size());
+            myFile.close();
+
+            return !myFile.fail();
+        }
+
+        // Checks that count records of recordSize starting at offset are inside the file
+        static void CheckSection(size_t fileSize, uint32_t offset, uint32_t count, size_t recordSize) {
+            if (offset > fileSize || (fileSize - offset) / recordSize < count) {
+                throw std::runtime_error("LoadBinaryWorkflow error >> Not a valid file. A section is outside the file");
+            }
+        }
+
+        // Reads the records of a section. memcpy keeps the read valid whatever the mapping alignment is
+        template <typename Record, typename Convert>
+        static void ReadRecords(const char* data, uint32_t offset, uint32_t count, Convert convert) {
+            for (uint32_t i = 0; i < count; i++) {
+                Record record;
+                memcpy(&record, data + offset + (size_t)i * sizeof(Record), sizeof(Record));
+                convert(record);
+            }
+        }
+
+        WorkspaceBuilder::Structs::WorkflowView LoadBinaryWorkflowView(const std::string& path) {
+            return LoadBinaryWorkflowView(WorkspaceBuilder::SupportFunctions::MappedFile(path), 0);
+        }
+
+        WorkspaceBuilder::Structs::WorkflowView LoadBinaryWorkflowView(WorkspaceBuilder::SupportFunctions::MappedFile file, size_t offset) {
+            WorkspaceBuilder::Structs::WorkflowView view;
+            view.mappedBuffer = std::move(file);
+
+            if (offset > view.mappedBuffer.Size()) {
+                throw std::runtime_error("LoadBinaryWorkflow error >> Not a valid file. The file is too small");
+            }
+
+            const char* data = view.mappedBuffer.Data() + offset;
+            size_t size = view.mappedBuffer.Size() - offset;
+
+            BinaryHeader header;
+            if (size < sizeof(header)) {
+                throw std::runtime_error("LoadBinaryWorkflow error >> Not a valid file. The file is too small");
+            }
+            memcpy(&header, data, sizeof(header));
+
+            if (memcmp(header.magic, BinaryMagic, sizeof(BinaryMagic)) != 0 || header.byteOrderMark != BinaryByteOrderMark) {
+                throw std::runtime_error("LoadBinaryWorkflow error >> Not a valid file. Wrong magic or byte order");
+            }
+            if (header.version != BinaryVersion) {
+                throw std::runtime_error("LoadBinaryWorkflow error >> Not a valid file. Unsupported version");
+            }
+
+            CheckSection(size, header.globalVariablesOffset, header.globalVariableCount, sizeof(BinaryVariable));
+            CheckSection(size, header.blocksOffset, header.blockCount, sizeof(BinaryBlock));
+            CheckSection(size, header.blockVariablesOffset, header.blockVariableCount, sizeof(BinaryVariable));
+            CheckSection(size, header.connectionsOffset, header.connectionCount, sizeof(BinaryConnection));
+            CheckSection(size, header.commentsOffset, header.commentCount, sizeof(BinaryComment));
+            CheckSection(size, header.stringTableOffset, header.stringTableSize, 1);
+
+            const char* stringTable = data + header.stringTableOffset;
+            auto toView = [&](const BinaryString& text) {
+                if (text.offset > header.stringTableSize || header.stringTableSize - text.offset < text.length) {
+                    throw std::runtime_error("LoadBinaryWorkflow error >> Not a valid file. A text is outside the string table");
+                }
+                return std::string_view(stringTable + text.offset, text.length);
+            };
+            auto toType = [](int32_t type) {
+                if (type < WorkspaceBuilder::Enums::Integer || type > WorkspaceBuilder::Enums::Array) {
+                    throw std::runtime_error("LoadBinaryWorkflow error >> Not a valid file. Unknown variable type");
+                }
+                return (WorkspaceBuilder::Enums::VariableType)type;
+            };
+
+            view.globalVariables.reserve(header.globalVariableCount);
+            ReadRecords<BinaryVariable>(data, header.globalVariablesOffset, header.globalVariableCount, [&](const BinaryVariable& record) {
+                view.globalVariables.push_back({ toView(record.key), toView(record.value), toType(record.type) });
+            });
+
+            view.blocks.reserve(header.blockCount);
+            ReadRecords<BinaryBlock>(data, header.blocksOffset, header.blockCount, [&](const BinaryBlock& record) {
+                if (record.firstVariable > header.blockVariableCount || header.blockVariableCount - record.firstVariable < record.variableCount) {
+                    throw std::runtime_error("LoadBinaryWorkflow error >> Not a valid file. Block variables are outside the file");
+                }
+
+                view.blocks.push_back({ record.id, toView(record.type), toView(record.hostMachine), { record.x, record.y }, record.firstVariable, record.variableCount });
+            });
+
+            view.blockVariables.reserve(header.blockVariableCount);
+            ReadRecords<BinaryVariable>(data, header.blockVariablesOffset, header.blockVariableCount, [&](const BinaryVariable& record) {
+                view.blockVariables.push_back({ toView(record.key), toView(record.value), toType(record.type) });
+            });
+
+            view.connections.reserve(header.connectionCount);
+            ReadRecords<BinaryConnection>(data, header.connectionsOffset, header.connectionCount, [&](const BinaryConnection& record) {
+                view.connections.push_back({ record.id, record.startBlock, toView(record.outputStartBlock), record.endBlock, toView(record.inputEndBlock) });
+            });
+
+            view.comments.reserve(header.commentCount);
+            ReadRecords<BinaryComment>(data, header.commentsOffset, header.commentCount, [&](const BinaryComment& record) {
+                view.comments.push_back({ record.line, toView(record.text), { record.x, record.y } });
+            });
+
+            return view;
+        }
+
+        WorkspaceBuilder::Structs::Workflow LoadBinaryWorkflow(const std::string& path) {
+            return ConvertWorkflowViewToWorkflow(LoadBinaryWorkflowView(path));
+        }
+
+        bool ConvertWkspToWkspb(const std::string& textPath, const std::string& binaryPath) {
+            return SaveBinaryWorkflow(binaryPath, LoadWorkflow(textPath));
+        }
+
+        bool ConvertWkspbToWksp(const std::string& binaryPath, const std::string& textPath) {
+            return SaveWorkflow(textPath, LoadBinaryWorkflow(binaryPath)) != 0;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include "WorkflowView.h"
+
+namespace WorkspaceBuilder {
+    #pragma region Functions
+    namespace Functions {
+        /*
+        * Compiled workflow format (.wkspb). Every field has 4 bytes in the host byte order:
+        *   Header: magic 'WKSB', version, byte order mark, counts and offsets of each section
+        *   Global variables, blocks, block variables, connections and comments as fixed width records
+        *   String table with the texts. Records point to it with an offset and a length
+        * Equal texts like glyph types and host machines are stored only once.
+        */
+
+        /**
+        * Writes a workflow in the compiled binary format
+        *
+        * @param workflow: A reference to the VGL workflow struct.
+        * @param output: The buffer that receives the bytes. It is cleared first
+        * @return False when the file would pass 4GB, the limit of its 4 byte offsets. output is left empty
+        */
+        bool SerializeBinaryWorkflow(const WorkspaceBuilder::Structs::Workflow& workflow, std::string& output);
+
+        /**
+        * Saves a workflow in the compiled binary format. Existing file in this path shall be overridden.
+        *
+        * @param filename: The path where the file will be saved
+        * @param workflow: A reference to the VGL workflow struct.
+        * @return A boolean telling if the file was saved or not. It is not when the workflow passes the 4GB limit of the format
+        */
+        bool SaveBinaryWorkflow(const std::string& filename, const WorkspaceBuilder::Structs::Workflow& workflow);
+
+        /**
+        * Memory maps a compiled workflow. Only the fixed width records are read, texts point inside the mapping.
+        *
+        * @param path: The string address of a valid .wkspb file
+        * @return A workflow view that owns the file mapping
+        *
+        * @throws Unable to open file> if the given path is invalid || Not a valid file> if the file is not a compiled workflow
+        */
+        WorkspaceBuilder::Structs::WorkflowView LoadBinaryWorkflowView(const std::string& path);
+
+        /**
+        * Reads a compiled workflow stored from an offset of a mapped file, after the header of a container like a parse cache entry
+        *
+        * @param file: The file mapping. It is moved into the view
+        * @param offset: Position of the compiled workflow in the file. Its section offsets count from there
+        * @return A workflow view that owns the file mapping
+        *
+        * @throws Not a valid file> if the bytes from offset are not a compiled workflow
+        */
+        WorkspaceBuilder::Structs::WorkflowView LoadBinaryWorkflowView(WorkspaceBuilder::SupportFunctions::MappedFile file, size_t offset);
+
+        /**
+        * Loads a compiled workflow into an owning workflow structure
+        *
+        * @param path: The string address of a valid .wkspb file
+        * @return A VGL Workflow structure
+        *
+        * @throws Unable to open file> if the given path is invalid || Not a valid file> if the file is not a compiled workflow
+        */
+        WorkspaceBuilder::Structs::Workflow LoadBinaryWorkflow(const std::string& path);
+
+        /**
+        * Compiles a text workflow (.wksp) into the binary format (.wkspb)
+        *
+        * @param textPath: The .wksp file to be read
+        * @param binaryPath: The .wkspb file to be written
+        * @return A boolean telling if the file was saved or not.
+        *
+        * @throws Unable to open file> if textPath is invalid
+        */
+        bool ConvertWkspToWkspb(const std::string& textPath, const std::string& binaryPath);
+
+        /**
+        * Writes a compiled workflow (.wkspb) back as text (.wksp), in the same format as SaveWorkflow
+        *
+        * @param binaryPath: The .wkspb file to be read
+        * @param textPath: The .wksp file to be written
+        * @return A boolean telling if the file was saved or not.
+        *
+        * @throws Unable to open file> if binaryPath is invalid || Not a valid file> if the file is not a compiled workflow
+        */
+        bool ConvertWkspbToWksp(const std::string& binaryPath, const std::string& textPath);
+    }
+    #pragma endregion
+}
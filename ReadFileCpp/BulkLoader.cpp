@@ -0,0 +1,128 @@
+#include "BulkLoader.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        std::vector<std::string> ListWorkflowFiles(const std::string& directory, bool recursive) {
+            std::vector<std::string> paths;
+            std::error_code error;
+
+            auto addFile = [&](const std::filesystem::directory_entry& entry) {
+                bool isWorkflowFile = entry.path().extension() == ".wksp" || (entry.path().extension() == ".gz" && entry.path().stem().extension() == ".wksp");
+
+                if (isWorkflowFile && entry.is_regular_file(error)) {
+                    paths.push_back(entry.path().string());
+                }
+            };
+
+            if (recursive) {
+                std::filesystem::recursive_directory_iterator iterator(directory, error), end;
+                for (; !error && iterator != end; iterator.increment(error)) addFile(*iterator);
+            }
+            else {
+                std::filesystem::directory_iterator iterator(directory, error), end;
+                for (; !error && iterator != end; iterator.increment(error)) addFile(*iterator);
+            }
+
+            if (error) {
+                throw std::runtime_error("ListWorkflowFiles error >> Unable to read directory " + directory);
+            }
+
+            std::sort(paths.begin(), paths.end());
+            return paths;
+        }
+
+        WorkspaceBuilder::Structs::BulkLoadReport LoadWorkflows(const std::vector<std::string>& paths, int threadCount, bool keepWorkflows) {
+            WorkspaceBuilder::Structs::BulkLoadReport report;
+            report.files.resize(paths.size());
+
+            size_t count = threadCount > 0 ? (size_t)threadCount : (size_t)std::thread::hardware_concurrency();
+            if (count > paths.size()) count = paths.size();
+            if (count == 0) count = 1;
+
+            // Each thread takes the next file until there are none left
+            std::atomic<size_t> nextFile{ 0 };
+            auto startTime = std::chrono::steady_clock::now();
+
+            auto work = [&]() {
+                for (size_t i = nextFile++; i < paths.size(); i = nextFile++) {
+                    WorkspaceBuilder::Structs::BulkLoadResult& result = report.files[i];
+                    auto fileStart = std::chrono::steady_clock::now();
+                    result.path = paths[i];
+
+                    WorkspaceBuilder::Structs::DiagnosticParseResult parsed;
+                    // Compressed files are parsed while they are inflated
+                    if (WorkspaceBuilder::SupportFunctions::IsGzipPath(paths[i])) {
+                        std::error_code sizeError;
+                        uintmax_t fileSize = std::filesystem::file_size(paths[i], sizeError);
+
+                        result.bytes = sizeError ? 0 : (size_t)fileSize;
+                        parsed = LoadWorkflowWithDiagnostics(paths[i]);
+                    }
+                    else {
+                        WorkspaceBuilder::SupportFunctions::MappedFile file;
+
+                        if (file.Open(paths[i])) {
+                            result.bytes = file.Size();
+                            parsed = ParseWorkflowBufferWithDiagnostics(file.View());
+                        }
+                        else {
+                            parsed.diagnostics.push_back({ 0, 0, WorkspaceBuilder::Enums::ParseError::UnableToOpenFile, WorkspaceBuilder::SupportFunctions::GetParseErrorMessage(WorkspaceBuilder::Enums::ParseError::UnableToOpenFile) });
+                        }
+                    }
+
+                    result.blockCount = parsed.workflow.blocks.size();
+                    result.connectionCount = parsed.workflow.connections.size();
+                    if (keepWorkflows) result.workflow = std::move(parsed.workflow);
+                    result.diagnostics = std::move(parsed.diagnostics);
+                    result.success = result.diagnostics.empty();
+
+                    if (!result.success) {
+                        const WorkspaceBuilder::Structs::ParseDiagnostic& first = result.diagnostics.front();
+                        result.error = "Line " + std::to_string(first.line) + ", column " + std::to_string(first.column) + " >> " + first.message;
+                    }
+
+                    result.loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fileStart).count();
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(count - 1);
+            for (size_t i = 1; i < count; i++) {
+                threads.emplace_back(work);
+            }
+            work();
+
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+
+            report.totalTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+            for (const WorkspaceBuilder::Structs::BulkLoadResult& result : report.files) {
+                if (result.success) report.succeeded++;
+                else report.failed++;
+                report.totalBytes += result.bytes;
+            }
+
+            if (report.totalTime > 0) {
+                report.filesPerSecond = report.files.size() * 1000.0 / report.totalTime;
+                report.megabytesPerSecond = report.totalBytes / (1024.0 * 1024.0) * 1000.0 / report.totalTime;
+            }
+
+            return report;
+        }
+
+        WorkspaceBuilder::Structs::BulkLoadReport LoadWorkflowDirectory(const std::string& directory, int threadCount, bool keepWorkflows) {
+            return LoadWorkflows(ListWorkflowFiles(directory), threadCount, keepWorkflows);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include "ParseDiagnostics.h"
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // Result of loading one file in a bulk load
+        struct BulkLoadResult {
+            std::string path;
+            // True when the file was read and has no diagnostics
+            bool success = false;
+            // Line, column and message of the first problem. Empty when success is true
+            std::string error;
+            // Every problem found. The lines with problems are left out of the workflow
+            std::vector<ParseDiagnostic> diagnostics;
+            // Only filled when the workflows are kept
+            Workflow workflow;
+            // Size of the file, compressed for a .wksp.gz file
+            size_t bytes = 0;
+            size_t blockCount = 0;
+            size_t connectionCount = 0;
+            // Time to read and parse the file in milliseconds
+            double loadTime = 0;
+        };
+
+        // Result of a bulk load
+        struct BulkLoadReport {
+            // One result for each path, in the order of the paths
+            std::vector<BulkLoadResult> files;
+            size_t succeeded = 0;
+            size_t failed = 0;
+            size_t totalBytes = 0;
+            // Wall time of the whole load in milliseconds
+            double totalTime = 0;
+            double filesPerSecond = 0;
+            double megabytesPerSecond = 0;
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Finds the .wksp and .wksp.gz files of a directory
+        *
+        * @param directory: The directory to be searched
+        * @param recursive: If true the subdirectories are searched too. Default = true
+        * @return The file paths sorted by name
+        *
+        * @throws Unable to read directory> if the directory can't be listed
+        */
+        std::vector<std::string> ListWorkflowFiles(const std::string& directory, bool recursive = true);
+
+        /**
+        * Loads many wksp files on a bounded pool of threads. Each thread maps and parses one file at a time, so the
+        *   reads of some threads overlap the parsing of the others. Files are parsed without exceptions, every
+        *   problem is reported as a diagnostic and only fails its own file.
+        *
+        * @param paths: The files to be loaded
+        * @param threadCount: Number of pool threads. 0 uses the number of hardware threads. Default = 0
+        * @param keepWorkflows: If false only the counts of each workflow are kept, so memory doesn't grow with the file count. Default = false
+        * @return The result of each file and the aggregate throughput
+        */
+        WorkspaceBuilder::Structs::BulkLoadReport LoadWorkflows(const std::vector<std::string>& paths, int threadCount = 0, bool keepWorkflows = false);
+
+        /**
+        * Loads every wksp file of a directory and its subdirectories on a bounded pool of threads
+        *
+        * @param directory: The directory to be loaded
+        * @param threadCount: Number of pool threads. 0 uses the number of hardware threads. Default = 0
+        * @param keepWorkflows: If false only the counts of each workflow are kept. Default = false
+        * @return The result of each file and the aggregate throughput
+        *
+        * @throws Unable to read directory> if the directory can't be listed
+        */
+        WorkspaceBuilder::Structs::BulkLoadReport LoadWorkflowDirectory(const std::string& directory, int threadCount = 0, bool keepWorkflows = false);
+    }
+    #pragma endregion
+}
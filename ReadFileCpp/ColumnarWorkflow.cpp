@@ -0,0 +1,148 @@
+#include "ColumnarWorkflow.h"
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        WorkspaceBuilder::Structs::ColumnarWorkflow ConvertWorkflowToColumnar(const WorkspaceBuilder::Structs::Workflow& workflow) {
+            WorkspaceBuilder::Structs::ColumnarWorkflow columnar;
+            size_t blockCount = workflow.blocks.size();
+            size_t variableCount = 0;
+            size_t inputCount = 0;
+            size_t outputCount = 0;
+
+            // Types, host machines and connection ports
+            columnar.symbols = InternWorkflow(workflow);
+
+            // Pool sizes first so every column is allocated once
+            for (const WorkspaceBuilder::Structs::Block& block : workflow.blocks) {
+                variableCount += block.variables.size();
+                inputCount += block.inputs.size();
+                outputCount += block.outputs.size();
+            }
+
+            columnar.blockIds.reserve(blockCount);
+            columnar.blockX.reserve(blockCount);
+            columnar.blockY.reserve(blockCount);
+            columnar.variableOffsets.reserve(blockCount + 1);
+            columnar.inputOffsets.reserve(blockCount + 1);
+            columnar.outputOffsets.reserve(blockCount + 1);
+            columnar.variables.reserve(variableCount);
+            columnar.inputNames.reserve(inputCount);
+            columnar.inputTypes.reserve(inputCount);
+            columnar.outputNames.reserve(outputCount);
+            columnar.outputTypes.reserve(outputCount);
+
+            for (const WorkspaceBuilder::Structs::Block& block : workflow.blocks) {
+                columnar.blockIds.push_back(block.id);
+                columnar.blockX.push_back(block.position.x);
+                columnar.blockY.push_back(block.position.y);
+
+                columnar.variableOffsets.push_back((uint32_t)columnar.variables.size());
+                columnar.variables.insert(columnar.variables.end(), block.variables.begin(), block.variables.end());
+
+                columnar.inputOffsets.push_back((uint32_t)columnar.inputNames.size());
+                for (const WorkspaceBuilder::Structs::Input& input : block.inputs) {
+                    columnar.inputNames.push_back(columnar.symbols.table.Intern(input.name));
+                    columnar.inputTypes.push_back(input.type);
+                }
+
+                columnar.outputOffsets.push_back((uint32_t)columnar.outputNames.size());
+                for (const WorkspaceBuilder::Structs::Output& output : block.outputs) {
+                    columnar.outputNames.push_back(columnar.symbols.table.Intern(output.name));
+                    columnar.outputTypes.push_back(output.type);
+                }
+            }
+
+            columnar.variableOffsets.push_back((uint32_t)columnar.variables.size());
+            columnar.inputOffsets.push_back((uint32_t)columnar.inputNames.size());
+            columnar.outputOffsets.push_back((uint32_t)columnar.outputNames.size());
+
+            columnar.connectionIds.reserve(workflow.connections.size());
+            columnar.connectionStartBlocks.reserve(workflow.connections.size());
+            columnar.connectionEndBlocks.reserve(workflow.connections.size());
+            for (const WorkspaceBuilder::Structs::Connection& connection : workflow.connections) {
+                columnar.connectionIds.push_back(connection.id);
+                columnar.connectionStartBlocks.push_back(connection.startBlock);
+                columnar.connectionEndBlocks.push_back(connection.endBlock);
+            }
+
+            columnar.globalVariables = workflow.globalVariables;
+            columnar.comments = workflow.comments;
+
+            return columnar;
+        }
+
+        WorkspaceBuilder::Structs::Workflow ConvertColumnarToWorkflow(const WorkspaceBuilder::Structs::ColumnarWorkflow& columnar) {
+            WorkspaceBuilder::Structs::Workflow workflow;
+            const WorkspaceBuilder::Structs::SymbolTable& table = columnar.symbols.table;
+
+            workflow.blocks.resize(columnar.BlockCount());
+            for (size_t i = 0; i < columnar.BlockCount(); i++) {
+                WorkspaceBuilder::Structs::Block& block = workflow.blocks[i];
+
+                block.id = columnar.blockIds[i];
+                block.type = table.Name(columnar.symbols.blockTypes[i]);
+                block.hostMachine = table.Name(columnar.symbols.blockHostMachines[i]);
+                block.position = { columnar.blockX[i], columnar.blockY[i] };
+
+                block.variables.assign(columnar.variables.begin() + columnar.variableOffsets[i], columnar.variables.begin() + columnar.variableOffsets[i + 1]);
+
+                block.inputs.reserve(columnar.inputOffsets[i + 1] - columnar.inputOffsets[i]);
+                for (uint32_t input = columnar.inputOffsets[i]; input < columnar.inputOffsets[i + 1]; input++) {
+                    block.inputs.push_back({ std::string(table.Name(columnar.inputNames[input])), columnar.inputTypes[input] });
+                }
+
+                block.outputs.reserve(columnar.outputOffsets[i + 1] - columnar.outputOffsets[i]);
+                for (uint32_t output = columnar.outputOffsets[i]; output < columnar.outputOffsets[i + 1]; output++) {
+                    block.outputs.push_back({ std::string(table.Name(columnar.outputNames[output])), columnar.outputTypes[output] });
+                }
+            }
+
+            workflow.connections.reserve(columnar.ConnectionCount());
+            for (size_t i = 0; i < columnar.ConnectionCount(); i++) {
+                workflow.connections.push_back({
+                    columnar.connectionIds[i],
+                    columnar.connectionStartBlocks[i],
+                    std::string(table.Name(columnar.symbols.connectionOutputs[i])),
+                    columnar.connectionEndBlocks[i],
+                    std::string(table.Name(columnar.symbols.connectionInputs[i]))
+                });
+            }
+
+            workflow.globalVariables = columnar.globalVariables;
+            workflow.comments = columnar.comments;
+
+            return workflow;
+        }
+
+        std::vector<int> FindBlocksOfType(const WorkspaceBuilder::Structs::ColumnarWorkflow& columnar, std::string_view type) {
+            std::vector<int> blocks;
+            WorkspaceBuilder::Structs::SymbolId symbol = columnar.symbols.table.Find(type);
+
+            if (symbol == WorkspaceBuilder::Structs::SymbolTable::InvalidSymbol) {
+                return blocks;
+            }
+
+            const std::vector<WorkspaceBuilder::Structs::SymbolId>& types = columnar.symbols.blockTypes;
+            for (size_t i = 0; i < types.size(); i++) {
+                if (types[i] == symbol) blocks.push_back((int)i);
+            }
+
+            return blocks;
+        }
+
+        std::vector<int> FindBlocksInRectangle(const WorkspaceBuilder::Structs::ColumnarWorkflow& columnar, WorkspaceBuilder::Structs::Vector2 minimum, WorkspaceBuilder::Structs::Vector2 maximum) {
+            std::vector<int> blocks;
+            const float* x = columnar.blockX.data();
+            const float* y = columnar.blockY.data();
+
+            // The four tests are combined without short circuit to keep a single branch per block
+            for (size_t i = 0; i < columnar.BlockCount(); i++) {
+                bool isInside = (x[i] >= minimum.x) & (x[i] <= maximum.x) & (y[i] >= minimum.y) & (y[i] <= maximum.y);
+                if (isInside) blocks.push_back((int)i);
+            }
+
+            return blocks;
+        }
+    }
+}
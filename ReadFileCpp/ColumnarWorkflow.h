@@ -0,0 +1,90 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include "SymbolTable.h"
+#include <cstdint>
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // Workflow stored by columns. Each block field is a contiguous array indexed by the block position,
+        //   so a scan over ids, types or positions only touches the memory of that field.
+        //   The variables, inputs and outputs of every block share one pool per kind.
+        struct ColumnarWorkflow {
+            // Symbol table with the block types and host machines and the connection, input and output names.
+            //   Its blockTypes, blockHostMachines, connectionOutputs and connectionInputs are columns of this workflow
+            WorkflowSymbols symbols;
+
+            // Block::id of every block
+            std::vector<int> blockIds;
+            // Block::position of every block
+            std::vector<float> blockX;
+            std::vector<float> blockY;
+
+            // Variables of block b are variables[variableOffsets[b]] until variables[variableOffsets[b + 1]]
+            std::vector<uint32_t> variableOffsets;
+            std::vector<Variable> variables;
+            // Inputs of block b are in the input pool from inputOffsets[b] until inputOffsets[b + 1]
+            std::vector<uint32_t> inputOffsets;
+            std::vector<SymbolId> inputNames;
+            std::vector<WorkspaceBuilder::Enums::VariableType> inputTypes;
+            // Outputs of block b are in the output pool from outputOffsets[b] until outputOffsets[b + 1]
+            std::vector<uint32_t> outputOffsets;
+            std::vector<SymbolId> outputNames;
+            std::vector<WorkspaceBuilder::Enums::VariableType> outputTypes;
+
+            // Connection::id, Connection::startBlock and Connection::endBlock of every connection
+            std::vector<int> connectionIds;
+            std::vector<int> connectionStartBlocks;
+            std::vector<int> connectionEndBlocks;
+
+            // Global variables and comments are small and kept as they are
+            std::vector<Variable> globalVariables;
+            std::vector<Comment> comments;
+
+            // Number of blocks
+            size_t BlockCount() const { return blockIds.size(); }
+            // Number of connections
+            size_t ConnectionCount() const { return connectionIds.size(); }
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Converts a workflow into columns
+        *
+        * @param workflow: The workflow
+        * @return The columnar workflow with the blocks and connections in the same order
+        */
+        WorkspaceBuilder::Structs::ColumnarWorkflow ConvertWorkflowToColumnar(const WorkspaceBuilder::Structs::Workflow& workflow);
+
+        /**
+        * Converts a columnar workflow back into a workflow
+        *
+        * @param columnar: The columnar workflow
+        * @return A workflow equal to the one the columns were built from
+        */
+        WorkspaceBuilder::Structs::Workflow ConvertColumnarToWorkflow(const WorkspaceBuilder::Structs::ColumnarWorkflow& columnar);
+
+        /**
+        * Finds the blocks of a glyph type scanning only the type column
+        *
+        * @param columnar: The columnar workflow
+        * @param type: The Block::type to be found
+        * @return The block positions in file order
+        */
+        std::vector<int> FindBlocksOfType(const WorkspaceBuilder::Structs::ColumnarWorkflow& columnar, std::string_view type);
+
+        /**
+        * Finds the blocks whose position is inside a rectangle scanning only the position columns
+        *
+        * @param columnar: The columnar workflow
+        * @param minimum: The smallest corner of the rectangle
+        * @param maximum: The largest corner of the rectangle
+        * @return The block positions in file order
+        */
+        std::vector<int> FindBlocksInRectangle(const WorkspaceBuilder::Structs::ColumnarWorkflow& columnar, WorkspaceBuilder::Structs::Vector2 minimum, WorkspaceBuilder::Structs::Vector2 maximum);
+    }
+    #pragma endregion
+}
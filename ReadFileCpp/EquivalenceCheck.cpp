@@ -0,0 +1,737 @@
+#include "WorkspaceBuilder.h"
+#include "ArenaWorkflow.h"
+#include "AsyncWorkflowIO.h"
+#include "BinaryWorkflow.h"
+#include "BulkLoader.h"
+#include "ColumnarWorkflow.h"
+#include "IncrementalParser.h"
+#include "ParallelParser.h"
+#include "ParseCache.h"
+#include "ParseDiagnostics.h"
+#include "TypedParameters.h"
+#include "WorkflowDiff.h"
+#include "WorkflowGenerator.h"
+#include "WorkflowGraph.h"
+#include "WorkflowJournal.h"
+#include "WorkflowReader.h"
+#include "WorkflowView.h"
+#include "WorkflowWriter.h"
+
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+
+using namespace std;
+
+#pragma region Equivalence check
+// Workflow returned by a parser, or the message of the exception it threw
+struct ParseOutcome {
+    bool isThrown = false;
+    string error;
+    WorkspaceBuilder::Structs::Workflow workflow;
+};
+
+ParseOutcome RunParser(const function<WorkspaceBuilder::Structs::Workflow()>& parse) {
+    ParseOutcome outcome;
+
+    try {
+        outcome.workflow = parse();
+    }
+    catch (const std::exception& e) {
+        outcome.isThrown = true;
+        outcome.error = e.what();
+    }
+
+    return outcome;
+}
+
+// A 'nan' value decodes to a NaN, which is not equal to itself
+bool IsSameNumber(double a, double b) {
+    return a == b || (isnan(a) && isnan(b));
+}
+
+bool IsSameParameter(const WorkspaceBuilder::Structs::ParameterValue& a, const WorkspaceBuilder::Structs::ParameterValue& b) {
+    return a.type == b.type && a.integerValue == b.integerValue && IsSameNumber(a.doubleValue, b.doubleValue)
+        && equal(a.doubleArray.begin(), a.doubleArray.end(), b.doubleArray.begin(), b.doubleArray.end(), IsSameNumber);
+}
+
+bool IsSameVariables(const vector<WorkspaceBuilder::Structs::Variable>& a, const vector<WorkspaceBuilder::Structs::Variable>& b) {
+    return equal(a.begin(), a.end(), b.begin(), b.end(), [](const WorkspaceBuilder::Structs::Variable& first, const WorkspaceBuilder::Structs::Variable& second) {
+        return first.key == second.key && first.value == second.value && first.type == second.type && IsSameParameter(first.parameter, second.parameter);
+    });
+}
+
+// Decodes a value one character at a time, without the SSE2 search of ParseNumberArray. Numbers go through from_chars
+//   like ParseParameterValue, so the doubles are expected to be bit equal
+WorkspaceBuilder::Structs::ParameterValue DecodeParameterByHand(string_view text, WorkspaceBuilder::Enums::VariableType type) {
+    WorkspaceBuilder::Structs::ParameterValue parameter;
+    auto isWholeNumber = [](string_view number, auto& value) {
+        from_chars_result result = from_chars(number.data(), number.data() + number.size(), value);
+        return !number.empty() && result.ec == errc() && result.ptr == number.data() + number.size();
+    };
+
+    if (type == WorkspaceBuilder::Enums::VariableType::String || text.empty()) {
+        return parameter;
+    }
+
+    if (text[0] != '[') {
+        if (isWholeNumber(text, parameter.integerValue)) {
+            parameter.type = WorkspaceBuilder::Enums::ParameterType::IntegerParameter;
+        }
+        else if (isWholeNumber(text, parameter.doubleValue)) {
+            parameter.integerValue = 0;
+            parameter.type = WorkspaceBuilder::Enums::ParameterType::DoubleParameter;
+        }
+        else {
+            parameter.integerValue = 0;
+            parameter.doubleValue = 0.0;
+        }
+        return parameter;
+    }
+
+    // Numbers are the comma separated items without their spaces and tabs, '[ ]' is an empty list
+    if (text.size() < 2 || text.back() != ']') {
+        return parameter;
+    }
+    string_view items = text.substr(1, text.size() - 2);
+    if (items.find_first_not_of(" \t") == string_view::npos) {
+        parameter.type = WorkspaceBuilder::Enums::ParameterType::NumberArrayParameter;
+        return parameter;
+    }
+
+    size_t start = 0;
+    while (start <= items.size()) {
+        size_t end = min(items.find(',', start), items.size());
+        string_view item = items.substr(start, end - start);
+        size_t first = item.find_first_not_of(" \t");
+        item = first == string_view::npos ? string_view() : item.substr(first, item.find_last_not_of(" \t") + 1 - first);
+
+        double value = 0;
+        if (!isWholeNumber(item, value)) {
+            parameter.doubleArray.clear();
+            return parameter;
+        }
+        parameter.doubleArray.push_back(value);
+        start = end + 1;
+    }
+
+    parameter.type = WorkspaceBuilder::Enums::ParameterType::NumberArrayParameter;
+    return parameter;
+}
+
+// Describes the first variable whose decoded value differs from DecodeParameterByHand. Empty when every value is equal
+string FindParameterDifference(const WorkspaceBuilder::Structs::Workflow& workflow) {
+    auto findVariable = [](const vector<WorkspaceBuilder::Structs::Variable>& variables) -> const WorkspaceBuilder::Structs::Variable* {
+        for (const WorkspaceBuilder::Structs::Variable& variable : variables) {
+            if (!IsSameParameter(variable.parameter, DecodeParameterByHand(variable.value, variable.type))) return &variable;
+        }
+        return nullptr;
+    };
+
+    const WorkspaceBuilder::Structs::Variable* variable = findVariable(workflow.globalVariables);
+    for (size_t i = 0; variable == nullptr && i < workflow.blocks.size(); i++) {
+        variable = findVariable(workflow.blocks[i].variables);
+    }
+
+    return variable == nullptr ? string() : "the value of '" + variable->key + "' is not decoded from '" + variable->value + "'";
+}
+
+template <typename Port>
+bool IsSamePorts(const vector<Port>& a, const vector<Port>& b) {
+    return equal(a.begin(), a.end(), b.begin(), b.end(), [](const Port& first, const Port& second) {
+        return first.name == second.name && first.type == second.type;
+    });
+}
+
+// Describes the first field that differs between two workflows. Empty when every field is equal
+string FindWorkflowDifference(const WorkspaceBuilder::Structs::Workflow& expected, const WorkspaceBuilder::Structs::Workflow& actual) {
+    ostringstream difference;
+
+    if (!IsSameVariables(expected.globalVariables, actual.globalVariables)) {
+        difference << "global variables differ (" << expected.globalVariables.size() << " expected, " << actual.globalVariables.size() << " found)";
+        return difference.str();
+    }
+
+    if (expected.blocks.size() != actual.blocks.size()) {
+        difference << expected.blocks.size() << " blocks expected, " << actual.blocks.size() << " found";
+        return difference.str();
+    }
+    for (size_t i = 0; i < expected.blocks.size(); i++) {
+        const WorkspaceBuilder::Structs::Block& a = expected.blocks[i];
+        const WorkspaceBuilder::Structs::Block& b = actual.blocks[i];
+
+        if (a.id != b.id || a.type != b.type || a.hostMachine != b.hostMachine || a.position.x != b.position.x || a.position.y != b.position.y
+            || !IsSameVariables(a.variables, b.variables) || !IsSamePorts(a.inputs, b.inputs) || !IsSamePorts(a.outputs, b.outputs)) {
+            difference << "block " << i << " differs (id " << a.id << " expected, " << b.id << " found)";
+            return difference.str();
+        }
+    }
+
+    if (expected.connections.size() != actual.connections.size()) {
+        difference << expected.connections.size() << " connections expected, " << actual.connections.size() << " found";
+        return difference.str();
+    }
+    for (size_t i = 0; i < expected.connections.size(); i++) {
+        const WorkspaceBuilder::Structs::Connection& a = expected.connections[i];
+        const WorkspaceBuilder::Structs::Connection& b = actual.connections[i];
+
+        if (a.id != b.id || a.startBlock != b.startBlock || a.outputStartBlock != b.outputStartBlock || a.endBlock != b.endBlock || a.inputEndBlock != b.inputEndBlock) {
+            difference << "connection " << i << " differs (id " << a.id << " expected, " << b.id << " found)";
+            return difference.str();
+        }
+    }
+
+    if (expected.comments.size() != actual.comments.size()) {
+        difference << expected.comments.size() << " comments expected, " << actual.comments.size() << " found";
+        return difference.str();
+    }
+    for (size_t i = 0; i < expected.comments.size(); i++) {
+        const WorkspaceBuilder::Structs::Comment& a = expected.comments[i];
+        const WorkspaceBuilder::Structs::Comment& b = actual.comments[i];
+
+        if (a.line != b.line || a.text != b.text || a.position.x != b.position.x || a.position.y != b.position.y) {
+            difference << "comment " << i << " differs (line " << a.line << " expected, " << b.line << " found)";
+            return difference.str();
+        }
+    }
+
+    return difference.str();
+}
+
+// isErrorCompared is false to only check that both threw
+string FindOutcomeDifference(const ParseOutcome& expected, const ParseOutcome& actual, bool isErrorCompared = true) {
+    if (expected.isThrown != actual.isThrown || (isErrorCompared && expected.error != actual.error)) {
+        return (expected.isThrown ? "exception '" + expected.error + "'" : string("a workflow")) + " expected, "
+            + (actual.isThrown ? "exception '" + actual.error + "'" : string("a workflow")) + " found";
+    }
+
+    return expected.isThrown ? string() : FindWorkflowDifference(expected.workflow, actual.workflow);
+}
+
+// Counts the compared results and prints the first failures
+struct EquivalenceCheck {
+    size_t comparisons = 0;
+    size_t failures = 0;
+    // Fuzzed inputs ParseWorkflow threw for, their error paths were compared too
+    size_t rejectedInputs = 0;
+
+    void Expect(const string& name, const string& difference, const string& input = string()) {
+        comparisons++;
+
+        if (difference.empty()) {
+            return;
+        }
+
+        // A broken parser fails on most fuzzed inputs, the first ones are enough to find it
+        if (++failures <= 20) {
+            cout << "FAILED " << name << ": " << difference << endl;
+            if (!input.empty()) {
+                cout << "  input:" << endl << input << endl;
+            }
+        }
+    }
+
+    void Expect(const string& name, const ParseOutcome& expected, const ParseOutcome& actual, const string& input = string(), bool isErrorCompared = true) {
+        Expect(name, FindOutcomeDifference(expected, actual, isErrorCompared), input);
+    }
+};
+
+vector<string> SplitLines(string_view text) {
+    vector<string> lines;
+    size_t offset = 0;
+
+    while (offset < text.size()) {
+        lines.emplace_back(WorkspaceBuilder::SupportFunctions::NextLine(text, offset));
+    }
+
+    return lines;
+}
+
+// Builds an owning workflow from the ReadWorkflow callbacks, with the port names lowered like ParseConnectionLine
+WorkspaceBuilder::Structs::WorkflowReaderCallbacks CollectWorkflow(WorkspaceBuilder::Structs::Workflow& workflow) {
+    WorkspaceBuilder::Structs::WorkflowReaderCallbacks callbacks;
+
+    callbacks.onGlyph = [&workflow](const WorkspaceBuilder::Structs::BlockView& view, const vector<WorkspaceBuilder::Structs::VariableView>& variables) {
+        WorkspaceBuilder::Structs::Block block = { view.id, string(view.type), string(view.hostMachine), view.position, {}, {}, {} };
+        for (const WorkspaceBuilder::Structs::VariableView& variable : variables) {
+            block.variables.push_back(WorkspaceBuilder::Functions::ConvertVariableViewToVariable(variable));
+        }
+        workflow.blocks.push_back(move(block));
+    };
+    callbacks.onConnection = [&workflow](const WorkspaceBuilder::Structs::ConnectionView& view) {
+        WorkspaceBuilder::Structs::Connection connection = { view.id, view.startBlock, string(view.outputStartBlock), view.endBlock, string(view.inputEndBlock) };
+        WorkspaceBuilder::SupportFunctions::ToLower(connection.outputStartBlock);
+        WorkspaceBuilder::SupportFunctions::ToLower(connection.inputEndBlock);
+        workflow.connections.push_back(move(connection));
+    };
+    callbacks.onVariable = [&workflow](const WorkspaceBuilder::Structs::VariableView& variable) {
+        workflow.globalVariables.push_back(WorkspaceBuilder::Functions::ConvertVariableViewToVariable(variable));
+    };
+    callbacks.onComment = [&workflow](const WorkspaceBuilder::Structs::CommentView& comment) {
+        workflow.comments.push_back({ comment.line, string(comment.text), comment.position });
+    };
+
+    return callbacks;
+}
+
+// Parses a text with every parser that takes a buffer and compares them with ParseWorkflow over its lines
+void CheckBufferParsers(EquivalenceCheck& check, const string& text) {
+    vector<string> lines = SplitLines(text);
+    ParseOutcome expected = RunParser([&]() { return WorkspaceBuilder::Functions::ParseWorkflow(lines); });
+    if (expected.isThrown) check.rejectedInputs++;
+    else check.Expect("ParseParameterValue", FindParameterDifference(expected.workflow), text);
+
+    // ParseWorkflow scans the blocks, connections, comments and global variables one after the other, so with two broken
+    //   lines its exception can be another one. The single pass parsers throw for the first broken line, like ParseWorkflowBuffer
+    ParseOutcome singlePass = RunParser([&]() { return WorkspaceBuilder::Functions::ParseWorkflowBuffer(text); });
+    check.Expect("ParseWorkflowBuffer", expected, singlePass, text, false);
+
+    check.Expect("ParseWorkflowView", singlePass, RunParser([&]() {
+        return WorkspaceBuilder::Functions::ConvertWorkflowViewToWorkflow(WorkspaceBuilder::Functions::ParseWorkflowView(text));
+    }), text);
+    check.Expect("ParseWorkflowIntoArena", singlePass, RunParser([&]() {
+        return WorkspaceBuilder::Functions::ConvertPmrWorkflowToWorkflow(WorkspaceBuilder::Functions::ParseWorkflowIntoArena(text).Workflow());
+    }), text);
+    check.Expect("ParseWorkflowBufferParallel", expected, RunParser([&]() {
+        return WorkspaceBuilder::Functions::ParseWorkflowBufferParallel(text, 3);
+    }), text);
+    check.Expect("ReadWorkflow", singlePass, RunParser([&]() {
+        WorkspaceBuilder::Structs::Workflow workflow;
+        istringstream stream(text);
+        // A small chunk so lines cross chunk limits
+        WorkspaceBuilder::Functions::ReadWorkflow(stream, CollectWorkflow(workflow), 61);
+        return workflow;
+    }), text);
+
+    // The diagnostics parse reports a missing field the other parsers read as 0, and reports the lines they throw for
+    WorkspaceBuilder::Structs::DiagnosticParseResult diagnosed = WorkspaceBuilder::Functions::ParseWorkflowBufferWithDiagnostics(text);
+    bool isOnlyMissingFields = all_of(diagnosed.diagnostics.begin(), diagnosed.diagnostics.end(), [](const WorkspaceBuilder::Structs::ParseDiagnostic& diagnostic) {
+        return diagnostic.code == WorkspaceBuilder::Enums::ParseError::MissingField;
+    });
+    if (expected.isThrown) {
+        check.Expect("ParseWorkflowBufferWithDiagnostics", diagnosed.diagnostics.empty() ? "no diagnostic for '" + expected.error + "'" : string(), text);
+    }
+    else if (diagnosed.diagnostics.empty()) {
+        check.Expect("ParseWorkflowBufferWithDiagnostics", FindWorkflowDifference(expected.workflow, diagnosed.workflow), text);
+    }
+    else {
+        check.Expect("ParseWorkflowBufferWithDiagnostics", isOnlyMissingFields ? string() : "diagnostic '" + diagnosed.diagnostics[0].message + "' for a valid workflow", text);
+    }
+}
+
+// Describes the first line whose hash, type or state differs between two source indexes. Empty when they are equal
+string FindSourceIndexDifference(const WorkspaceBuilder::Structs::WorkflowSourceIndex& expected, const WorkspaceBuilder::Structs::WorkflowSourceIndex& actual) {
+    if (expected.lineStates.size() != actual.lineStates.size() || expected.lineHashes != actual.lineHashes) {
+        return "the lines differ from BuildWorkflowSourceIndex";
+    }
+
+    for (size_t i = 0; i < expected.lineStates.size(); i++) {
+        const WorkspaceBuilder::Structs::SourceLineState& a = expected.lineStates[i];
+        const WorkspaceBuilder::Structs::SourceLineState& b = actual.lineStates[i];
+        bool isSameClass = i == expected.lineClasses.size()
+            || (expected.lineClasses[i].type == actual.lineClasses[i].type && expected.lineClasses[i].isGlobalVariable == actual.lineClasses[i].isGlobalVariable);
+
+        if (!isSameClass || a.start != b.start || a.globalVariables != b.globalVariables || a.blocks != b.blocks || a.connections != b.connections
+            || a.comments != b.comments || a.isVariableParserUp != b.isVariableParserUp || a.isVariableSectionDone != b.isVariableSectionDone) {
+            return "the state of line " + to_string(i) + " differs from BuildWorkflowSourceIndex";
+        }
+    }
+
+    return string();
+}
+
+// Updates the workflow of the first text to each of the next ones with both UpdateWorkflow overloads. With the deferred
+//   shift it is flushed only on a copy, so the shift of each edit is merged with the next one. Each step is compared with ParseWorkflowBuffer
+void CheckIncrementalUpdates(EquivalenceCheck& check, const vector<string>& texts) {
+    for (int mode = 0; mode < 4; mode++) {
+        bool isRangeGiven = mode % 2 == 1;
+        bool isShiftDeferred = mode >= 2;
+        const char* names[] = { "UpdateWorkflow", "UpdateWorkflow with a range", "UpdateWorkflow deferred", "UpdateWorkflow deferred with a range" };
+        WorkspaceBuilder::Structs::Workflow workflow = WorkspaceBuilder::Functions::ParseWorkflowBuffer(texts[0]);
+        WorkspaceBuilder::Structs::WorkflowSourceIndex index = WorkspaceBuilder::Functions::BuildWorkflowSourceIndex(texts[0]);
+        index.isShiftDeferred = isShiftDeferred;
+
+        for (size_t step = 1; step < texts.size(); step++) {
+            const string& text = texts[step];
+            vector<string> previousLines = SplitLines(texts[step - 1]);
+            vector<string> lines = SplitLines(text);
+
+            // The range an editor would give: the lines that differ from the previous text
+            size_t prefix = 0;
+            while (prefix < previousLines.size() && prefix < lines.size() && previousLines[prefix] == lines[prefix]) prefix++;
+            size_t suffix = 0;
+            while (suffix < previousLines.size() - prefix && suffix < lines.size() - prefix && previousLines[previousLines.size() - 1 - suffix] == lines[lines.size() - 1 - suffix]) suffix++;
+
+            ParseOutcome expected = RunParser([&]() { return WorkspaceBuilder::Functions::ParseWorkflowBuffer(text); });
+            ParseOutcome updated = RunParser([&]() {
+                if (isRangeGiven) {
+                    WorkspaceBuilder::Functions::UpdateWorkflow(workflow, index, text, prefix, previousLines.size() - prefix - suffix, lines.size() - prefix - suffix);
+                }
+                else {
+                    WorkspaceBuilder::Functions::UpdateWorkflow(workflow, index, text);
+                }
+
+                WorkspaceBuilder::Structs::Workflow flushed = workflow;
+                WorkspaceBuilder::Structs::WorkflowSourceIndex flushedIndex = index;
+                if (isShiftDeferred) {
+                    WorkspaceBuilder::Functions::FlushWorkflowUpdates(flushed, flushedIndex);
+                }
+                else if (!index.pendingShift.IsEmpty()) {
+                    throw runtime_error("a shift is pending without isShiftDeferred");
+                }
+
+                string difference = FindSourceIndexDifference(WorkspaceBuilder::Functions::BuildWorkflowSourceIndex(text), flushedIndex);
+                if (!difference.empty()) throw runtime_error(difference);
+                return flushed;
+            });
+
+            check.Expect(names[mode], expected, updated, text);
+
+            // A failed update leaves the workflow half patched
+            if (updated.isThrown) break;
+        }
+    }
+}
+
+// Changes a few lines of a wksp text: characters, whole lines and the markers of the variables section
+string FuzzWorkflow(const string& text, mt19937& random) {
+    static const char characters[] = ":- '[],.=#0123456789aZ\t";
+    static const char* insertedLines[] = { "", "#", "VariablesBegin:", "VariablesEnd:", "Glyph:VGL_CL:", "NodeConnection:", "x = 1", "Glyph:VGL_CL:f:h:1:2:3: -k" };
+    vector<string> lines = SplitLines(text);
+    int mutations = 1 + (int)(random() % 3);
+
+    for (int i = 0; i < mutations && !lines.empty(); i++) {
+        string& line = lines[random() % lines.size()];
+        size_t position = line.empty() ? 0 : random() % (line.size() + 1);
+
+        switch (random() % 7) {
+        case 0: if (position < line.size()) line.erase(position, 1); break;
+        case 1: line.insert(position, 1, characters[random() % (sizeof(characters) - 1)]); break;
+        case 2: if (position < line.size()) line[position] = characters[random() % (sizeof(characters) - 1)]; break;
+        case 3: line.resize(position); break;
+        case 4: lines.insert(lines.begin() + (random() % lines.size()), insertedLines[random() % 8]); break;
+        case 5: lines.erase(lines.begin() + (random() % lines.size())); break;
+        default: line = lines[random() % lines.size()]; break;
+        }
+    }
+
+    string fuzzed;
+    for (const string& line : lines) fuzzed.append(line).append("\n");
+    return fuzzed;
+}
+
+// Moves, removes and adds elements like an editor session does
+WorkspaceBuilder::Structs::Workflow EditWorkflow(WorkspaceBuilder::Structs::Workflow workflow) {
+    if (workflow.blocks.size() > 2) {
+        workflow.blocks[1].position.x += 10;
+        workflow.blocks.erase(workflow.blocks.begin() + 2);
+    }
+    WorkspaceBuilder::Structs::Block added = { 1000000, "vglClErode", "localhost", { 1, 2 }, {}, {}, {} };
+    added.variables.push_back(WorkspaceBuilder::Functions::ConvertVariableViewToVariable({ "window_size_x", "3", WorkspaceBuilder::Enums::VariableType::Integer }));
+    added.variables.push_back(WorkspaceBuilder::Functions::ConvertVariableViewToVariable({ "convolution_window", "[0.25, 0.5, 0.25]", WorkspaceBuilder::Enums::VariableType::Array }));
+    workflow.blocks.push_back(added);
+    workflow.connections.push_back({ (int)workflow.connections.size(), 1, "img_output", 1000000, "img_input" });
+    workflow.comments.push_back({ 0, " Edited", { 0, 0 } });
+    return workflow;
+}
+
+string ReadFileBytes(const string& path) {
+    ifstream file(path, ios::in | ios::binary);
+    return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+// Loads a generated file with every path based loader and checks that each writer and round trip keeps it unchanged
+void CheckFileLoaders(EquivalenceCheck& check, const string& text, const string& directory) {
+    filesystem::remove_all(directory);
+    filesystem::create_directories(directory);
+
+    string textPath = directory + "/check.wksp";
+    string gzipPath = directory + "/check.wksp.gz";
+    string cacheDirectory = directory + "/cache";
+    {
+        ofstream file(textPath, ios::out | ios::binary);
+        file << text;
+        WorkspaceBuilder::SupportFunctions::GzipWriter writer(gzipPath);
+        writer.Write(text);
+        writer.Close();
+    }
+
+    ParseOutcome expected = RunParser([&]() { return WorkspaceBuilder::Functions::ParseWorkflow(SplitLines(text)); });
+    check.Expect("ParseParameterValue", expected.isThrown ? expected.error : FindParameterDifference(expected.workflow));
+    WorkspaceBuilder::Structs::WorkflowIOPool pool(2, 2);
+
+    for (const string& path : { textPath, gzipPath }) {
+        string suffix = path == gzipPath ? " (.gz)" : "";
+
+        check.Expect("GetLinesFromFile" + suffix, expected, RunParser([&]() {
+            return WorkspaceBuilder::Functions::ParseWorkflow(WorkspaceBuilder::SupportFunctions::GetLinesFromFile(path));
+        }));
+        check.Expect("LoadWorkflow" + suffix, expected, RunParser([&]() {
+            return WorkspaceBuilder::Functions::LoadWorkflow(path);
+        }));
+        check.Expect("LoadWorkflowView" + suffix, expected, RunParser([&]() {
+            return WorkspaceBuilder::Functions::ConvertWorkflowViewToWorkflow(WorkspaceBuilder::Functions::LoadWorkflowView(path));
+        }));
+        check.Expect("LoadWorkflowIntoArena" + suffix, expected, RunParser([&]() {
+            return WorkspaceBuilder::Functions::ConvertPmrWorkflowToWorkflow(WorkspaceBuilder::Functions::LoadWorkflowIntoArena(path).Workflow());
+        }));
+        check.Expect("LoadWorkflowParallel" + suffix, expected, RunParser([&]() {
+            return WorkspaceBuilder::Functions::LoadWorkflowParallel(path, 4);
+        }));
+        check.Expect("ReadWorkflowFile" + suffix, expected, RunParser([&]() {
+            WorkspaceBuilder::Structs::Workflow workflow;
+            WorkspaceBuilder::Functions::ReadWorkflowFile(path, CollectWorkflow(workflow));
+            return workflow;
+        }));
+        check.Expect("LoadWorkflowWithDiagnostics" + suffix, expected, RunParser([&]() {
+            WorkspaceBuilder::Structs::DiagnosticParseResult result = WorkspaceBuilder::Functions::LoadWorkflowWithDiagnostics(path);
+            if (!result.diagnostics.empty()) throw runtime_error(result.diagnostics[0].message);
+            return result.workflow;
+        }));
+        // The first load misses and writes the entry, the second one reads it
+        for (const char* cacheState : { " miss", " hit" }) {
+            check.Expect("LoadWorkflowCached" + suffix + cacheState, expected, RunParser([&]() {
+                return WorkspaceBuilder::Functions::LoadWorkflowCached(path, cacheDirectory);
+            }));
+        }
+        // An entry of another source under this name, like a hash collision, must be parsed again instead of used
+        check.Expect("LoadWorkflowCached" + suffix + " foreign entry", expected, RunParser([&]() {
+            string foreignPath = directory + "/foreign.wksp";
+            ofstream(foreignPath, ios::out | ios::binary) << "WorkspaceBegin: 1.0\n";
+            WorkspaceBuilder::Functions::LoadWorkflowCached(foreignPath, cacheDirectory);
+
+            string entryPath = WorkspaceBuilder::SupportFunctions::GetParseCachePath(cacheDirectory, ReadFileBytes(path));
+            filesystem::copy_file(WorkspaceBuilder::SupportFunctions::GetParseCachePath(cacheDirectory, ReadFileBytes(foreignPath)), entryPath, filesystem::copy_options::overwrite_existing);
+            return WorkspaceBuilder::Functions::LoadWorkflowCached(path, cacheDirectory);
+        }));
+        check.Expect("LoadJournaledWorkflow" + suffix, expected, RunParser([&]() {
+            return WorkspaceBuilder::Functions::LoadJournaledWorkflow(path);
+        }));
+        check.Expect("LoadWorkflowAsync" + suffix, expected, RunParser([&]() {
+            return pool.LoadWorkflowAsync(path).get();
+        }));
+        check.Expect("LoadWorkflows" + suffix, expected, RunParser([&]() {
+            return WorkspaceBuilder::Functions::LoadWorkflows({ path }, 1, true).files[0].workflow;
+        }));
+    }
+
+    if (expected.isThrown) {
+        check.Expect("ParseWorkflow", "the generated workflow threw '" + expected.error + "'");
+        return;
+    }
+    const WorkspaceBuilder::Structs::Workflow& workflow = expected.workflow;
+
+    // Round trips through the other representations
+    string binaryPath = directory + "/check.wkspb";
+    check.Expect("LoadBinaryWorkflow", expected, RunParser([&]() {
+        if (!WorkspaceBuilder::Functions::SaveBinaryWorkflow(binaryPath, workflow)) throw runtime_error("SaveBinaryWorkflow failed");
+        return WorkspaceBuilder::Functions::LoadBinaryWorkflow(binaryPath);
+    }));
+    check.Expect("LoadBinaryWorkflowView", expected, RunParser([&]() {
+        return WorkspaceBuilder::Functions::ConvertWorkflowViewToWorkflow(WorkspaceBuilder::Functions::LoadBinaryWorkflowView(binaryPath));
+    }));
+    check.Expect("ConvertColumnarToWorkflow", expected, RunParser([&]() {
+        return WorkspaceBuilder::Functions::ConvertColumnarToWorkflow(WorkspaceBuilder::Functions::ConvertWorkflowToColumnar(workflow));
+    }));
+
+    WorkspaceBuilder::Structs::Workflow edited = EditWorkflow(workflow);
+    ParseOutcome expectedEdit = { false, string(), edited };
+    check.Expect("ApplyWorkflowDiff", expectedEdit, RunParser([&]() {
+        WorkspaceBuilder::Structs::Workflow patched = workflow;
+        WorkspaceBuilder::Functions::ApplyWorkflowDiff(patched, WorkspaceBuilder::Functions::DiffWorkflows(workflow, edited));
+        return patched;
+    }));
+    // A diff whose last range doesn't fit must throw before the blocks it modifies are written
+    ParseOutcome expectedUnchanged = { false, string(), workflow };
+    check.Expect("ApplyWorkflowDiff (out of range)", expectedUnchanged, RunParser([&]() {
+        WorkspaceBuilder::Structs::Workflow patched = workflow;
+        WorkspaceBuilder::Structs::WorkflowDiff diff = WorkspaceBuilder::Functions::DiffWorkflows(workflow, edited);
+        diff.comments.first = workflow.comments.size() + 1;
+
+        try {
+            WorkspaceBuilder::Functions::ApplyWorkflowDiff(patched, diff);
+        }
+        catch (const std::runtime_error&) {
+            return patched;
+        }
+        throw runtime_error("the diff was applied");
+    }));
+
+    string journalPath = directory + "/journal.wksp";
+    filesystem::copy_file(textPath, journalPath);
+    check.Expect("WorkflowJournal", expectedEdit, RunParser([&]() {
+        {
+            WorkspaceBuilder::Structs::WorkflowJournal journal(journalPath);
+            if (!journal.Save(edited)) throw runtime_error("WorkflowJournal::Save failed");
+        }
+        return WorkspaceBuilder::Functions::LoadJournaledWorkflow(journalPath);
+    }));
+
+    // Every writer produces the bytes of SaveWkspfile(ConvertWorkflowToVectorString)
+    string expectedPath = directory + "/expected.wksp";
+    WorkspaceBuilder::SupportFunctions::SaveWkspfile(expectedPath, WorkspaceBuilder::Functions::ConvertWorkflowToVectorString(workflow));
+    string expectedBytes = ReadFileBytes(expectedPath);
+    string serialized;
+    WorkspaceBuilder::Functions::SerializeWorkflow(workflow, serialized);
+
+    check.Expect("SerializeWorkflow", serialized == expectedBytes ? string() : "the text differs from SaveWkspfile");
+
+    // The arena workflow is written and indexed without being copied into a Workflow
+    WorkspaceBuilder::Structs::ArenaWorkflow arena = WorkspaceBuilder::Functions::ParseWorkflowIntoArena(text);
+    string arenaSerialized;
+    WorkspaceBuilder::Functions::SerializeWorkflow(arena.Workflow(), arenaSerialized);
+    check.Expect("SerializeWorkflow (arena)", arenaSerialized == expectedBytes ? string() : "the text differs from SaveWkspfile");
+
+    WorkspaceBuilder::Structs::Workflow indexed = workflow;
+    WorkspaceBuilder::Structs::WorkflowGraph graph = WorkspaceBuilder::Functions::BuildWorkflowGraph(indexed);
+    WorkspaceBuilder::Structs::WorkflowGraph arenaGraph = WorkspaceBuilder::Functions::BuildWorkflowGraph(arena.Workflow());
+    bool isSameGraph = graph.outgoingOffsets == arenaGraph.outgoingOffsets && graph.outgoingConnections == arenaGraph.outgoingConnections
+        && graph.incomingOffsets == arenaGraph.incomingOffsets && graph.incomingConnections == arenaGraph.incomingConnections
+        && graph.danglingConnections == arenaGraph.danglingConnections;
+    for (size_t i = 0; i < indexed.blocks.size() && isSameGraph; i++) {
+        const WorkspaceBuilder::Structs::PmrBlock& arenaBlock = arena.Workflow().blocks[i];
+
+        isSameGraph = indexed.blocks[i].outputs.size() == arenaBlock.outputs.size() && indexed.blocks[i].inputs.size() == arenaBlock.inputs.size()
+            && WorkspaceBuilder::Functions::GetDownstreamBlocks(graph, indexed, (int)i) == WorkspaceBuilder::Functions::GetDownstreamBlocks(arenaGraph, arena.Workflow(), (int)i);
+    }
+    check.Expect("BuildWorkflowGraph (arena)", isSameGraph ? string() : "the graph differs from the Workflow one");
+    check.Expect("SaveWorkflow", WorkspaceBuilder::Functions::SaveWorkflow(directory + "/saved.wksp", workflow) && ReadFileBytes(directory + "/saved.wksp") == expectedBytes
+        ? string() : "the file differs from SaveWkspfile");
+    check.Expect("SaveWorkflow (.gz)", WorkspaceBuilder::Functions::SaveWorkflow(directory + "/saved.wksp.gz", workflow) && WorkspaceBuilder::SupportFunctions::ReadGzipFile(directory + "/saved.wksp.gz") == expectedBytes
+        ? string() : "the inflated file differs from SaveWkspfile");
+    check.Expect("SaveWorkflowAsync", pool.SaveWorkflowAsync(directory + "/async.wksp", workflow).get() && ReadFileBytes(directory + "/async.wksp") == expectedBytes
+        ? string() : "the file differs from SaveWkspfile");
+    check.Expect("ConvertWkspbToWksp", WorkspaceBuilder::Functions::ConvertWkspbToWksp(binaryPath, directory + "/binary.wksp") && ReadFileBytes(directory + "/binary.wksp") == expectedBytes
+        ? string() : "the file differs from SaveWkspfile");
+}
+
+// Decodes the arguments of a glyph line and compares them with values written by hand, like the convolution window of teste.wksp
+void CheckParameterValues(EquivalenceCheck& check) {
+    struct ExpectedValue {
+        WorkspaceBuilder::Enums::ParameterType type;
+        int64_t integerValue;
+        double doubleValue;
+        vector<double> doubleArray;
+    };
+    const ExpectedValue expectedValues[] = {
+        { WorkspaceBuilder::Enums::ParameterType::IntegerParameter, 42, 0.0, {} },
+        { WorkspaceBuilder::Enums::ParameterType::DoubleParameter, 0, 2.5e-3, {} },
+        { WorkspaceBuilder::Enums::ParameterType::StringParameter, 0, 0.0, {} },
+        { WorkspaceBuilder::Enums::ParameterType::NumberArrayParameter, 0, 0.0, { 0.0030, 0.0133, 0.0219, 0.0133, 0.0030, 0.0133, 0.0596, 0.0983, 0.0596, 0.0133, 0.0219, 0.0983, 0.1621, 0.0983, 0.0219, -1, 1e3 } },
+        { WorkspaceBuilder::Enums::ParameterType::NumberArrayParameter, 0, 0.0, {} },
+        { WorkspaceBuilder::Enums::ParameterType::StringParameter, 0, 0.0, {} },
+        { WorkspaceBuilder::Enums::ParameterType::StringParameter, 0, 0.0, {} }
+    };
+    string line = "Glyph:VGL_CL:vglClConvolution:localhost:1:10:20: -integer 42 -double 2.5e-3 -text '12' "
+        "-window [0.0030, 0.0133, 0.0219, 0.0133, 0.0030, 0.0133, 0.0596, 0.0983, 0.0596, 0.0133, 0.0219, 0.0983, 0.1621, 0.0983, 0.0219,\t-1,1e3] "
+        "-empty [ ] -trailing [1, 2,] -missing [1 2]";
+
+    ParseOutcome parsed = RunParser([&]() {
+        WorkspaceBuilder::Structs::Workflow workflow;
+        workflow.blocks.push_back(WorkspaceBuilder::Functions::ParseBlockLine(line));
+        return workflow;
+    });
+    if (parsed.isThrown) {
+        check.Expect("ParseParameterValue", "exception '" + parsed.error + "' for " + line);
+        return;
+    }
+
+    const vector<WorkspaceBuilder::Structs::Variable>& variables = parsed.workflow.blocks[0].variables;
+    size_t expectedCount = sizeof(expectedValues) / sizeof(expectedValues[0]);
+    if (variables.size() != expectedCount) {
+        check.Expect("ParseParameterValue", to_string(expectedCount) + " variables expected, " + to_string(variables.size()) + " found");
+        return;
+    }
+
+    for (size_t i = 0; i < expectedCount; i++) {
+        const ExpectedValue& value = expectedValues[i];
+        WorkspaceBuilder::Structs::ParameterValue expected;
+        expected.type = value.type;
+        expected.integerValue = value.integerValue;
+        expected.doubleValue = value.doubleValue;
+        expected.doubleArray = value.doubleArray;
+
+        check.Expect("ParseParameterValue", IsSameParameter(expected, variables[i].parameter) ? string() : "the value of '" + variables[i].key + "' differs");
+    }
+
+    // The kernels take the lists as floats
+    vector<float> numbers;
+    WorkspaceBuilder::Functions::GetFloatArray(variables[3].parameter, numbers);
+    check.Expect("GetFloatArray", numbers.size() == 17 && numbers[0] == 0.0030f && numbers[16] == 1000.0f ? string() : "the float list differs from the decoded one");
+}
+
+// Compares every parser, loader and writer with ParseWorkflow and SaveWkspfile. Returns false when one of them differs
+bool RunEquivalenceCheck(const GeneratorOptions& options, int fuzzedCount, const string& directory) {
+    EquivalenceCheck check;
+
+    CheckParameterValues(check);
+    CheckFileLoaders(check, GenerateWorkflow(options), directory);
+    cout << "Files: " << check.comparisons << " comparisons, " << check.failures << " failures" << endl;
+
+    // Small workflows so every fuzzed line goes through each parser quickly
+    GeneratorOptions fuzzOptions;
+    fuzzOptions.glyphs = 12;
+    fuzzOptions.connections = 16;
+    fuzzOptions.arrayLength = 4;
+    fuzzOptions.annotations = 3;
+    mt19937 random(options.seed);
+
+    for (int i = 0; i < fuzzedCount; i += 64) {
+        fuzzOptions.seed = options.seed + i;
+        string baseText = GenerateWorkflow(fuzzOptions);
+
+        for (int j = i; j < i + 64 && j < fuzzedCount; j++) {
+            // Three edits in a row, each one on the text of the previous one
+            vector<string> texts = { baseText };
+            for (int edit = 0; edit < 3; edit++) {
+                texts.push_back(FuzzWorkflow(texts.back(), random));
+            }
+
+            CheckBufferParsers(check, texts[1]);
+            CheckIncrementalUpdates(check, texts);
+        }
+    }
+
+    cout << "Total: " << check.comparisons << " comparisons over " << fuzzedCount << " fuzzed workflows (" << check.rejectedInputs << " rejected), " << check.failures << " failures" << endl;
+
+    return check.failures == 0;
+}
+#pragma endregion
+
+
+#pragma region Main function
+// Checks every parser, loader and writer against ParseWorkflow on a generated workflow and F fuzzed ones
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    int fuzzedCount = 10000;
+    string directory = "equivalence_check";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string option = argv[i];
+        int value = atoi(argv[i + 1]);
+
+        if (option == "--glyphs") options.glyphs = value;
+        else if (option == "--connections") options.connections = value;
+        else if (option == "--array-length") options.arrayLength = value;
+        else if (option == "--annotations") options.annotations = value;
+        else if (option == "--seed") options.seed = (unsigned int)value;
+        else if (option == "--fuzzed") fuzzedCount = value > 0 ? value : 0;
+        else if (option == "--directory") directory = argv[i + 1];
+        else {
+            cout << "Usage: ReadFileCppCheck [--glyphs N] [--connections M] [--array-length K] [--annotations A] [--seed S] [--fuzzed F] [--directory path]" << endl;
+            return 1;
+        }
+    }
+
+    try {
+        return RunEquivalenceCheck(options, fuzzedCount, directory) ? 0 : 1;
+    }
+    catch (const std::exception& e) {
+        cout << "Error: " << e.what() << '\n';
+        return 1;
+    }
+}
+#pragma endregion
@@ -0,0 +1,142 @@
+#include "GlyphTokenizer.h"
+
+// The AVX2 loop is opt in: it is compiled only when the compiler targets AVX2 (/arch:AVX2 or -mavx2), which no
+//   configuration of the projects does. Without it the SSE2 loop is used
+#if defined(__AVX2__)
+#define WORKSPACE_BUILDER_AVX2
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WORKSPACE_BUILDER_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace WorkspaceBuilder {
+    namespace SupportFunctions {
+
+        // Position of the lowest set bit of a mask that is not 0
+        static unsigned int LowestSetBit(unsigned int mask) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return (unsigned int)index;
+#else
+            return (unsigned int)__builtin_ctz(mask);
+#endif
+        }
+
+        // Appends start + n for each bit n set in the mask
+        static void AppendMaskPositions(unsigned int mask, size_t start, std::vector<uint32_t>& positions) {
+            while (mask != 0) {
+                positions.push_back((uint32_t)(start + LowestSetBit(mask)));
+                // Clears the lowest bit
+                mask &= mask - 1;
+            }
+        }
+
+        void FindGlyphDelimiters(std::string_view line, size_t start, std::vector<uint32_t>& positions) {
+            const char* data = line.data();
+            size_t size = line.size();
+            size_t i = start;
+            positions.clear();
+
+            // The vector loops also load the next character of each byte, so they stop one byte before the end
+
+#ifdef WORKSPACE_BUILDER_AVX2
+            const __m256i colon256 = _mm256_set1_epi8(':');
+            const __m256i space256 = _mm256_set1_epi8(' ');
+            const __m256i dash256 = _mm256_set1_epi8('-');
+
+            for (; i + 32 < size; i += 32) {
+                __m256i chunk = _mm256_loadu_si256((const __m256i*)(data + i));
+                __m256i next = _mm256_loadu_si256((const __m256i*)(data + i + 1));
+                __m256i colons = _mm256_cmpeq_epi8(chunk, colon256);
+                __m256i variableSeparators = _mm256_and_si256(_mm256_cmpeq_epi8(chunk, space256), _mm256_cmpeq_epi8(next, dash256));
+
+                AppendMaskPositions((unsigned int)_mm256_movemask_epi8(_mm256_or_si256(colons, variableSeparators)), i, positions);
+            }
+#endif
+
+#ifdef WORKSPACE_BUILDER_SSE2
+            const __m128i colon = _mm_set1_epi8(':');
+            const __m128i space = _mm_set1_epi8(' ');
+            const __m128i dash = _mm_set1_epi8('-');
+
+            for (; i + 16 < size; i += 16) {
+                __m128i chunk = _mm_loadu_si128((const __m128i*)(data + i));
+                __m128i next = _mm_loadu_si128((const __m128i*)(data + i + 1));
+                __m128i colons = _mm_cmpeq_epi8(chunk, colon);
+                __m128i variableSeparators = _mm_and_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(next, dash));
+
+                AppendMaskPositions((unsigned int)_mm_movemask_epi8(_mm_or_si128(colons, variableSeparators)), i, positions);
+            }
+#endif
+
+            // Scalar tail, also the whole search when there is no vector support
+            for (; i < size; i++) {
+                if (data[i] == ':' || (data[i] == ' ' && i + 1 < size && data[i + 1] == '-')) {
+                    positions.push_back((uint32_t)i);
+                }
+            }
+        }
+    }
+
+    namespace Functions {
+
+        void TokenizeGlyphLine(std::string_view line, WorkspaceBuilder::Structs::GlyphTokens& tokens, std::vector<WorkspaceBuilder::Structs::FieldSpan>& variables) {
+            // 'Glyph:VGL_CL:' is 13 characters
+            const uint32_t functionStart = 13;
+            static thread_local std::vector<uint32_t> positions;
+
+            tokens = WorkspaceBuilder::Structs::GlyphTokens();
+            variables.clear();
+
+            uint32_t lineLength = (uint32_t)line.size();
+            if (lineLength <= functionStart) {
+                return;
+            }
+
+            tokens.library = { 6, functionStart - 7 };
+
+            WorkspaceBuilder::Structs::FieldSpan* fields[5] = { &tokens.function, &tokens.hostMachine, &tokens.id, &tokens.x, &tokens.y };
+            uint32_t fieldStart = functionStart;
+            uint32_t variableStart = 0;
+            bool isLastCharacterField = false;
+
+            WorkspaceBuilder::SupportFunctions::FindGlyphDelimiters(line, functionStart, positions);
+
+            for (uint32_t i : positions) {
+                if (line[i] == ':') {
+                    // A ':' right after another one is part of a '::' separator
+                    if (line[i - 1] == ':' || tokens.fieldCount == 5) {
+                        continue;
+                    }
+
+                    *fields[tokens.fieldCount] = { fieldStart, i - fieldStart };
+                    tokens.fieldEnd[tokens.fieldCount] = i;
+                    tokens.fieldCount++;
+
+                    // The next field starts after a ':' or a '::'
+                    fieldStart = i + 1 < lineLength && line[i + 1] == ':' ? i + 2 : i + 1;
+                    isLastCharacterField = i == lineLength - 1;
+                }
+                else if (variableStart == 0) {
+                    // The first ' -' starts the arguments
+                    variableStart = i + 2;
+                }
+                else {
+                    variables.push_back({ variableStart, i - variableStart });
+                    variableStart = i + 2;
+                }
+            }
+
+            // The last argument runs until the end of the line
+            if (variableStart != 0 && !isLastCharacterField) {
+                variables.push_back({ variableStart, lineLength - variableStart });
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include <cstdint>
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // Start and length of a field inside a line
+        struct FieldSpan {
+            uint32_t start = 0;
+            uint32_t length = 0;
+        };
+
+        // Fields of a line 'Glyph:Lib:Function:Host:Id:X:Y -arg value -arg value'
+        struct GlyphTokens {
+            // The parser expects a 6 characters library, like 'VGL_CL', so the function always starts at 13
+            FieldSpan library;
+            FieldSpan function;
+            FieldSpan hostMachine;
+            FieldSpan id;
+            FieldSpan x;
+            FieldSpan y;
+            // Number of fields closed by a ':', from 0 (none) to 5 (function, host, id, x and y)
+            int fieldCount = 0;
+            // Position after each field in the order above, used to report errors in line order
+            uint32_t fieldEnd[5] = {};
+        };
+    }
+    #pragma endregion
+
+    #pragma region Support Functions
+    namespace SupportFunctions {
+        /**
+        * Finds the glyph delimiters of a line: every ':' and every ' ' followed by '-'. Uses AVX2 or SSE2 when the
+        *   build targets them and a scalar loop otherwise.
+        *
+        * @param line: The line to be searched
+        * @param start: First position to be tested
+        * @param positions: Receives the delimiter positions in order. It is cleared first
+        */
+        void FindGlyphDelimiters(std::string_view line, size_t start, std::vector<uint32_t>& positions);
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Splits a Glyph line into its field spans without copying or converting them.
+        *   The spans are the same ParseBlockLine reads, including its handling of '::' and of ' -' before the fields end.
+        *
+        * @param line: The Glyph line
+        * @param tokens: Receives the field spans
+        * @param variables: Receives the span of each 'key value' argument. It is cleared first
+        */
+        void TokenizeGlyphLine(std::string_view line, WorkspaceBuilder::Structs::GlyphTokens& tokens, std::vector<WorkspaceBuilder::Structs::FieldSpan>& variables);
+
+        /**
+        * Same as TryParseBlockLineView for a line already split by TokenizeGlyphLine, for callers that also read the tokens
+        *
+        * @param line: String address with the represented glyph to be parsed.
+        * @param tokens: The field spans of the line
+        * @param variableSpans: The argument spans of the line
+        * @param variables: List where the block variables are appended. Nothing is appended when there is an error
+        * @param block: Receives the block pointing inside the given line
+        * @param errorColumn: Receives the column, starting at 1, of the field with the error
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return NoParseError or the first error of the line
+        */
+        WorkspaceBuilder::Enums::ParseError TryParseBlockLineView(std::string_view line, const WorkspaceBuilder::Structs::GlyphTokens& tokens, const std::vector<WorkspaceBuilder::Structs::FieldSpan>& variableSpans, std::vector<WorkspaceBuilder::Structs::VariableView>& variables, WorkspaceBuilder::Structs::BlockView& block, int& errorColumn, bool verbose = false);
+    }
+    #pragma endregion
+}
@@ -0,0 +1,206 @@
+#include "GzipStream.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace WorkspaceBuilder {
+    namespace SupportFunctions {
+
+        static const size_t InputChunkSize = 64 * 1024;
+        static const size_t OutputChunkSize = 64 * 1024;
+        // Window bits of zlib for a gzip header and trailer instead of the zlib ones
+        static const int GzipWindowBits = 15 + 16;
+        // Same speed and size trade off as the gzip command line
+        static const int CompressionLevel = 6;
+
+        void ThrowGzipError(WorkspaceBuilder::Enums::GzipError error) {
+            switch (error) {
+            case WorkspaceBuilder::Enums::GzipError::UnableToOpenGzipFile:
+                throw std::runtime_error("InflateGzipFile error >> Unable to open file");
+            case WorkspaceBuilder::Enums::GzipError::InvalidGzipData:
+                throw std::runtime_error("InflateGzipFile error >> Not a valid gzip file");
+            default:
+                break;
+            }
+        }
+
+        bool IsGzipPath(const std::string& path) {
+            return path.size() >= 3 && path.compare(path.size() - 3, 3, ".gz") == 0;
+        }
+
+#pragma region Inflate
+        void InflateGzipFile(const std::string& path, const std::function<void(const char* data, size_t size)>& output) {
+            ThrowGzipError(TryInflateGzipFile(path, output));
+        }
+
+        WorkspaceBuilder::Enums::GzipError TryInflateGzipFile(const std::string& path, const std::function<void(const char* data, size_t size)>& output) {
+            std::ifstream file(path, std::ios::in | std::ios::binary);
+
+            // Also when zlib can't allocate its state
+            z_stream stream = {};
+            if (!file || inflateInit2(&stream, GzipWindowBits) != Z_OK) {
+                return WorkspaceBuilder::Enums::GzipError::UnableToOpenGzipFile;
+            }
+
+            std::vector<char> input(InputChunkSize);
+            std::vector<char> chunk(OutputChunkSize);
+            // A file without data is not a gzip file, and a member must end before the file does
+            bool isMemberEnd = false;
+            // zlib may have more output for the input it already has
+            bool isOutputFull = false;
+
+            while (true) {
+                if (stream.avail_in == 0 && !isOutputFull) {
+                    file.read(input.data(), input.size());
+                    stream.next_in = (Bytef*)input.data();
+                    stream.avail_in = (uInt)file.gcount();
+
+                    if (stream.avail_in == 0) break;
+                }
+
+                // A file with several gzip members is read whole
+                if (isMemberEnd) {
+                    inflateReset(&stream);
+                    isMemberEnd = false;
+                }
+
+                stream.next_out = (Bytef*)chunk.data();
+                stream.avail_out = (uInt)chunk.size();
+                int result = inflate(&stream, Z_NO_FLUSH);
+
+                if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+                    break;
+                }
+
+                size_t size = chunk.size() - stream.avail_out;
+                if (size > 0) {
+                    output(chunk.data(), size);
+                }
+
+                isMemberEnd = result == Z_STREAM_END;
+                isOutputFull = !isMemberEnd && stream.avail_out == 0;
+            }
+
+            inflateEnd(&stream);
+
+            return isMemberEnd ? WorkspaceBuilder::Enums::GzipError::NoGzipError : WorkspaceBuilder::Enums::GzipError::InvalidGzipData;
+        }
+
+        bool ReadGzipLines(const std::string& path, const std::function<void(std::string_view line)>& onLine) {
+            bool isLineEnd;
+            ThrowGzipError(TryReadGzipLines(path, onLine, isLineEnd));
+
+            return isLineEnd;
+        }
+
+        WorkspaceBuilder::Enums::GzipError TryReadGzipLines(const std::string& path, const std::function<void(std::string_view line)>& onLine, bool& isLineEnd) {
+            // Part of a line that continues in the next chunk
+            std::string partialLine;
+            isLineEnd = true;
+
+            WorkspaceBuilder::Enums::GzipError error = TryInflateGzipFile(path, [&](const char* data, size_t size) {
+                size_t start = 0;
+
+                while (start < size) {
+                    const char* lineBreak = (const char*)memchr(data + start, '\n', size - start);
+
+                    if (lineBreak == nullptr) {
+                        partialLine.append(data + start, size - start);
+                        break;
+                    }
+
+                    size_t end = lineBreak - data;
+                    if (partialLine.empty()) {
+                        onLine(std::string_view(data + start, end - start));
+                    }
+                    else {
+                        partialLine.append(data + start, end - start);
+                        onLine(partialLine);
+                        partialLine.clear();
+                    }
+                    start = end + 1;
+                }
+
+                if (size > 0) isLineEnd = data[size - 1] == '\n';
+            });
+
+            if (error == WorkspaceBuilder::Enums::GzipError::NoGzipError && !partialLine.empty()) {
+                onLine(partialLine);
+            }
+
+            return error;
+        }
+
+        std::string ReadGzipFile(const std::string& path) {
+            std::string content;
+
+            InflateGzipFile(path, [&](const char* data, size_t size) {
+                content.append(data, size);
+            });
+
+            return content;
+        }
+#pragma endregion
+
+#pragma region Deflate
+        GzipWriter::GzipWriter(const std::string& path) : file(path, std::ios::out | std::ios::binary | std::ios::trunc), stream(new z_stream()), output(OutputChunkSize) {
+            if (file && deflateInit2(stream.get(), CompressionLevel, Z_DEFLATED, GzipWindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                file.close();
+            }
+        }
+
+        GzipWriter::~GzipWriter() {
+            if (!isClosed && IsOpen()) {
+                Close();
+            }
+        }
+
+        void GzipWriter::Deflate(int flush) {
+            do {
+                stream->next_out = (Bytef*)output.data();
+                stream->avail_out = (uInt)output.size();
+                deflate(stream.get(), flush);
+
+                file.write(output.data(), output.size() - stream->avail_out);
+            } while (stream->avail_out == 0);
+        }
+
+        void GzipWriter::Write(std::string_view data) {
+            if (isClosed || !IsOpen()) {
+                return;
+            }
+
+            // Given in chunks, avail_in is 32 bits
+            while (!data.empty()) {
+                size_t length = data.size() < InputChunkSize ? data.size() : InputChunkSize;
+
+                stream->next_in = (Bytef*)data.data();
+                stream->avail_in = (uInt)length;
+                Deflate(Z_NO_FLUSH);
+                data.remove_prefix(length);
+            }
+        }
+
+        bool GzipWriter::Close() {
+            if (isClosed) {
+                return !file.fail();
+            }
+            if (!IsOpen()) {
+                return false;
+            }
+
+            // Compresses what is left and writes the gzip trailer
+            stream->next_in = nullptr;
+            stream->avail_in = 0;
+            Deflate(Z_FINISH);
+            deflateEnd(stream.get());
+
+            file.close();
+            isClosed = true;
+
+            return !file.fail();
+        }
+#pragma endregion
+    }
+}
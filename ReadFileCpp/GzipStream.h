@@ -0,0 +1,146 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The stream state of zlib, from zlib.h
+struct z_stream_s;
+
+namespace WorkspaceBuilder {
+    #pragma region Enums
+    namespace Enums {
+        // Why a gzip file could not be read
+        enum GzipError {
+            NoGzipError,
+            UnableToOpenGzipFile,
+            // The data is broken or truncated
+            InvalidGzipData
+        };
+    }
+    #pragma endregion
+
+    #pragma region Support Functions
+    namespace SupportFunctions {
+        /*
+        * gzip (RFC 1952) streams for .wksp.gz files, through the inflate and deflate streams of zlib.
+        *   Data goes through a few chunk buffers. The exceptions that hold a whole inflated file in memory are
+        *   ReadGzipFile, WorkflowFileBuffer (LoadWorkflowParallel) and LoadWorkflowView.
+        *   The writer compresses at level 6, like the gzip command line.
+        */
+
+        /**
+        * Tells if a path names a gzip compressed file
+        *
+        * @param path: The file path
+        * @return True when the path ends with ".gz"
+        */
+        bool IsGzipPath(const std::string& path);
+
+        /**
+        * Decompresses a gzip file in chunks. Files with several gzip members are read whole
+        *
+        * @param path: The string address of a valid gzip file
+        * @param output: Receives each decompressed chunk in order
+        *
+        * @throws Unable to open file> if the given path is invalid || Not a valid gzip file> if the data is broken or truncated
+        */
+        void InflateGzipFile(const std::string& path, const std::function<void(const char* data, size_t size)>& output);
+
+        /**
+        * Same as InflateGzipFile without throwing, for the parsers that report problems as codes.
+        *   Exceptions thrown by output are not caught
+        *
+        * @param path: The string address of a gzip file
+        * @param output: Receives each decompressed chunk in order. When the data is broken it may have received the chunks before it
+        * @return NoGzipError, or why the file could not be read
+        */
+        WorkspaceBuilder::Enums::GzipError TryInflateGzipFile(const std::string& path, const std::function<void(const char* data, size_t size)>& output);
+
+        /**
+        * Decompresses a gzip file line by line
+        *
+        * @param path: The string address of a valid gzip file
+        * @param onLine: Receives each line without the '\n'. A '\r' before it is kept
+        * @return True when the text is empty or ends with '\n'. The empty text after the last '\n' is not passed to onLine
+        *
+        * @throws Unable to open file> if the given path is invalid || Not a valid gzip file> if the data is broken or truncated
+        */
+        bool ReadGzipLines(const std::string& path, const std::function<void(std::string_view line)>& onLine);
+
+        /**
+        * Same as ReadGzipLines without throwing. Exceptions thrown by onLine are not caught
+        *
+        * @param path: The string address of a gzip file
+        * @param onLine: Receives each line without the '\n'. A '\r' before it is kept
+        * @param isLineEnd: Set to true when the text is empty or ends with '\n'
+        * @return NoGzipError, or why the file could not be read
+        */
+        WorkspaceBuilder::Enums::GzipError TryReadGzipLines(const std::string& path, const std::function<void(std::string_view line)>& onLine, bool& isLineEnd);
+
+        /**
+        * Throws the exception of a gzip error. Nothing happens for NoGzipError
+        *
+        * @param error: The error returned by a Try gzip function
+        *
+        * @throws Unable to open file> for UnableToOpenGzipFile || Not a valid gzip file> for InvalidGzipData
+        */
+        void ThrowGzipError(WorkspaceBuilder::Enums::GzipError error);
+
+        /**
+        * Decompresses a whole gzip file in memory, for the loaders that parse a whole buffer
+        *
+        * @param path: The string address of a valid gzip file
+        * @return The decompressed content
+        *
+        * @throws Unable to open file> if the given path is invalid || Not a valid gzip file> if the data is broken or truncated
+        */
+        std::string ReadGzipFile(const std::string& path);
+
+        // Writes a gzip file as data arrives. Only the zlib window and one output chunk are kept in memory
+        class GzipWriter {
+        public:
+            /**
+            * Creates the file and writes the gzip header. Existing file in this path shall be overridden.
+            *
+            * @param path: The path where the file will be saved
+            */
+            explicit GzipWriter(const std::string& path);
+            // Closes the stream if Close was not called
+            ~GzipWriter();
+
+            GzipWriter(const GzipWriter&) = delete;
+            GzipWriter& operator=(const GzipWriter&) = delete;
+
+            // False when the file could not be created
+            bool IsOpen() const { return file.is_open(); }
+
+            /**
+            * Adds data to the stream. It is compressed and written in chunks
+            *
+            * @param data: The data to be added
+            */
+            void Write(std::string_view data);
+
+            /**
+            * Compresses what is left, writes the gzip trailer and closes the file
+            *
+            * @return A boolean telling if the whole file was written or not
+            */
+            bool Close();
+
+        private:
+            // Runs deflate until it needs more input, writing its output to the file
+            void Deflate(int flush);
+
+            std::ofstream file;
+            bool isClosed = false;
+            std::unique_ptr<z_stream_s> stream;
+            std::vector<char> output;
+        };
+    }
+    #pragma endregion
+}
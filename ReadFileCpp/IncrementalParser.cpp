@@ -0,0 +1,330 @@
+#include "IncrementalParser.h"
+
+#include <stdexcept>
+
+namespace WorkspaceBuilder {
+    namespace SupportFunctions {
+
+        uint64_t HashLine(std::string_view line) {
+            uint64_t hash = 14695981039346656037ull;
+
+            for (char character : line) {
+                hash ^= (unsigned char)character;
+                hash *= 1099511628211ull;
+            }
+
+            return hash;
+        }
+    }
+
+    namespace Functions {
+
+        // Counts the elements a line makes
+        static void AddLineElements(WorkspaceBuilder::Structs::SourceLineState& state, WorkspaceBuilder::Structs::LineClass lineClass) {
+            if (lineClass.isGlobalVariable) state.globalVariables++;
+
+            switch (lineClass.type) {
+            case WorkspaceBuilder::Enums::LineType::GlyphLine: state.blocks++; break;
+            case WorkspaceBuilder::Enums::LineType::ConnectionLine: state.connections++; break;
+            case WorkspaceBuilder::Enums::LineType::CommentLine: state.comments++; break;
+            default: break;
+            }
+        }
+
+        static bool IsVariableMarker(WorkspaceBuilder::Structs::LineClass lineClass) {
+            return lineClass.type == WorkspaceBuilder::Enums::LineType::VariablesBeginLine || lineClass.type == WorkspaceBuilder::Enums::LineType::VariablesEndLine;
+        }
+
+        static WorkspaceBuilder::Structs::SourceLineState ShiftLineState(WorkspaceBuilder::Structs::SourceLineState state, const WorkspaceBuilder::Structs::SourceShift& shift) {
+            state.start = (size_t)((int64_t)state.start + shift.bytes);
+            state.globalVariables = (uint32_t)(state.globalVariables + shift.globalVariables);
+            state.blocks = (uint32_t)(state.blocks + shift.blocks);
+            state.connections = (uint32_t)(state.connections + shift.connections);
+            state.comments = (uint32_t)(state.comments + shift.comments);
+            return state;
+        }
+
+        static void AddShift(WorkspaceBuilder::Structs::SourceShift& shift, const WorkspaceBuilder::Structs::SourceShift& other) {
+            shift.bytes += other.bytes;
+            shift.lines += other.lines;
+            shift.globalVariables += other.globalVariables;
+            shift.blocks += other.blocks;
+            shift.connections += other.connections;
+            shift.comments += other.comments;
+        }
+
+        // State before a line with the pending shift applied
+        static WorkspaceBuilder::Structs::SourceLineState GetLineState(const WorkspaceBuilder::Structs::WorkflowSourceIndex& index, size_t line) {
+            const WorkspaceBuilder::Structs::SourceLineState& state = index.lineStates[line];
+            return line >= index.pendingShift.firstLine ? ShiftLineState(state, index.pendingShift) : state;
+        }
+
+        // Writes a shift to the states of the lines first to last, excluded, and to the comments and connections those lines made.
+        //   last can be the end state, then the elements go until the end of the workflow
+        static void ApplyShift(WorkspaceBuilder::Structs::Workflow& workflow, WorkspaceBuilder::Structs::WorkflowSourceIndex& index, size_t first, size_t last, const WorkspaceBuilder::Structs::SourceShift& shift) {
+            // The element ranges are read before the states change
+            WorkspaceBuilder::Structs::SourceLineState firstState = GetLineState(index, first);
+            size_t commentEnd = workflow.comments.size();
+            size_t connectionEnd = workflow.connections.size();
+
+            if (last < index.lineStates.size()) {
+                WorkspaceBuilder::Structs::SourceLineState lastState = GetLineState(index, last);
+                commentEnd = lastState.comments;
+                connectionEnd = lastState.connections;
+            }
+
+            for (size_t i = firstState.comments; i < commentEnd; i++) {
+                workflow.comments[i].line += (int)shift.lines;
+            }
+            for (size_t i = firstState.connections; i < connectionEnd; i++) {
+                workflow.connections[i].id += (int)shift.connections;
+            }
+            for (size_t line = first; line < last; line++) {
+                index.lineStates[line] = ShiftLineState(index.lineStates[line], shift);
+            }
+        }
+
+        // Replaces count elements starting at first with the given elements, assigning in place where the ranges overlap
+        template <typename Element>
+        static void ReplaceRange(std::vector<Element>& elements, size_t first, size_t count, std::vector<Element>& replacement) {
+            size_t common = count < replacement.size() ? count : replacement.size();
+
+            for (size_t i = 0; i < common; i++) {
+                elements[first + i] = std::move(replacement[i]);
+            }
+
+            if (count > common) {
+                elements.erase(elements.begin() + (first + common), elements.begin() + (first + count));
+            }
+            else if (replacement.size() > common) {
+                elements.insert(elements.begin() + (first + common), std::make_move_iterator(replacement.begin() + common), std::make_move_iterator(replacement.end()));
+            }
+        }
+
+        WorkspaceBuilder::Structs::WorkflowSourceIndex BuildWorkflowSourceIndex(std::string_view buffer) {
+            WorkspaceBuilder::Structs::WorkflowSourceIndex index;
+            WorkspaceBuilder::Structs::LineCursor cursor;
+            WorkspaceBuilder::Structs::SourceLineState state;
+            size_t offset = 0;
+
+            while (offset < buffer.size()) {
+                state.start = offset;
+                state.isVariableParserUp = cursor.isVariableParserUp;
+                state.isVariableSectionDone = cursor.isVariableSectionDone;
+                index.lineStates.push_back(state);
+
+                std::string_view line = WorkspaceBuilder::SupportFunctions::NextLine(buffer, offset);
+                WorkspaceBuilder::Structs::LineClass lineClass = WorkspaceBuilder::SupportFunctions::AdvanceLine(line, cursor);
+
+                index.lineHashes.push_back(WorkspaceBuilder::SupportFunctions::HashLine(line));
+                index.lineClasses.push_back(lineClass);
+                AddLineElements(state, lineClass);
+            }
+
+            state.start = buffer.size();
+            state.isVariableParserUp = cursor.isVariableParserUp;
+            state.isVariableSectionDone = cursor.isVariableSectionDone;
+            index.lineStates.push_back(state);
+
+            return index;
+        }
+
+        // Parses and indexes the whole content again. The index keeps its isShiftDeferred
+        static size_t ParseWholeContent(WorkspaceBuilder::Structs::Workflow& workflow, WorkspaceBuilder::Structs::WorkflowSourceIndex& index, std::string_view buffer, bool verbose) {
+            bool isShiftDeferred = index.isShiftDeferred;
+
+            workflow = ParseWorkflowBuffer(buffer, verbose);
+            index = BuildWorkflowSourceIndex(buffer);
+            index.isShiftDeferred = isShiftDeferred;
+
+            return index.lineHashes.size();
+        }
+
+        // Parses the new lines that replace oldChanged lines starting at line prefix and patches the workflow and the index.
+        //   buffer is the whole new content, it is parsed again when the edit changes the variables section.
+        //   suffixStart is where the first line after the changed ones starts in it
+        static size_t PatchChangedLines(WorkspaceBuilder::Structs::Workflow& workflow, WorkspaceBuilder::Structs::WorkflowSourceIndex& index, std::string_view buffer, size_t prefix, size_t oldChanged, const std::vector<std::string_view>& changedLines, size_t suffixStart, bool verbose) {
+            size_t newChanged = changedLines.size();
+            size_t end = prefix + oldChanged;
+
+            bool isFullParse = index.lineHashes.empty();
+            for (size_t i = prefix; i < end && !isFullParse; i++) {
+                isFullParse = IsVariableMarker(index.lineClasses[i]);
+            }
+
+            WorkspaceBuilder::Structs::SourceLineState before;
+            WorkspaceBuilder::Structs::SourceLineState removedEnd;
+            if (!isFullParse) {
+                before = GetLineState(index, prefix);
+                removedEnd = GetLineState(index, end);
+            }
+
+            // The cursor before the first changed line
+            WorkspaceBuilder::Structs::LineCursor cursor;
+            cursor.lineNumber = (int)prefix;
+            cursor.isVariableParserUp = before.isVariableParserUp;
+            cursor.isVariableSectionDone = before.isVariableSectionDone;
+
+            std::vector<WorkspaceBuilder::Structs::LineClass> lineClasses(newChanged);
+            std::vector<WorkspaceBuilder::Structs::SourceLineState> lineStates(newChanged);
+            WorkspaceBuilder::Structs::SourceLineState state = before;
+            for (size_t i = 0; i < newChanged && !isFullParse; i++) {
+                state.start = changedLines[i].data() - buffer.data();
+                state.isVariableParserUp = cursor.isVariableParserUp;
+                state.isVariableSectionDone = cursor.isVariableSectionDone;
+                lineStates[i] = state;
+
+                lineClasses[i] = WorkspaceBuilder::SupportFunctions::AdvanceLine(changedLines[i], cursor);
+                isFullParse = IsVariableMarker(lineClasses[i]);
+                AddLineElements(state, lineClasses[i]);
+            }
+
+            // A changed variable section changes the type of the lines after it
+            if (isFullParse) {
+                return ParseWholeContent(workflow, index, buffer, verbose);
+            }
+
+            // Elements of the changed lines. Connection ids already count the connections before the edit
+            WorkspaceBuilder::Structs::Workflow changed;
+            WorkspaceBuilder::Structs::WorkflowLineSink sink = { changed, (int)before.connections, verbose };
+
+            for (size_t i = 0; i < newChanged; i++) {
+                WorkspaceBuilder::SupportFunctions::DispatchLine(changedLines[i], lineClasses[i], (int)(prefix + i + 1), sink);
+            }
+
+            // What the edit changes for the lines after it. Nothing is written to them yet, the shift is kept in the index
+            WorkspaceBuilder::Structs::SourceShift shift;
+            shift.bytes = (int64_t)suffixStart - (int64_t)removedEnd.start;
+            shift.lines = (int64_t)newChanged - (int64_t)oldChanged;
+            shift.globalVariables = (int64_t)state.globalVariables - removedEnd.globalVariables;
+            shift.blocks = (int64_t)state.blocks - removedEnd.blocks;
+            shift.connections = (int64_t)state.connections - removedEnd.connections;
+            shift.comments = (int64_t)state.comments - removedEnd.comments;
+
+            // The shift of the previous edit is merged with this one. Only the lines between both edits are written:
+            //   the previous shift to the lines before this edit, or this shift to the lines before the previous edit
+            WorkspaceBuilder::Structs::SourceShift& pending = index.pendingShift;
+            size_t shiftLine = prefix + newChanged;
+
+            if (!pending.IsEmpty()) {
+                if (pending.firstLine <= prefix) {
+                    ApplyShift(workflow, index, pending.firstLine, prefix, pending);
+                }
+                else if (pending.firstLine > end) {
+                    ApplyShift(workflow, index, end, pending.firstLine, shift);
+                    shiftLine = pending.firstLine + newChanged - oldChanged;
+                }
+                AddShift(shift, pending);
+            }
+
+            ReplaceRange(workflow.globalVariables, before.globalVariables, removedEnd.globalVariables - before.globalVariables, changed.globalVariables);
+            ReplaceRange(workflow.blocks, before.blocks, removedEnd.blocks - before.blocks, changed.blocks);
+            ReplaceRange(workflow.connections, before.connections, removedEnd.connections - before.connections, changed.connections);
+            ReplaceRange(workflow.comments, before.comments, removedEnd.comments - before.comments, changed.comments);
+
+            std::vector<uint64_t> changedHashes(newChanged);
+            for (size_t i = 0; i < newChanged; i++) {
+                changedHashes[i] = WorkspaceBuilder::SupportFunctions::HashLine(changedLines[i]);
+            }
+            ReplaceRange(index.lineHashes, prefix, oldChanged, changedHashes);
+            ReplaceRange(index.lineClasses, prefix, oldChanged, lineClasses);
+            ReplaceRange(index.lineStates, prefix, oldChanged, lineStates);
+
+            pending = shift;
+            pending.firstLine = shiftLine;
+
+            if (!index.isShiftDeferred) {
+                FlushWorkflowUpdates(workflow, index);
+            }
+
+            return newChanged;
+        }
+
+        size_t UpdateWorkflow(WorkspaceBuilder::Structs::Workflow& workflow, WorkspaceBuilder::Structs::WorkflowSourceIndex& index, std::string_view buffer, bool verbose) {
+            std::vector<std::string_view> lines;
+            std::vector<uint64_t> lineHashes;
+            size_t offset = 0;
+
+            while (offset < buffer.size()) {
+                std::string_view line = WorkspaceBuilder::SupportFunctions::NextLine(buffer, offset);
+
+                lines.push_back(line);
+                lineHashes.push_back(WorkspaceBuilder::SupportFunctions::HashLine(line));
+            }
+
+            size_t oldCount = index.lineHashes.size();
+            size_t newCount = lines.size();
+
+            // Lines equal at the start and at the end of both versions
+            size_t prefix = 0;
+            while (prefix < oldCount && prefix < newCount && index.lineHashes[prefix] == lineHashes[prefix]) {
+                prefix++;
+            }
+
+            size_t suffix = 0;
+            while (suffix < oldCount - prefix && suffix < newCount - prefix && index.lineHashes[oldCount - 1 - suffix] == lineHashes[newCount - 1 - suffix]) {
+                suffix++;
+            }
+
+            size_t oldChanged = oldCount - prefix - suffix;
+            size_t newChanged = newCount - prefix - suffix;
+
+            if (oldChanged == 0 && newChanged == 0 && !index.lineHashes.empty()) {
+                return 0;
+            }
+
+            std::vector<std::string_view> changedLines(lines.begin() + prefix, lines.begin() + (prefix + newChanged));
+            size_t suffixStart = suffix == 0 ? buffer.size() : lines[prefix + newChanged].data() - buffer.data();
+
+            return PatchChangedLines(workflow, index, buffer, prefix, oldChanged, changedLines, suffixStart, verbose);
+        }
+
+        size_t UpdateWorkflow(WorkspaceBuilder::Structs::Workflow& workflow, WorkspaceBuilder::Structs::WorkflowSourceIndex& index, std::string_view buffer, size_t firstLine, size_t removedLineCount, size_t insertedLineCount, bool verbose) {
+            if (index.lineHashes.empty()) {
+                return ParseWholeContent(workflow, index, buffer, verbose);
+            }
+
+            size_t lineCount = index.lineHashes.size();
+            if (firstLine > lineCount || removedLineCount > lineCount - firstLine) {
+                throw std::runtime_error("UpdateWorkflow error >> The changed lines are not in the previous content");
+            }
+
+            // The first changed line starts after the line before it. That line is read again because it
+            //   gets a line break when it was the last line of the previous content
+            size_t offset = 0;
+            if (firstLine > 0) {
+                offset = GetLineState(index, firstLine - 1).start;
+
+                if (offset >= buffer.size()) {
+                    throw std::runtime_error("UpdateWorkflow error >> The changed lines are not in the new content");
+                }
+                WorkspaceBuilder::SupportFunctions::NextLine(buffer, offset);
+            }
+
+            std::vector<std::string_view> changedLines;
+            changedLines.reserve(insertedLineCount);
+            for (size_t i = 0; i < insertedLineCount; i++) {
+                if (offset >= buffer.size()) {
+                    throw std::runtime_error("UpdateWorkflow error >> The changed lines are not in the new content");
+                }
+                changedLines.push_back(WorkspaceBuilder::SupportFunctions::NextLine(buffer, offset));
+            }
+
+            // The lines after the edit are not read, the new content must have as many bytes after it as the previous one
+            size_t previousSuffix = GetLineState(index, lineCount).start - GetLineState(index, firstLine + removedLineCount).start;
+            if (buffer.size() - offset != previousSuffix) {
+                throw std::runtime_error("UpdateWorkflow error >> The changed lines are not in the new content");
+            }
+
+            return PatchChangedLines(workflow, index, buffer, firstLine, removedLineCount, changedLines, offset, verbose);
+        }
+
+        void FlushWorkflowUpdates(WorkspaceBuilder::Structs::Workflow& workflow, WorkspaceBuilder::Structs::WorkflowSourceIndex& index) {
+            if (!index.pendingShift.IsEmpty()) {
+                ApplyShift(workflow, index, index.pendingShift.firstLine, index.lineStates.size(), index.pendingShift);
+            }
+
+            index.pendingShift = WorkspaceBuilder::Structs::SourceShift();
+        }
+    }
+}
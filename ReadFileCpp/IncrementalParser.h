@@ -0,0 +1,132 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include <cstdint>
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // Parser state before a line of a wksp file
+        struct SourceLineState {
+            // Position of the line in the content
+            size_t start = 0;
+            // Elements made by the lines before it
+            uint32_t globalVariables = 0;
+            uint32_t blocks = 0;
+            uint32_t connections = 0;
+            uint32_t comments = 0;
+            // Variables section state before the line, see LineCursor
+            bool isVariableParserUp = false;
+            bool isVariableSectionDone = false;
+        };
+
+        // Change an edit made to the lines after it, kept as one offset instead of being written to each line
+        struct SourceShift {
+            // First line whose state, comment line and connection id are not shifted yet
+            size_t firstLine = 0;
+            int64_t bytes = 0;
+            int64_t lines = 0;
+            int64_t globalVariables = 0;
+            int64_t blocks = 0;
+            int64_t connections = 0;
+            int64_t comments = 0;
+
+            // True when nothing is shifted
+            bool IsEmpty() const { return bytes == 0 && lines == 0 && globalVariables == 0 && blocks == 0 && connections == 0 && comments == 0; }
+        };
+
+        // What each source line of a parsed workflow was. Used to parse only the lines that changed in a new version of the file
+        struct WorkflowSourceIndex {
+            // Hash of each line
+            std::vector<uint64_t> lineHashes;
+            // Type of each line as seen by the parser
+            std::vector<LineClass> lineClasses;
+            // State before each line, plus one more entry with the state at the end of the content
+            std::vector<SourceLineState> lineStates;
+            // When true UpdateWorkflow leaves the comment lines and connection ids after each edit unshifted until
+            //   FlushWorkflowUpdates, for editors that update on every key. False keeps the workflow consistent after each update
+            bool isShiftDeferred = false;
+            // Shift of the lines after the last edit, only with isShiftDeferred. It is applied to the lines between two
+            //   edits when the next one is parsed, and to every line after the edit by FlushWorkflowUpdates
+            SourceShift pendingShift;
+        };
+    }
+    #pragma endregion
+
+    #pragma region Support Functions
+    namespace SupportFunctions {
+        /**
+        * 64 bits FNV-1a hash of a line
+        *
+        * @param line: The line without the end of line
+        * @return The line hash
+        */
+        uint64_t HashLine(std::string_view line);
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Hashes and classifies every line of a wksp file content
+        *
+        * @param buffer: The wksp file content the workflow was parsed from
+        * @return The source index of the content
+        */
+        WorkspaceBuilder::Structs::WorkflowSourceIndex BuildWorkflowSourceIndex(std::string_view buffer);
+
+        /**
+        * Updates a parsed workflow to a new version of its file. Only the lines between the first and the last
+        *   changed line are parsed again and the workflow vectors are patched in place. Finding those lines is O(n)
+        *   in the file size: every line of the new content is split and hashed, even for a one line edit.
+        *   When the caller knows which lines changed, the overload that takes the changed range skips that step.
+        *   When the edit adds or removes a 'VariablesBegin:' or 'VariablesEnd:' line the whole content is parsed again.
+        *   Blocks that are parsed again have no inputs or outputs, a WorkflowGraph of the workflow must be built again.
+        *   The comment lines and connection ids after the edit are shifted before returning, in O(n) in the elements after
+        *   the edit, unless the index has isShiftDeferred, see FlushWorkflowUpdates.
+        *
+        * @param workflow: The workflow parsed from the previous content. Replaced by the new workflow
+        * @param index: The source index of the previous content. Replaced by the index of the new content.
+        *   When empty the whole content is parsed
+        * @param buffer: The new wksp file content
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return The number of lines that were parsed
+        *
+        * @throws Not a valid format > if a variable is declared and is not following the pattern 'key value'
+        */
+        size_t UpdateWorkflow(WorkspaceBuilder::Structs::Workflow& workflow, WorkspaceBuilder::Structs::WorkflowSourceIndex& index, std::string_view buffer, bool verbose = false);
+
+        /**
+        * Same as UpdateWorkflow with the changed lines given by the caller, like an editor that knows what was typed.
+        *   The new content is not hashed and only the changed lines and the line before them are read: where they start
+        *   and the workflow elements before them come from the index. Apart from moving the vector tails when the number of
+        *   lines or elements changes and shifting the elements after the edit, the work depends on the size of the edit.
+        *   With isShiftDeferred in the index the shift is not written either: it depends on the distance from the previous
+        *   edit, whose shift is applied to the lines between both, not on the size of the workflow.
+        *
+        * @param workflow: The workflow parsed from the previous content. Replaced by the new workflow
+        * @param index: The source index of the previous content. Replaced by the index of the new content.
+        *   When empty the whole content is parsed
+        * @param buffer: The new wksp file content
+        * @param firstLine: Position of the first changed line, starting at 0
+        * @param removedLineCount: Number of lines of the previous content replaced from firstLine
+        * @param insertedLineCount: Number of lines of the new content that replace them from firstLine
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return The number of lines that were parsed
+        *
+        * @throws The changed lines are not in the previous content || The changed lines are not in the new content >
+        *   if the range does not fit the index or the buffer || Not a valid format > if a variable is declared and is not following the pattern 'key value'
+        */
+        size_t UpdateWorkflow(WorkspaceBuilder::Structs::Workflow& workflow, WorkspaceBuilder::Structs::WorkflowSourceIndex& index, std::string_view buffer, size_t firstLine, size_t removedLineCount, size_t insertedLineCount, bool verbose = false);
+
+        /**
+        * Applies the shift UpdateWorkflow left pending to the comment lines and connection ids after the last edit, when
+        *   the index has isShiftDeferred. Call it before reading them, the other fields of the workflow are always up to date.
+        *   Costs O(n) in the elements after the last edit, so an editor calls it when it needs them and not after every update.
+        *
+        * @param workflow: The workflow given to UpdateWorkflow
+        * @param index: The source index given to UpdateWorkflow. Its pending shift is applied too
+        */
+        void FlushWorkflowUpdates(WorkspaceBuilder::Structs::Workflow& workflow, WorkspaceBuilder::Structs::WorkflowSourceIndex& index);
+    }
+    #pragma endregion
+}
@@ -1,20 +1,65 @@
 #include "WorkspaceBuilder.h"
+#include "BulkLoader.h"
+
+#include <cstdlib>
+#include <filesystem>
 
 using namespace std;
 
-int main() {
+// Loads every path given after --bulk. Directories are searched for wksp files
+static int RunBulkLoad(int argc, char* argv[]) {
+    vector<string> paths;
+    int threadCount = 0;
+
+    for (int i = 2; i < argc; i++) {
+        string argument = argv[i];
+
+        if (argument == "--threads" && i + 1 < argc) {
+            threadCount = atoi(argv[++i]);
+        }
+        else if (filesystem::is_directory(argument)) {
+            vector<string> directoryFiles = WorkspaceBuilder::Functions::ListWorkflowFiles(argument);
+            paths.insert(paths.end(), directoryFiles.begin(), directoryFiles.end());
+        }
+        else {
+            paths.push_back(argument);
+        }
+    }
+
+    WorkspaceBuilder::Structs::BulkLoadReport report = WorkspaceBuilder::Functions::LoadWorkflows(paths, threadCount);
+
+    for (const WorkspaceBuilder::Structs::BulkLoadResult& result : report.files) {
+        if (!result.success) {
+            cout << "Error: " << result.path << " >> " << result.error << '\n';
+        }
+    }
+
+    cout << "Files: " << report.files.size() << " (" << report.succeeded << " loaded, " << report.failed << " failed)\n";
+    cout << "Time: " << report.totalTime << " ms, " << report.filesPerSecond << " files/s, " << report.megabytesPerSecond << " MB/s" << endl;
+
+    return report.failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    // Usage: ReadFileCpp --bulk [--threads N] <directory or file>...
+    if (argc > 1 && string(argv[1]) == "--bulk") {
+        try {
+            return RunBulkLoad(argc, argv);
+        }
+        catch (const std::exception& e) {
+            cout << "Error: " << e.what() << '\n';
+            return 1;
+        }
+    }
+
 #pragma region Code example: Parse Workflow 
     try {
 
-        vector<string> workflowLines;
-
         vector<string> workflowLinesReparsed;
 
         string fileName = "demo.wksp";
 
-        workflowLines = WorkspaceBuilder::SupportFunctions::GetLinesFromFile(fileName);
-
-        WorkspaceBuilder::Structs::Workflow workflow = WorkspaceBuilder::Functions::ParseWorkflow(workflowLines, false);
+        WorkspaceBuilder::Structs::Workflow workflow = WorkspaceBuilder::Functions::LoadWorkflow(fileName, false);
 
         for (WorkspaceBuilder::Structs::Block block : workflow.blocks) {
             cout << "Block: " << block.id << endl;
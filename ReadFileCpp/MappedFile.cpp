@@ -0,0 +1,163 @@
+#include "MappedFile.h"
+#include "GzipStream.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace WorkspaceBuilder {
+    namespace SupportFunctions {
+
+#ifdef _WIN32
+        const char* MappedFile::Map(const std::string& path) {
+            HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+            if (file == INVALID_HANDLE_VALUE) {
+                return "Unable to open file";
+            }
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize)) {
+                CloseHandle(file);
+                return "Unable to read file size";
+            }
+
+            fileHandle = file;
+            size = (size_t)fileSize.QuadPart;
+
+            // Windows can't map an empty file, an empty view is returned instead
+            if (size == 0) {
+                return nullptr;
+            }
+
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping == nullptr) {
+                Release();
+                return "Unable to map file";
+            }
+            mappingHandle = mapping;
+
+            data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (data == nullptr) {
+                Release();
+                return "Unable to map file";
+            }
+
+            return nullptr;
+        }
+
+        void MappedFile::Release() {
+            if (data != nullptr) UnmapViewOfFile(data);
+            if (mappingHandle != nullptr) CloseHandle((HANDLE)mappingHandle);
+            if (fileHandle != nullptr) CloseHandle((HANDLE)fileHandle);
+
+            data = nullptr;
+            size = 0;
+            mappingHandle = nullptr;
+            fileHandle = nullptr;
+        }
+#else
+        const char* MappedFile::Map(const std::string& path) {
+            int file = open(path.c_str(), O_RDONLY);
+
+            if (file < 0) {
+                return "Unable to open file";
+            }
+
+            struct stat fileStatus;
+            if (fstat(file, &fileStatus) != 0) {
+                close(file);
+                return "Unable to read file size";
+            }
+
+            size = (size_t)fileStatus.st_size;
+
+            // mmap does not accept a zero length, an empty view is returned instead
+            if (size == 0) {
+                close(file);
+                return nullptr;
+            }
+
+            void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+            // The mapping keeps its own reference to the file
+            close(file);
+
+            if (mapping == MAP_FAILED) {
+                size = 0;
+                return "Unable to map file";
+            }
+
+            // The whole file is read front to back by the parsers
+            madvise(mapping, size, MADV_SEQUENTIAL);
+
+            data = (const char*)mapping;
+
+            return nullptr;
+        }
+
+        void MappedFile::Release() {
+            if (data != nullptr) munmap((void*)data, size);
+
+            data = nullptr;
+            size = 0;
+        }
+#endif
+
+        MappedFile::MappedFile(const std::string& path) {
+            const char* error = Map(path);
+
+            if (error != nullptr) {
+                throw std::runtime_error(std::string("MappedFile error >> ") + error);
+            }
+        }
+
+        bool MappedFile::Open(const std::string& path) {
+            Release();
+
+            return Map(path) == nullptr;
+        }
+
+        MappedFile::~MappedFile() {
+            Release();
+        }
+
+        MappedFile::MappedFile(MappedFile&& other) noexcept {
+            *this = std::move(other);
+        }
+
+        MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+            if (this != &other) {
+                Release();
+
+                std::swap(data, other.data);
+                std::swap(size, other.size);
+#ifdef _WIN32
+                std::swap(fileHandle, other.fileHandle);
+                std::swap(mappingHandle, other.mappingHandle);
+#endif
+            }
+
+            return *this;
+        }
+
+        WorkflowFileBuffer::WorkflowFileBuffer(const std::string& path) {
+            if (IsGzipPath(path)) {
+                inflated = ReadGzipFile(path);
+                isInflated = true;
+            }
+            else {
+                mappedFile = MappedFile(path);
+            }
+        }
+    }
+}
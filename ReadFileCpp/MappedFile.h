@@ -0,0 +1,83 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace WorkspaceBuilder {
+    #pragma region Support Functions
+    namespace SupportFunctions {
+        // Read only memory mapping of a whole file. The mapping is released when the object is destroyed.
+        class MappedFile {
+        public:
+            /**
+            * Maps the given file in memory for reading
+            *
+            * @param path: The string address of a valid file
+            *
+            * @throws Unable to open file> if the given path is invalid or the file could not be mapped
+            */
+            explicit MappedFile(const std::string& path);
+            // An empty mapping that can be moved into later
+            MappedFile() = default;
+            ~MappedFile();
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+
+            /**
+            * Same as the constructor without throwing, for the loaders that report problems as codes.
+            *   The previous mapping is released first
+            *
+            * @param path: The string address of a file
+            * @return True if the file was mapped, otherwise the mapping is empty
+            */
+            bool Open(const std::string& path);
+
+            // First byte of the file. Null when the file is empty
+            const char* Data() const { return data; }
+            // File size in bytes
+            size_t Size() const { return size; }
+            // The whole file as a string view
+            std::string_view View() const { return std::string_view(data, size); }
+
+        private:
+            // Maps the file into the empty object. Returns nullptr or the error message, the object is left empty on error
+            const char* Map(const std::string& path);
+            void Release();
+
+            const char* data = nullptr;
+            size_t size = 0;
+#ifdef _WIN32
+            void* fileHandle = nullptr;
+            void* mappingHandle = nullptr;
+#endif
+        };
+
+        // Whole content of a wksp file for the loaders that need it in one buffer, like LoadWorkflowParallel which splits it
+        //   between threads. Any other file is mapped, but a ".gz" file is not streamed: it is inflated whole in memory first,
+        //   so its uncompressed size is allocated before parsing starts
+        class WorkflowFileBuffer {
+        public:
+            /**
+            * Maps or inflates the given file
+            *
+            * @param path: The string address of a valid file
+            *
+            * @throws Unable to open file> if the given path is invalid || Not a valid gzip file> if a .gz file is broken
+            */
+            explicit WorkflowFileBuffer(const std::string& path);
+            // An empty buffer that can be moved into later
+            WorkflowFileBuffer() = default;
+
+            // The whole file content as a string view
+            std::string_view View() const { return isInflated ? std::string_view(inflated) : mappedFile.View(); }
+
+        private:
+            MappedFile mappedFile;
+            std::string inflated;
+            bool isInflated = false;
+        };
+    }
+    #pragma endregion
+}
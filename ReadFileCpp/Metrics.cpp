@@ -0,0 +1,147 @@
+#include "Metrics.h"
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace WorkspaceBuilder {
+    namespace SupportFunctions {
+
+        // A trace event of a timed scope
+        struct TraceEvent {
+            WorkspaceBuilder::Enums::MetricPhase phase;
+            int thread;
+            std::chrono::steady_clock::time_point start;
+            std::chrono::steady_clock::time_point end;
+        };
+
+        static std::atomic<uint64_t> phaseTimes[WorkspaceBuilder::Enums::PhaseCount];
+        static std::atomic<uint64_t> phaseCalls[WorkspaceBuilder::Enums::PhaseCount];
+        static std::atomic<uint64_t> counters[WorkspaceBuilder::Enums::CounterCount];
+
+        static std::atomic<bool> isTraceEnabled(false);
+        static std::mutex traceMutex;
+        static std::vector<TraceEvent> traceEvents;
+
+        static std::atomic<std::ostream*> verboseStream(&std::cout);
+
+        // Small number that identifies the calling thread in the trace
+        static int GetTraceThread() {
+            static std::atomic<int> nextThread(1);
+            thread_local int thread = nextThread++;
+
+            return thread;
+        }
+
+        void AddPhaseTime(WorkspaceBuilder::Enums::MetricPhase phase, uint64_t nanoseconds) {
+            phaseTimes[phase].fetch_add(nanoseconds, std::memory_order_relaxed);
+            phaseCalls[phase].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void AddPhaseTimes(const WorkspaceBuilder::Structs::PhaseTimes& times) {
+            for (int i = 0; i < WorkspaceBuilder::Enums::PhaseCount; i++) {
+                if (times.phaseCalls[i] == 0) continue;
+
+                phaseTimes[i].fetch_add(times.phaseTime[i], std::memory_order_relaxed);
+                phaseCalls[i].fetch_add(times.phaseCalls[i], std::memory_order_relaxed);
+            }
+        }
+
+        void AddCounter(WorkspaceBuilder::Enums::MetricCounter counter, uint64_t amount) {
+            counters[counter].fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        WorkspaceBuilder::Structs::MetricsSnapshot GetMetrics() {
+            WorkspaceBuilder::Structs::MetricsSnapshot snapshot;
+
+            for (int i = 0; i < WorkspaceBuilder::Enums::PhaseCount; i++) {
+                snapshot.phaseTime[i] = phaseTimes[i].load(std::memory_order_relaxed);
+                snapshot.phaseCalls[i] = phaseCalls[i].load(std::memory_order_relaxed);
+            }
+            for (int i = 0; i < WorkspaceBuilder::Enums::CounterCount; i++) {
+                snapshot.counters[i] = counters[i].load(std::memory_order_relaxed);
+            }
+
+            return snapshot;
+        }
+
+        void ResetMetrics() {
+            for (int i = 0; i < WorkspaceBuilder::Enums::PhaseCount; i++) {
+                phaseTimes[i] = 0;
+                phaseCalls[i] = 0;
+            }
+            for (int i = 0; i < WorkspaceBuilder::Enums::CounterCount; i++) {
+                counters[i] = 0;
+            }
+
+            std::lock_guard<std::mutex> lock(traceMutex);
+            traceEvents.clear();
+        }
+
+        void SetVerboseStream(std::ostream& stream) {
+            verboseStream = &stream;
+        }
+
+        std::ostream& GetVerboseStream() {
+            return *verboseStream.load(std::memory_order_relaxed);
+        }
+
+        void SetTraceEnabled(bool enabled) {
+            isTraceEnabled = enabled;
+        }
+
+        void AddTraceEvent(WorkspaceBuilder::Enums::MetricPhase phase, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+            if (!isTraceEnabled.load(std::memory_order_relaxed)) {
+                return;
+            }
+
+            int thread = GetTraceThread();
+            std::lock_guard<std::mutex> lock(traceMutex);
+            traceEvents.push_back({ phase, thread, start, end });
+        }
+
+        const char* GetPhaseName(WorkspaceBuilder::Enums::MetricPhase phase) {
+            switch (phase) {
+            case WorkspaceBuilder::Enums::ReadPhase: return "Read";
+            case WorkspaceBuilder::Enums::GlobalVariablePhase: return "Global variables";
+            case WorkspaceBuilder::Enums::CommentPhase: return "Comments";
+            case WorkspaceBuilder::Enums::BlockParsePhase: return "Block parse";
+            case WorkspaceBuilder::Enums::ConnectionParsePhase: return "Connection parse";
+            case WorkspaceBuilder::Enums::SerializePhase: return "Serialize";
+            default: return "Unknown";
+            }
+        }
+
+        bool WriteChromeTrace(const std::string& filename) {
+            std::lock_guard<std::mutex> lock(traceMutex);
+            std::ofstream myFile(filename, std::ios::out);
+
+            if (!myFile) {
+                return false;
+            }
+
+            std::chrono::steady_clock::time_point origin = traceEvents.empty() ? std::chrono::steady_clock::time_point() : traceEvents.front().start;
+            for (const TraceEvent& event : traceEvents) {
+                if (event.start < origin) origin = event.start;
+            }
+
+            // Complete events ("ph": "X") with start and duration in microseconds
+            myFile << "{\"traceEvents\":[";
+            for (size_t i = 0; i < traceEvents.size(); i++) {
+                const TraceEvent& event = traceEvents[i];
+
+                myFile << (i == 0 ? "\n" : ",\n")
+                    << "{\"name\":\"" << GetPhaseName(event.phase) << "\",\"cat\":\"WorkspaceBuilder\",\"ph\":\"X\""
+                    << ",\"ts\":" << std::chrono::duration<double, std::micro>(event.start - origin).count()
+                    << ",\"dur\":" << std::chrono::duration<double, std::micro>(event.end - event.start).count()
+                    << ",\"pid\":1,\"tid\":" << event.thread << "}";
+            }
+            myFile << "\n],\"displayTimeUnit\":\"ms\"}\n";
+            myFile.close();
+
+            return !myFile.fail();
+        }
+    }
+}
@@ -0,0 +1,205 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Define WORKSPACE_BUILDER_METRICS in the project to record the parse and save metrics.
+//   Without it the WORKSPACE_BUILDER_* metric macros expand to nothing and the parsers have no extra cost.
+
+namespace WorkspaceBuilder {
+    #pragma region Enums
+    namespace Enums {
+        // Timed phases of loading and saving a workflow
+        enum MetricPhase {
+            ReadPhase,
+            GlobalVariablePhase,
+            CommentPhase,
+            BlockParsePhase,
+            ConnectionParsePhase,
+            SerializePhase,
+            PhaseCount
+        };
+
+        // Counted quantities
+        enum MetricCounter {
+            LineCounter,
+            ByteCounter,
+            BlockCounter,
+            ConnectionCounter,
+            // Only counted when the program's operator new uses WORKSPACE_BUILDER_COUNT, like the benchmark does
+            AllocationCounter,
+            CounterCount
+        };
+    }
+    #pragma endregion
+
+    #pragma region Structs
+    namespace Structs {
+        // Copy of the metrics recorded since the last reset
+        struct MetricsSnapshot {
+            // Time spent in each phase in nanoseconds
+            uint64_t phaseTime[WorkspaceBuilder::Enums::PhaseCount] = {};
+            // Number of timed scopes of each phase
+            uint64_t phaseCalls[WorkspaceBuilder::Enums::PhaseCount] = {};
+            uint64_t counters[WorkspaceBuilder::Enums::CounterCount] = {};
+        };
+
+        // Phase times kept by a single thread before they are added to the shared metrics
+        struct PhaseTimes {
+            // Time spent in each phase in nanoseconds
+            uint64_t phaseTime[WorkspaceBuilder::Enums::PhaseCount] = {};
+            // Number of timed scopes of each phase
+            uint64_t phaseCalls[WorkspaceBuilder::Enums::PhaseCount] = {};
+        };
+    }
+    #pragma endregion
+
+    #pragma region Support Functions
+    namespace SupportFunctions {
+        /**
+        * Adds time to a phase. Safe to call from any thread
+        *
+        * @param phase: The phase
+        * @param nanoseconds: The time spent
+        */
+        void AddPhaseTime(WorkspaceBuilder::Enums::MetricPhase phase, uint64_t nanoseconds);
+
+        /**
+        * Adds the times of every phase at once. Safe to call from any thread
+        *
+        * @param times: The times to be added
+        */
+        void AddPhaseTimes(const WorkspaceBuilder::Structs::PhaseTimes& times);
+
+        /**
+        * Adds to a counter. Safe to call from any thread and doesn't allocate
+        *
+        * @param counter: The counter
+        * @param amount: The amount to be added
+        */
+        void AddCounter(WorkspaceBuilder::Enums::MetricCounter counter, uint64_t amount);
+
+        /**
+        * Copies the metrics recorded since the last reset
+        *
+        * @return The metrics
+        */
+        WorkspaceBuilder::Structs::MetricsSnapshot GetMetrics();
+
+        // Sets every timer and counter to zero and clears the trace events
+        void ResetMetrics();
+
+        /**
+        * Turns the recording of trace events on or off. Only the whole function scopes are traced
+        *
+        * @param enabled: If true the next traced scopes are recorded
+        */
+        void SetTraceEnabled(bool enabled);
+
+        /**
+        * Adds a trace event if tracing is on
+        *
+        * @param phase: The phase of the event
+        * @param start: When the scope started
+        * @param end: When the scope finished
+        */
+        void AddTraceEvent(WorkspaceBuilder::Enums::MetricPhase phase, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+        /**
+        * Writes the recorded trace events in the Chrome trace JSON format, that can be opened in chrome://tracing or Perfetto
+        *
+        * @param filename: The path of the JSON file
+        * @return true if the file was written
+        */
+        bool WriteChromeTrace(const std::string& filename);
+
+        /**
+        * Sets where the verbose output of the parsers and writers goes. std::cout is used until it is set
+        *
+        * @param stream: The output stream. It must live while verbose calls can run
+        */
+        void SetVerboseStream(std::ostream& stream);
+
+        /**
+        * The stream set with SetVerboseStream
+        *
+        * @return The verbose output stream
+        */
+        std::ostream& GetVerboseStream();
+
+        /**
+        * Name of a phase
+        *
+        * @param phase: The phase
+        * @return The phase name
+        */
+        const char* GetPhaseName(WorkspaceBuilder::Enums::MetricPhase phase);
+
+        // Adds the time of its scope to a phase
+        class PhaseTimer {
+        public:
+            explicit PhaseTimer(WorkspaceBuilder::Enums::MetricPhase phase, bool isTraced) : phase(phase), isTraced(isTraced), start(std::chrono::steady_clock::now()) {}
+
+            ~PhaseTimer() {
+                std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+                AddPhaseTime(phase, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+                if (isTraced) AddTraceEvent(phase, start, end);
+            }
+
+            PhaseTimer(const PhaseTimer&) = delete;
+            PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+        private:
+            WorkspaceBuilder::Enums::MetricPhase phase;
+            bool isTraced;
+            std::chrono::steady_clock::time_point start;
+        };
+
+        // Times the lines of one dispatch loop with a single clock read per line: each lap runs from the end of the
+        //   previous one, so it also holds the reading of its line. The laps are kept locally and added to the
+        //   shared metrics once, when the timer is destroyed, so threads parsing in parallel don't contend
+        class PhaseLapTimer {
+        public:
+            PhaseLapTimer() : lapStart(std::chrono::steady_clock::now()) {}
+            ~PhaseLapTimer() { AddPhaseTimes(times); }
+
+            PhaseLapTimer(const PhaseLapTimer&) = delete;
+            PhaseLapTimer& operator=(const PhaseLapTimer&) = delete;
+
+            void Lap(WorkspaceBuilder::Enums::MetricPhase phase) {
+                std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+                times.phaseTime[phase] += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - lapStart).count();
+                times.phaseCalls[phase]++;
+                lapStart = end;
+            }
+
+        private:
+            WorkspaceBuilder::Structs::PhaseTimes times;
+            std::chrono::steady_clock::time_point lapStart;
+        };
+    }
+    #pragma endregion
+}
+
+#define WORKSPACE_BUILDER_METRIC_NAME_(name, line) name##line
+#define WORKSPACE_BUILDER_METRIC_NAME(name, line) WORKSPACE_BUILDER_METRIC_NAME_(name, line)
+
+// Writes to the verbose stream when verbose is true. The message is a chain of stream insertions like: "Line " << lineNumber
+//   Verbose output is a runtime option, it is there with or without WORKSPACE_BUILDER_METRICS
+#define WORKSPACE_BUILDER_VERBOSE(verbose, ...) do { if (verbose) WorkspaceBuilder::SupportFunctions::GetVerboseStream() << __VA_ARGS__; } while (0)
+
+#ifdef WORKSPACE_BUILDER_METRICS
+// Times the rest of the scope and records it as a trace event. For whole functions
+#define WORKSPACE_BUILDER_TRACE_PHASE(phase) WorkspaceBuilder::SupportFunctions::PhaseTimer WORKSPACE_BUILDER_METRIC_NAME(phaseTimer, __LINE__)(phase, true)
+// Ends a lap of a PhaseLapTimer and adds it to a phase. For the lines inside the dispatch loops
+#define WORKSPACE_BUILDER_LAP_PHASE(timer, phase) (timer).Lap(phase)
+// Adds an amount to a counter
+#define WORKSPACE_BUILDER_COUNT(counter, amount) WorkspaceBuilder::SupportFunctions::AddCounter(counter, (uint64_t)(amount))
+#else
+#define WORKSPACE_BUILDER_TRACE_PHASE(phase) ((void)0)
+#define WORKSPACE_BUILDER_LAP_PHASE(timer, phase) ((void)0)
+#define WORKSPACE_BUILDER_COUNT(counter, amount) ((void)0)
+#endif
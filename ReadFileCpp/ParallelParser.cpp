@@ -0,0 +1,237 @@
+#include "ParallelParser.h"
+#include "MappedFile.h"
+#include "Metrics.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        // Smallest amount of work given to a thread. Smaller inputs use fewer threads
+        static const size_t MinimumLinesPerThread = 256;
+        static const size_t MinimumBytesPerThread = 64 * 1024;
+
+        // Number of threads to use for a work of the given size
+        static size_t GetThreadCount(int threadCount, size_t workSize, size_t minimumWorkPerThread) {
+            size_t count = threadCount > 0 ? (size_t)threadCount : (size_t)std::thread::hardware_concurrency();
+
+            if (count == 0) count = 1;
+            if (count > workSize / minimumWorkPerThread) count = workSize / minimumWorkPerThread;
+            if (count == 0) count = 1;
+
+            return count;
+        }
+
+        // Runs work(i) for i in [0, count) on its own thread and rethrows the first error in chunk order
+        template <typename Work>
+        static void RunChunks(size_t count, Work work) {
+            std::vector<std::exception_ptr> errors(count);
+            std::vector<std::thread> threads;
+            threads.reserve(count);
+
+            for (size_t i = 1; i < count; i++) {
+                threads.emplace_back([&, i]() {
+                    try {
+                        work(i);
+                    }
+                    catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+
+            // The calling thread takes the first chunk
+            try {
+                work(0);
+            }
+            catch (...) {
+                errors[0] = std::current_exception();
+            }
+
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+
+            // The serial parse would have stopped in the first error of the file
+            for (std::exception_ptr& error : errors) {
+                if (error) std::rethrow_exception(error);
+            }
+        }
+
+        std::vector<WorkspaceBuilder::Structs::Block> ParseWorkflowBlocksParallel(const std::vector<std::string>& workflowLines, int threadCount) {
+            size_t chunkCount = GetThreadCount(threadCount, workflowLines.size(), MinimumLinesPerThread);
+            std::vector<std::vector<WorkspaceBuilder::Structs::Block>> chunkBlocks(chunkCount);
+
+            RunChunks(chunkCount, [&](size_t chunk) {
+                size_t first = workflowLines.size() * chunk / chunkCount;
+                size_t last = workflowLines.size() * (chunk + 1) / chunkCount;
+
+                for (size_t i = first; i < last; i++) {
+                    if (WorkspaceBuilder::SupportFunctions::ClassifyLine(workflowLines[i]) == WorkspaceBuilder::Enums::LineType::GlyphLine) {
+                        chunkBlocks[chunk].push_back(ParseBlockLine(workflowLines[i]));
+                    }
+                }
+            });
+
+            // Merge in file order
+            std::vector<WorkspaceBuilder::Structs::Block> blocks = std::move(chunkBlocks[0]);
+            for (size_t chunk = 1; chunk < chunkCount; chunk++) {
+                blocks.insert(blocks.end(), std::make_move_iterator(chunkBlocks[chunk].begin()), std::make_move_iterator(chunkBlocks[chunk].end()));
+            }
+
+            return blocks;
+        }
+
+        std::vector<WorkspaceBuilder::Structs::Connection> ParseWorkflowConnectionsParallel(const std::vector<std::string>& workflowLines, const std::vector<WorkspaceBuilder::Structs::Block>& blocks, int threadCount) {
+            // Throw error if there is no line
+            //      Prevents from initializing vectors and structs
+            if (workflowLines.empty()) {
+                throw std::runtime_error("ParseWorkflowConnectionsParallel error >> Workflow lines are empty");
+            }
+
+            size_t chunkCount = GetThreadCount(threadCount, workflowLines.size(), MinimumLinesPerThread);
+            std::vector<std::vector<WorkspaceBuilder::Structs::Connection>> chunkConnections(chunkCount);
+
+            RunChunks(chunkCount, [&](size_t chunk) {
+                size_t first = workflowLines.size() * chunk / chunkCount;
+                size_t last = workflowLines.size() * (chunk + 1) / chunkCount;
+
+                // Ids are local to the chunk and moved to their file position in the merge
+                for (size_t i = first; i < last; i++) {
+                    if (WorkspaceBuilder::SupportFunctions::ClassifyLine(workflowLines[i]) == WorkspaceBuilder::Enums::LineType::ConnectionLine) {
+                        chunkConnections[chunk].push_back(ParseConnectionLine(workflowLines[i], (int)chunkConnections[chunk].size(), blocks));
+                    }
+                }
+            });
+
+            std::vector<WorkspaceBuilder::Structs::Connection> connections = std::move(chunkConnections[0]);
+            for (size_t chunk = 1; chunk < chunkCount; chunk++) {
+                int idOffset = (int)connections.size();
+
+                for (WorkspaceBuilder::Structs::Connection& connection : chunkConnections[chunk]) {
+                    connection.id += idOffset;
+                    connections.push_back(std::move(connection));
+                }
+            }
+
+            return connections;
+        }
+
+        // What a thread found in its part of the buffer
+        struct BufferChunkResult {
+            // Blocks, connections and comments of the chunk. Variables are read after the merge
+            WorkspaceBuilder::Structs::Workflow workflow;
+            // Lines in the chunk. Comment lines are local to the chunk until the merge
+            int lineCount = 0;
+            // Offsets of the first variables section markers in the chunk
+            size_t variablesBegin = std::string_view::npos;
+            size_t variablesEnd = std::string_view::npos;
+        };
+
+        WorkspaceBuilder::Structs::Workflow ParseWorkflowBufferParallel(std::string_view buffer, int threadCount, bool verbose) {
+            size_t chunkCount = GetThreadCount(threadCount, buffer.size(), MinimumBytesPerThread);
+
+            // Chunk limits are moved forward to the next line start
+            std::vector<size_t> chunkStarts(chunkCount + 1, buffer.size());
+            chunkStarts[0] = 0;
+            for (size_t chunk = 1; chunk < chunkCount; chunk++) {
+                size_t start = std::max(buffer.size() * chunk / chunkCount, chunkStarts[chunk - 1] + 1);
+                size_t lineBreak = buffer.find('\n', start - 1);
+
+                chunkStarts[chunk] = lineBreak == std::string_view::npos ? buffer.size() : lineBreak + 1;
+            }
+
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Parsing workflow with " << chunkCount << " threads\n");
+
+            std::vector<BufferChunkResult> results(chunkCount);
+
+            RunChunks(chunkCount, [&](size_t chunk) {
+                BufferChunkResult& result = results[chunk];
+                size_t offset = chunkStarts[chunk];
+                size_t end = chunkStarts[chunk + 1];
+                WorkspaceBuilder::Structs::WorkflowLineSink sink = { result.workflow, 0, false };
+
+                while (offset < end) {
+                    size_t lineStart = offset;
+                    std::string_view line = WorkspaceBuilder::SupportFunctions::NextLine(buffer, offset);
+                    WorkspaceBuilder::Enums::LineType lineType = WorkspaceBuilder::SupportFunctions::ClassifyLine(line);
+                    result.lineCount++;
+
+                    switch (lineType) {
+                    case WorkspaceBuilder::Enums::LineType::VariablesBeginLine:
+                        if (result.variablesBegin == std::string_view::npos) result.variablesBegin = lineStart;
+                        break;
+                    case WorkspaceBuilder::Enums::LineType::VariablesEndLine:
+                        if (result.variablesEnd == std::string_view::npos) result.variablesEnd = lineStart;
+                        break;
+                    default:
+                        WorkspaceBuilder::SupportFunctions::DispatchLine(line, { lineType, false }, result.lineCount, sink);
+                        break;
+                    }
+                }
+            });
+
+            // Merge in file order moving ids and line numbers to their file position
+            WorkspaceBuilder::Structs::Workflow workflow;
+            int lineOffset = 0;
+            size_t variablesBegin = std::string_view::npos;
+            size_t variablesEnd = std::string_view::npos;
+
+            for (BufferChunkResult& result : results) {
+                int idOffset = (int)workflow.connections.size();
+
+                workflow.blocks.insert(workflow.blocks.end(), std::make_move_iterator(result.workflow.blocks.begin()), std::make_move_iterator(result.workflow.blocks.end()));
+
+                for (WorkspaceBuilder::Structs::Connection& connection : result.workflow.connections) {
+                    connection.id += idOffset;
+                    workflow.connections.push_back(std::move(connection));
+                }
+
+                for (WorkspaceBuilder::Structs::Comment& comment : result.workflow.comments) {
+                    comment.line += lineOffset;
+                    workflow.comments.push_back(std::move(comment));
+                }
+
+                lineOffset += result.lineCount;
+                if (variablesBegin == std::string_view::npos) variablesBegin = result.variablesBegin;
+                if (variablesEnd == std::string_view::npos) variablesEnd = result.variablesEnd;
+            }
+
+            // The variables section is small, it is read serially between its first markers
+            if (variablesBegin != std::string_view::npos && (variablesEnd == std::string_view::npos || variablesBegin < variablesEnd)) {
+                size_t offset = variablesBegin;
+                size_t end = variablesEnd == std::string_view::npos ? buffer.size() : variablesEnd;
+                WorkspaceBuilder::Structs::LineCursor cursor;
+
+                WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::GlobalVariablePhase);
+
+                while (offset < end) {
+                    std::string_view line = WorkspaceBuilder::SupportFunctions::NextLine(buffer, offset);
+
+                    if (WorkspaceBuilder::SupportFunctions::AdvanceLine(line, cursor).isGlobalVariable) {
+                        workflow.globalVariables.push_back(ParseGlobalVariableLine(line));
+                    }
+                }
+            }
+
+            WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::LineCounter, lineOffset);
+            WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::ByteCounter, buffer.size());
+            WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::BlockCounter, workflow.blocks.size());
+            WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::ConnectionCounter, workflow.connections.size());
+
+            return workflow;
+        }
+
+        WorkspaceBuilder::Structs::Workflow LoadWorkflowParallel(const std::string& path, int threadCount, bool verbose) {
+            WorkspaceBuilder::SupportFunctions::WorkflowFileBuffer file;
+            {
+                WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::ReadPhase);
+                file = WorkspaceBuilder::SupportFunctions::WorkflowFileBuffer(path);
+            }
+
+            return ParseWorkflowBufferParallel(file.View(), threadCount, verbose);
+        }
+    }
+}
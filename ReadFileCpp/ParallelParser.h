@@ -0,0 +1,57 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+
+namespace WorkspaceBuilder {
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Same as ParseWorkflowBlocks splitting the lines across threads. Blocks are returned in file order.
+        *
+        * @param workflowLines: A vector of string with each string representing a line on a workspace file.
+        * @param threadCount: Number of threads. 0 uses one thread per core
+        * @return A list of blocks in a workspace file
+        *
+        * @throws Not a valid format > if a variable is declared and is not following the pattern 'key value'
+        */
+        std::vector<WorkspaceBuilder::Structs::Block> ParseWorkflowBlocksParallel(const std::vector<std::string>& workflowLines, int threadCount = 0);
+
+        /**
+        * Same as ParseWorkflowConnections splitting the lines across threads. Connections are returned in file order with the same ids.
+        *
+        * @param workflowLines: A vector of string with each string representing a line on a workspace file.
+        * @param blocks: A list of blocks in a workspace file
+        * @param threadCount: Number of threads. 0 uses one thread per core
+        * @return A list of connections in a workspace file
+        *
+        * @throws runtime_error if workflowLines is empty
+        */
+        std::vector<WorkspaceBuilder::Structs::Connection> ParseWorkflowConnectionsParallel(const std::vector<std::string>& workflowLines, const std::vector<WorkspaceBuilder::Structs::Block>& blocks, int threadCount = 0);
+
+        /**
+        * Same as ParseWorkflowBuffer splitting the buffer at line boundaries across threads.
+        *   The result is identical to the serial parse.
+        *
+        * @param buffer: The wksp file content
+        * @param threadCount: Number of threads. 0 uses one thread per core
+        * @param verbose: If true prints in the console how the buffer was split. Default = false
+        * @return A VGL Workflow structure
+        *
+        * @throws Not a valid format > if a variable is declared and is not following the pattern 'key value'
+        */
+        WorkspaceBuilder::Structs::Workflow ParseWorkflowBufferParallel(std::string_view buffer, int threadCount = 0, bool verbose = false);
+
+        /**
+        * Memory maps a wksp file and parses it with ParseWorkflowBufferParallel. A .wksp.gz file is not streamed:
+        *   the threads split one buffer, so the whole file is inflated in memory first, see WorkflowFileBuffer
+        *
+        * @param path: The string address of a valid file
+        * @param threadCount: Number of threads. 0 uses one thread per core
+        * @param verbose: If true prints in the console how the buffer was split. Default = false
+        * @return A VGL Workflow structure
+        *
+        * @throws Unable to open file> if the given path is invalid || Not a valid gzip file> if a .gz file is broken
+        */
+        WorkspaceBuilder::Structs::Workflow LoadWorkflowParallel(const std::string& path, int threadCount = 0, bool verbose = false);
+    }
+    #pragma endregion
+}
@@ -0,0 +1,220 @@
+#include "ParseCache.h"
+#include "BinaryWorkflow.h"
+#include "MappedFile.h"
+#include "Metrics.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <zlib.h>
+
+namespace WorkspaceBuilder {
+    namespace SupportFunctions {
+
+        static const uint32_t Sha256RoundConstants[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+
+        static uint32_t RotateRight(uint32_t value, int bits) {
+            return (value >> bits) | (value << (32 - bits));
+        }
+
+        // Processes one 64 bytes block of the message
+        static void Sha256Block(uint32_t state[8], const unsigned char* block) {
+            uint32_t words[64];
+
+            for (int i = 0; i < 16; i++) {
+                words[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) | ((uint32_t)block[i * 4 + 2] << 8) | (uint32_t)block[i * 4 + 3];
+            }
+            for (int i = 16; i < 64; i++) {
+                uint32_t s0 = RotateRight(words[i - 15], 7) ^ RotateRight(words[i - 15], 18) ^ (words[i - 15] >> 3);
+                uint32_t s1 = RotateRight(words[i - 2], 17) ^ RotateRight(words[i - 2], 19) ^ (words[i - 2] >> 10);
+                words[i] = words[i - 16] + s0 + words[i - 7] + s1;
+            }
+
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], f = state[5], g = state[6], h = state[7];
+
+            for (int i = 0; i < 64; i++) {
+                uint32_t s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+                uint32_t choice = (e & f) ^ (~e & g);
+                uint32_t temp1 = h + s1 + choice + Sha256RoundConstants[i] + words[i];
+                uint32_t s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+                uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+                uint32_t temp2 = s0 + majority;
+
+                h = g; g = f; f = e; e = d + temp1;
+                d = c; c = b; b = a; a = temp1 + temp2;
+            }
+
+            state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        }
+
+        std::string Sha256Hex(std::string_view buffer) {
+            uint32_t state[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+            const unsigned char* data = (const unsigned char*)buffer.data();
+            size_t size = buffer.size();
+            size_t offset = 0;
+
+            for (; offset + 64 <= size; offset += 64) {
+                Sha256Block(state, data + offset);
+            }
+
+            // Last bytes, the 0x80 end mark and the message size in bits
+            unsigned char tail[128] = {};
+            size_t tailSize = size - offset;
+            if (tailSize > 0) memcpy(tail, data + offset, tailSize);
+            tail[tailSize] = 0x80;
+
+            size_t tailBlocks = tailSize + 9 <= 64 ? 1 : 2;
+            uint64_t bitCount = (uint64_t)size * 8;
+            for (int i = 0; i < 8; i++) {
+                tail[tailBlocks * 64 - 1 - i] = (unsigned char)(bitCount >> (i * 8));
+            }
+
+            for (size_t i = 0; i < tailBlocks; i++) {
+                Sha256Block(state, tail + i * 64);
+            }
+
+            static const char hexDigits[] = "0123456789abcdef";
+            std::string hash(64, '0');
+            for (int i = 0; i < 32; i++) {
+                unsigned char byte = (unsigned char)(state[i / 4] >> (24 - (i % 4) * 8));
+                hash[i * 2] = hexDigits[byte >> 4];
+                hash[i * 2 + 1] = hexDigits[byte & 0x0f];
+            }
+
+            return hash;
+        }
+
+        std::string GetParseCachePath(const std::string& cacheDirectory, std::string_view buffer) {
+            std::filesystem::path path(cacheDirectory);
+            path /= Sha256Hex(buffer) + "-v" + std::to_string(ParserVersion) + ".wkspb";
+
+            return path.string();
+        }
+
+        std::string GetTemporaryPath(const std::string& path) {
+            static std::atomic<uint64_t> counter{ 0 };
+            static const uint64_t processSeed = ((uint64_t)std::random_device()() << 32) | std::random_device()();
+
+            return path + "." + std::to_string(processSeed) + "." + std::to_string(counter++) + ".tmp";
+        }
+    }
+
+    namespace Functions {
+        // Written before the .wkspb bytes of a cache entry. The entry name is the SHA-256 of the source, and a hit is
+        //   only accepted when the source also has the size and the CRC-32 stored here
+        struct ParseCacheEntryHeader {
+            char magic[4];
+            uint32_t sourceCrc;
+            uint64_t sourceSize;
+        };
+        static_assert(sizeof(ParseCacheEntryHeader) == 16, "ParseCacheEntryHeader must not have padding");
+
+        static const char ParseCacheEntryMagic[4] = { 'W', 'K', 'S', 'C' };
+
+        static uint32_t GetSourceCrc(std::string_view buffer) {
+            uLong crc = crc32(0L, Z_NULL, 0);
+
+            // crc32 takes the size as an unsigned int, so a large file goes in parts
+            for (size_t offset = 0; offset < buffer.size();) {
+                uInt size = (uInt)std::min<size_t>(buffer.size() - offset, 1u << 30);
+                crc = crc32(crc, (const Bytef*)buffer.data() + offset, size);
+                offset += size;
+            }
+
+            return (uint32_t)crc;
+        }
+
+        WorkspaceBuilder::Structs::Workflow LoadWorkflowCached(const std::string& path, const std::string& cacheDirectory, bool verbose) {
+            if (cacheDirectory.empty()) {
+                return LoadWorkflow(path, verbose);
+            }
+
+            // A compressed file is keyed by its compressed bytes, so a hit doesn't inflate it
+            WorkspaceBuilder::SupportFunctions::MappedFile file(path);
+            std::string cachePath = WorkspaceBuilder::SupportFunctions::GetParseCachePath(cacheDirectory, file.View());
+            std::error_code error;
+
+            ParseCacheEntryHeader entryHeader;
+            memcpy(entryHeader.magic, ParseCacheEntryMagic, sizeof(ParseCacheEntryMagic));
+            entryHeader.sourceCrc = GetSourceCrc(file.View());
+            entryHeader.sourceSize = file.Size();
+
+            if (std::filesystem::exists(cachePath, error)) {
+                try {
+                    WorkspaceBuilder::SupportFunctions::MappedFile entry(cachePath);
+                    ParseCacheEntryHeader storedHeader;
+
+                    // An entry of another source with the same name is treated like a broken one
+                    if (entry.Size() < sizeof(storedHeader)) {
+                        throw std::runtime_error("LoadWorkflowCached error >> The entry is too small");
+                    }
+                    memcpy(&storedHeader, entry.Data(), sizeof(storedHeader));
+
+                    if (memcmp(&storedHeader, &entryHeader, sizeof(entryHeader)) != 0) {
+                        throw std::runtime_error("LoadWorkflowCached error >> The entry belongs to another source");
+                    }
+
+                    WorkspaceBuilder::Structs::Workflow workflow = ConvertWorkflowViewToWorkflow(LoadBinaryWorkflowView(std::move(entry), sizeof(storedHeader)));
+
+                    WORKSPACE_BUILDER_VERBOSE(verbose, "Loaded " << path << " from the cache " << cachePath << '\n');
+
+                    return workflow;
+                }
+                catch (const std::runtime_error&) {
+                    // Broken entry, for example after a crash during a write. It is replaced below
+                    WORKSPACE_BUILDER_VERBOSE(verbose, "Invalid cache entry " << cachePath << '\n');
+                }
+            }
+
+            // LoadWorkflow parses a compressed file while it is inflated
+            WorkspaceBuilder::Structs::Workflow workflow = WorkspaceBuilder::SupportFunctions::IsGzipPath(path) ? LoadWorkflow(path, verbose) : ParseWorkflowBuffer(file.View(), verbose);
+
+            // The cache is only an optimization, a failed write is not an error
+            std::filesystem::create_directories(cacheDirectory, error);
+
+            std::string output;
+            bool isSerialized = SerializeBinaryWorkflow(workflow, output);
+            output.insert(0, (const char*)&entryHeader, sizeof(entryHeader));
+
+            std::string temporaryPath = WorkspaceBuilder::SupportFunctions::GetTemporaryPath(cachePath);
+            bool isWritten = false;
+
+            // Workflows too large for the binary format are not cached
+            std::ofstream myFile;
+            if (isSerialized) {
+                myFile.open(temporaryPath, std::ios::out | std::ios::binary);
+            }
+
+            if (myFile.is_open()) {
+                myFile.write(output.data(), output.size());
+                myFile.close();
+                isWritten = !myFile.fail();
+            }
+
+            if (isWritten) {
+                std::filesystem::rename(temporaryPath, cachePath, error);
+                isWritten = !error;
+            }
+            if (!isWritten) {
+                std::filesystem::remove(temporaryPath, error);
+            }
+
+            WORKSPACE_BUILDER_VERBOSE(verbose, (isWritten ? "Stored " : "Unable to store ") << path << " in the cache " << cachePath << '\n');
+
+            return workflow;
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+
+namespace WorkspaceBuilder {
+    #pragma region Support Functions
+    namespace SupportFunctions {
+        // Version of the parser output stored in the cache. Must be increased when the parser or the .wkspb format changes
+        //   so the entries of older versions are not used
+        constexpr int ParserVersion = 3;
+
+        /**
+        * SHA-256 of a buffer
+        *
+        * @param buffer: The data to be hashed
+        * @return The hash as 64 lower case hexadecimal characters
+        */
+        std::string Sha256Hex(std::string_view buffer);
+
+        /**
+        * Path of the cache entry of a wksp file content
+        *
+        * @param cacheDirectory: The cache directory
+        * @param buffer: The wksp file content
+        * @return The entry path, made from the content hash and the parser version
+        */
+        std::string GetParseCachePath(const std::string& cacheDirectory, std::string_view buffer);
+
+        /**
+        * Temporary file name next to a path that no other thread or process will use.
+        *   Files are written there and renamed over the path, so readers never see a partial file.
+        *
+        * @param path: The path of the file that will be replaced
+        * @return The temporary file path
+        */
+        std::string GetTemporaryPath(const std::string& path);
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Loads a wksp file through an on disk cache of parsed workflows. On a hit the .wkspb entry is loaded and the
+        *   file is not parsed. On a miss the file is parsed and the entry is written to a temporary file and renamed,
+        *   so processes sharing the directory never see a partial entry. An entry is named by the SHA-256 of the file
+        *   and starts with the file size and CRC-32, which must match before it is used. A broken entry, or one that
+        *   doesn't match, is parsed and written again.
+        *   A .wksp.gz file is keyed by its compressed bytes and is only inflated on a miss, while it is parsed.
+        *
+        * @param path: The string address of a valid file
+        * @param cacheDirectory: Directory of the cache entries. It is created when missing. An empty string disables the cache
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return A VGL Workflow structure
+        *
+        * @throws Unable to open file> if the given path is invalid || Not a valid gzip file> if a .gz file is broken on a miss
+        */
+        WorkspaceBuilder::Structs::Workflow LoadWorkflowCached(const std::string& path, const std::string& cacheDirectory, bool verbose = false);
+    }
+    #pragma endregion
+}
@@ -0,0 +1,182 @@
+#include "ParseDiagnostics.h"
+#include "GlyphTokenizer.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        static void AddDiagnostic(WorkspaceBuilder::Structs::DiagnosticParseResult& result, int line, int column, WorkspaceBuilder::Enums::ParseError code) {
+            result.diagnostics.push_back({ line, column, code, WorkspaceBuilder::SupportFunctions::GetParseErrorMessage(code) });
+        }
+
+        // 'Glyph:VGL_CL:' and 'NodeConnection:' lengths, where the first field of each line starts
+        static const size_t GlyphFieldsStart = 13;
+        static const size_t ConnectionFieldsStart = 15;
+
+        // Column of the first field a Glyph line misses, or 0 when function, host, id, x and y are all closed by a ':'
+        static int FindMissingGlyphField(std::string_view line, const WorkspaceBuilder::Structs::GlyphTokens& tokens) {
+            if (tokens.fieldCount == 5) {
+                return 0;
+            }
+
+            size_t missingStart = tokens.fieldCount == 0 ? std::min(line.size(), GlyphFieldsStart) : tokens.fieldEnd[tokens.fieldCount - 1] + 1;
+            return (int)missingStart + 1;
+        }
+
+        // Column of the first field a NodeConnection line misses, or 0 when data type, output id, output, input id are closed by a ':'
+        static int FindMissingConnectionField(std::string_view line) {
+            size_t fieldCount = 0;
+            size_t missingStart = std::min(line.size(), ConnectionFieldsStart);
+
+            for (size_t i = line.find(':', ConnectionFieldsStart); i != std::string_view::npos && fieldCount < 4; i = line.find(':', i + 1)) {
+                fieldCount++;
+                missingStart = i + 1;
+            }
+
+            return fieldCount == 4 ? 0 : (int)missingStart + 1;
+        }
+
+        // Replaces the parse result with a MissingField error when the field is missing at or before the error column, so the first problem of the line is reported
+        static void ReportFirstMissingField(int missingColumn, WorkspaceBuilder::Enums::ParseError& error, int& errorColumn) {
+            if (missingColumn == 0) {
+                return;
+            }
+
+            if (error == WorkspaceBuilder::Enums::ParseError::NoParseError || missingColumn <= errorColumn) {
+                error = WorkspaceBuilder::Enums::ParseError::MissingField;
+                errorColumn = missingColumn;
+            }
+        }
+
+        // Line sink of DispatchLine that reports the lines it can not parse instead of throwing
+        struct DiagnosticLineSink {
+            WorkspaceBuilder::Structs::DiagnosticParseResult& result;
+            // Reused for the variables of every glyph
+            std::vector<WorkspaceBuilder::Structs::VariableView> blockVariables;
+            std::vector<WorkspaceBuilder::Structs::FieldSpan> variableSpans;
+
+            void OnGlobalVariable(std::string_view line, int lineNumber) {
+                WorkspaceBuilder::Structs::VariableView variable;
+                WorkspaceBuilder::Enums::ParseError error = TryParseGlobalVariableLineView(line, variable);
+
+                if (error == WorkspaceBuilder::Enums::ParseError::NoParseError) {
+                    result.workflow.globalVariables.push_back(WorkspaceBuilder::Functions::ConvertVariableViewToVariable(variable));
+                }
+                else {
+                    // The value is missing after the '=', or at the end of a line that has none
+                    size_t separator = line.find('=');
+                    int column = separator == std::string_view::npos ? (int)line.size() + 1 : (int)separator + 1;
+
+                    AddDiagnostic(result, lineNumber, column, error);
+                }
+            }
+
+            void OnComment(std::string_view text, int lineNumber) {
+                static const WorkspaceBuilder::Structs::Vector2 nullPosition = { 0.0, 0.0 };
+                result.workflow.comments.push_back({ lineNumber, std::string(text), nullPosition });
+            }
+
+            void OnGlyph(std::string_view line, int lineNumber) {
+                WorkspaceBuilder::Structs::BlockView view;
+                int errorColumn = 1;
+                blockVariables.clear();
+
+                // Tokenized once for the parse and the missing field check
+                WorkspaceBuilder::Structs::GlyphTokens tokens;
+                TokenizeGlyphLine(line, tokens, variableSpans);
+                WorkspaceBuilder::Enums::ParseError error = TryParseBlockLineView(line, tokens, variableSpans, blockVariables, view, errorColumn);
+
+                // The parsers read a missing field as 0, it would be a block with a wrong id or position
+                ReportFirstMissingField(FindMissingGlyphField(line, tokens), error, errorColumn);
+
+                if (error != WorkspaceBuilder::Enums::ParseError::NoParseError) {
+                    AddDiagnostic(result, lineNumber, errorColumn, error);
+                    return;
+                }
+
+                WorkspaceBuilder::Structs::Block block;
+                block.id = view.id;
+                block.type = std::string(view.type);
+                block.hostMachine = std::string(view.hostMachine);
+                block.position = view.position;
+                block.variables.reserve(blockVariables.size());
+                for (const WorkspaceBuilder::Structs::VariableView& variable : blockVariables) {
+                    block.variables.push_back(WorkspaceBuilder::Functions::ConvertVariableViewToVariable(variable));
+                }
+
+                result.workflow.blocks.push_back(std::move(block));
+            }
+
+            void OnConnection(std::string_view line, int lineNumber) {
+                WorkspaceBuilder::Structs::ConnectionView view;
+                int errorColumn = 1;
+                WorkspaceBuilder::Enums::ParseError error = TryParseConnectionLineView(line, (int)result.workflow.connections.size(), view, errorColumn);
+
+                // A missing block id is read as 0, it would be a connection between wrong blocks
+                ReportFirstMissingField(FindMissingConnectionField(line), error, errorColumn);
+
+                if (error != WorkspaceBuilder::Enums::ParseError::NoParseError) {
+                    AddDiagnostic(result, lineNumber, errorColumn, error);
+                    return;
+                }
+
+                WorkspaceBuilder::Structs::Connection connection = {
+                    view.id,
+                    view.startBlock,
+                    std::string(view.outputStartBlock.size(), '\0'),
+                    view.endBlock,
+                    std::string(view.inputEndBlock.size(), '\0')
+                };
+
+                // Port names are case insensitive, they are lowered while copied
+                WorkspaceBuilder::SupportFunctions::ToLower(view.outputStartBlock, &connection.outputStartBlock[0]);
+                WorkspaceBuilder::SupportFunctions::ToLower(view.inputEndBlock, &connection.inputEndBlock[0]);
+
+                result.workflow.connections.push_back(std::move(connection));
+            }
+        };
+
+        WorkspaceBuilder::Structs::DiagnosticParseResult ParseWorkflowBufferWithDiagnostics(std::string_view buffer) {
+            WorkspaceBuilder::Structs::DiagnosticParseResult result;
+            WorkspaceBuilder::Structs::LineCursor cursor;
+            DiagnosticLineSink sink = { result, {}, {} };
+
+            WorkspaceBuilder::SupportFunctions::DispatchLines(buffer, cursor, sink);
+
+            return result;
+        }
+
+        WorkspaceBuilder::Structs::DiagnosticParseResult LoadWorkflowWithDiagnostics(const std::string& path) {
+            // Compressed files are parsed while they are inflated
+            if (WorkspaceBuilder::SupportFunctions::IsGzipPath(path)) {
+                WorkspaceBuilder::Structs::DiagnosticParseResult result;
+                WorkspaceBuilder::Structs::LineCursor cursor;
+                DiagnosticLineSink sink = { result, {}, {} };
+                size_t byteCount;
+
+                WorkspaceBuilder::Enums::GzipError error = WorkspaceBuilder::SupportFunctions::TryDispatchGzipLines(path, cursor, sink, byteCount);
+
+                // Like a file that can't be opened, the lines read before the broken data are dropped
+                if (error != WorkspaceBuilder::Enums::GzipError::NoGzipError) {
+                    result = WorkspaceBuilder::Structs::DiagnosticParseResult();
+                    AddDiagnostic(result, 0, 0, error == WorkspaceBuilder::Enums::GzipError::InvalidGzipData ? WorkspaceBuilder::Enums::ParseError::InvalidGzipFile : WorkspaceBuilder::Enums::ParseError::UnableToOpenFile);
+                }
+
+                return result;
+            }
+
+            WorkspaceBuilder::SupportFunctions::MappedFile file;
+
+            if (!file.Open(path)) {
+                WorkspaceBuilder::Structs::DiagnosticParseResult result;
+                AddDiagnostic(result, 0, 0, WorkspaceBuilder::Enums::ParseError::UnableToOpenFile);
+                return result;
+            }
+
+            return ParseWorkflowBufferWithDiagnostics(file.View());
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // A problem found in a wksp file
+        struct ParseDiagnostic {
+            // Line of the problem, starting at 1. 0 when it is about the whole file
+            int line;
+            // Column of the field with the problem, starting at 1
+            int column;
+            WorkspaceBuilder::Enums::ParseError code;
+            std::string message;
+        };
+
+        // Workflow parsed without exceptions. Lines with errors are left out of the workflow
+        struct DiagnosticParseResult {
+            Workflow workflow;
+            std::vector<ParseDiagnostic> diagnostics;
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Parses a wksp file content without throwing. A line with an error is reported and skipped,
+        *   and the rest of the file is still parsed in the same pass. A Glyph line with less than 5 fields closed by ':'
+        *   or a NodeConnection line with less than 4 is reported as MissingField, the parsers would read the fields as 0.
+        *
+        * @param buffer: The wksp file content
+        * @return The workflow made of the valid lines and the diagnostics of the others
+        */
+        WorkspaceBuilder::Structs::DiagnosticParseResult ParseWorkflowBufferWithDiagnostics(std::string_view buffer);
+
+        /**
+        * Memory maps a wksp file and parses it without throwing. A .wksp.gz file is parsed while it is inflated
+        *
+        * @param path: The string address of a file
+        * @return The workflow made of the valid lines and the diagnostics of the others. A file that can't be opened
+        *   gives an empty workflow and an UnableToOpenFile diagnostic, a broken .wksp.gz file an InvalidGzipFile one
+        */
+        WorkspaceBuilder::Structs::DiagnosticParseResult LoadWorkflowWithDiagnostics(const std::string& path);
+    }
+    #pragma endregion
+}
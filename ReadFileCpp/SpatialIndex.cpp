@@ -0,0 +1,242 @@
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace WorkspaceBuilder {
+    namespace Structs {
+
+        // Cell coordinates are clamped here so the ring search arithmetic never overflows an int
+        static const int MaxCellCoordinate = 1 << 29;
+
+        SpatialIndex::SpatialIndex(float cellSize) : cellSize(cellSize) {
+            if (!(cellSize > 0.0f) || std::isinf(cellSize)) {
+                throw std::runtime_error("SpatialIndex error >> The cell size must be positive");
+            }
+        }
+
+        int SpatialIndex::CellCoordinate(float value) const {
+            double cell = std::floor((double)value / cellSize);
+
+            if (std::isnan(cell)) return 0;
+            if (cell < -MaxCellCoordinate) return -MaxCellCoordinate;
+            if (cell > MaxCellCoordinate) return MaxCellCoordinate;
+
+            return (int)cell;
+        }
+
+        uint64_t SpatialIndex::CellKey(int x, int y) {
+            return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+        }
+
+        SpatialIndex::Location& SpatialIndex::GetLocation(SpatialItem item) {
+            if (item.index < 0) {
+                throw std::runtime_error("SpatialIndex error >> Item index can't be negative");
+            }
+
+            std::vector<Location>& locations = item.kind == WorkspaceBuilder::Enums::SpatialItemKind::BlockItem ? blockLocations : commentLocations;
+            if ((size_t)item.index >= locations.size()) {
+                locations.resize((size_t)item.index + 1);
+            }
+
+            return locations[item.index];
+        }
+
+        const SpatialIndex::Location* SpatialIndex::FindLocation(SpatialItem item) const {
+            const std::vector<Location>& locations = item.kind == WorkspaceBuilder::Enums::SpatialItemKind::BlockItem ? blockLocations : commentLocations;
+
+            if (item.index < 0 || (size_t)item.index >= locations.size() || !locations[item.index].isIndexed) {
+                return nullptr;
+            }
+
+            return &locations[item.index];
+        }
+
+        void SpatialIndex::Insert(SpatialItem item, Vector2 position) {
+            int cellX = CellCoordinate(position.x);
+            int cellY = CellCoordinate(position.y);
+            uint64_t key = CellKey(cellX, cellY);
+            Location& location = GetLocation(item);
+
+            if (location.isIndexed) {
+                // A move inside the same cell only updates the stored position
+                if (location.cell == key) {
+                    cells[key][location.slot].position = position;
+                    return;
+                }
+
+                Remove(item);
+            }
+
+            std::vector<Entry>& cell = cells[key];
+            location.isIndexed = true;
+            location.cell = key;
+            location.slot = (uint32_t)cell.size();
+            cell.push_back({ item, position });
+            itemCount++;
+
+            if (maxCellX < minCellX) {
+                minCellX = maxCellX = cellX;
+                minCellY = maxCellY = cellY;
+            }
+            else {
+                minCellX = std::min(minCellX, cellX);
+                minCellY = std::min(minCellY, cellY);
+                maxCellX = std::max(maxCellX, cellX);
+                maxCellY = std::max(maxCellY, cellY);
+            }
+        }
+
+        void SpatialIndex::Remove(SpatialItem item) {
+            if (FindLocation(item) == nullptr) {
+                return;
+            }
+
+            Location& location = GetLocation(item);
+            std::unordered_map<uint64_t, std::vector<Entry>>::iterator cell = cells.find(location.cell);
+            std::vector<Entry>& entries = cell->second;
+
+            // The last entry of the cell takes the free slot
+            if (location.slot + 1 != entries.size()) {
+                entries[location.slot] = entries.back();
+                GetLocation(entries[location.slot].item).slot = location.slot;
+            }
+            entries.pop_back();
+
+            if (entries.empty()) {
+                cells.erase(cell);
+            }
+
+            location.isIndexed = false;
+            itemCount--;
+        }
+
+        std::vector<SpatialItem> SpatialIndex::QueryRectangle(Vector2 corner, Vector2 oppositeCorner) const {
+            std::vector<SpatialItem> items;
+            Vector2 minimum = { std::min(corner.x, oppositeCorner.x), std::min(corner.y, oppositeCorner.y) };
+            Vector2 maximum = { std::max(corner.x, oppositeCorner.x), std::max(corner.y, oppositeCorner.y) };
+
+            auto addInside = [&](const std::vector<Entry>& entries) {
+                for (const Entry& entry : entries) {
+                    if (entry.position.x >= minimum.x && entry.position.x <= maximum.x && entry.position.y >= minimum.y && entry.position.y <= maximum.y) {
+                        items.push_back(entry.item);
+                    }
+                }
+            };
+
+            int firstX = std::max(CellCoordinate(minimum.x), minCellX);
+            int firstY = std::max(CellCoordinate(minimum.y), minCellY);
+            int lastX = std::min(CellCoordinate(maximum.x), maxCellX);
+            int lastY = std::min(CellCoordinate(maximum.y), maxCellY);
+
+            if (firstX > lastX || firstY > lastY) {
+                return items;
+            }
+
+            // A rectangle larger than the occupied cells is cheaper to answer from the cells themselves
+            double rectangleCells = ((double)lastX - firstX + 1) * ((double)lastY - firstY + 1);
+            if (rectangleCells > (double)cells.size()) {
+                for (const std::pair<const uint64_t, std::vector<Entry>>& cell : cells) {
+                    addInside(cell.second);
+                }
+                return items;
+            }
+
+            for (int x = firstX; x <= lastX; x++) {
+                for (int y = firstY; y <= lastY; y++) {
+                    std::unordered_map<uint64_t, std::vector<Entry>>::const_iterator cell = cells.find(CellKey(x, y));
+                    if (cell != cells.end()) addInside(cell->second);
+                }
+            }
+
+            return items;
+        }
+
+        bool SpatialIndex::FindNearest(Vector2 point, WorkspaceBuilder::Enums::SpatialItemKind kind, SpatialItem& nearest) const {
+            double bestDistance = std::numeric_limits<double>::infinity();
+            bool isFound = false;
+
+            auto checkCell = [&](const std::vector<Entry>& entries) {
+                for (const Entry& entry : entries) {
+                    if (entry.item.kind != kind) continue;
+
+                    double dx = (double)entry.position.x - point.x;
+                    double dy = (double)entry.position.y - point.y;
+                    double distance = dx * dx + dy * dy;
+
+                    if (!isFound || distance < bestDistance) {
+                        bestDistance = distance;
+                        nearest = entry.item;
+                        isFound = true;
+                    }
+                }
+            };
+
+            auto checkCellAt = [&](int x, int y) {
+                std::unordered_map<uint64_t, std::vector<Entry>>::const_iterator cell = cells.find(CellKey(x, y));
+                if (cell != cells.end()) checkCell(cell->second);
+            };
+
+            if (itemCount == 0) {
+                return false;
+            }
+
+            int centerX = CellCoordinate(point.x);
+            int centerY = CellCoordinate(point.y);
+
+            // Rings of cells around the point. After ring r every item not seen is at least r cells away
+            for (int ring = 0; ; ring++) {
+                // Searching far rings costs more than looking at every occupied cell once
+                double searchedCells = (2.0 * ring + 1.0) * (2.0 * ring + 1.0);
+                if (searchedCells > 2.0 * (double)cells.size()) {
+                    for (const std::pair<const uint64_t, std::vector<Entry>>& cell : cells) {
+                        checkCell(cell.second);
+                    }
+                    return isFound;
+                }
+
+                if (ring == 0) {
+                    checkCellAt(centerX, centerY);
+                }
+                else {
+                    for (int x = centerX - ring; x <= centerX + ring; x++) {
+                        checkCellAt(x, centerY - ring);
+                        checkCellAt(x, centerY + ring);
+                    }
+                    for (int y = centerY - ring + 1; y <= centerY + ring - 1; y++) {
+                        checkCellAt(centerX - ring, y);
+                        checkCellAt(centerX + ring, y);
+                    }
+                }
+
+                double searchedDistance = (double)ring * cellSize;
+                if (isFound && bestDistance <= searchedDistance * searchedDistance) {
+                    return true;
+                }
+
+                // Every occupied cell was searched
+                if (centerX - ring <= minCellX && centerX + ring >= maxCellX && centerY - ring <= minCellY && centerY + ring >= maxCellY) {
+                    return isFound;
+                }
+            }
+        }
+    }
+
+    namespace Functions {
+
+        WorkspaceBuilder::Structs::SpatialIndex BuildSpatialIndex(const WorkspaceBuilder::Structs::Workflow& workflow, float cellSize) {
+            WorkspaceBuilder::Structs::SpatialIndex index(cellSize);
+
+            for (size_t i = 0; i < workflow.blocks.size(); i++) {
+                index.Insert({ WorkspaceBuilder::Enums::SpatialItemKind::BlockItem, (int)i }, workflow.blocks[i].position);
+            }
+
+            for (size_t i = 0; i < workflow.comments.size(); i++) {
+                index.Insert({ WorkspaceBuilder::Enums::SpatialItemKind::CommentItem, (int)i }, workflow.comments[i].position);
+            }
+
+            return index;
+        }
+    }
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include <cstdint>
+#include <unordered_map>
+
+namespace WorkspaceBuilder {
+    #pragma region Enums
+    namespace Enums {
+        // What a spatial index item refers to
+        enum SpatialItemKind {
+            // A position in Workflow::blocks
+            BlockItem,
+            // A position in Workflow::comments
+            CommentItem
+        };
+    }
+    #pragma endregion
+
+    #pragma region Structs
+    namespace Structs {
+        // A block or a comment stored in a spatial index
+        struct SpatialItem {
+            WorkspaceBuilder::Enums::SpatialItemKind kind;
+            // Position in Workflow::blocks or Workflow::comments
+            int index;
+        };
+
+        // Uniform grid over the positions of the blocks and comments of a workflow.
+        //   Only the occupied cells are stored, so the canvas can be as large as needed.
+        //   Items are points: to find glyphs that touch a viewport, grow the viewport by the glyph size.
+        class SpatialIndex {
+        public:
+            /**
+            * Creates an empty index
+            *
+            * @param cellSize: Width and height of a grid cell. About the size of a glyph works well
+            *
+            * @throws The cell size must be positive> if cellSize is zero, negative or not a number
+            */
+            explicit SpatialIndex(float cellSize = 128.0f);
+
+            /**
+            * Adds an item. An item that is already in the index is moved instead
+            *
+            * @param item: The block or comment
+            * @param position: Its position in the grid
+            */
+            void Insert(SpatialItem item, Vector2 position);
+
+            /**
+            * Moves an item to a new position. Only the two cells involved are touched
+            *
+            * @param item: The block or comment
+            * @param position: Its new position
+            */
+            void Move(SpatialItem item, Vector2 position) { Insert(item, position); }
+
+            /**
+            * Removes an item. Nothing happens when it isn't in the index
+            *
+            * @param item: The block or comment
+            */
+            void Remove(SpatialItem item);
+
+            /**
+            * Finds the items inside a rectangle, borders included. Used by viewport queries and box selection
+            *
+            * @param corner: A corner of the rectangle
+            * @param oppositeCorner: The opposite corner, in any direction
+            * @return The items found, in no particular order
+            */
+            std::vector<SpatialItem> QueryRectangle(Vector2 corner, Vector2 oppositeCorner) const;
+
+            /**
+            * Finds the item of a kind closest to a point
+            *
+            * @param point: The point, like the cursor position
+            * @param kind: The kind of item wanted
+            * @param nearest: Receives the item found
+            * @return False when the index has no item of that kind
+            */
+            bool FindNearest(Vector2 point, WorkspaceBuilder::Enums::SpatialItemKind kind, SpatialItem& nearest) const;
+
+            // Number of items in the index
+            size_t Size() const { return itemCount; }
+            // Width and height of a grid cell
+            float CellSize() const { return cellSize; }
+
+        private:
+            // An item and its position, so queries don't need the workflow
+            struct Entry {
+                SpatialItem item;
+                Vector2 position;
+            };
+
+            // Where an item is stored. cell is the cell key and slot the position in its vector
+            struct Location {
+                bool isIndexed = false;
+                uint64_t cell = 0;
+                uint32_t slot = 0;
+            };
+
+            int CellCoordinate(float value) const;
+            static uint64_t CellKey(int x, int y);
+            Location& GetLocation(SpatialItem item);
+            const Location* FindLocation(SpatialItem item) const;
+
+            float cellSize;
+            size_t itemCount = 0;
+            std::unordered_map<uint64_t, std::vector<Entry>> cells;
+            // Location of each item by kind and index
+            std::vector<Location> blockLocations;
+            std::vector<Location> commentLocations;
+            // Smallest rectangle of cells that ever held an item. It bounds the nearest neighbour search
+            int minCellX = 0;
+            int minCellY = 0;
+            int maxCellX = -1;
+            int maxCellY = -1;
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Indexes the positions of every block and comment of a workflow
+        *
+        * @param workflow: The workflow
+        * @param cellSize: Width and height of a grid cell
+        * @return The spatial index. It must be kept up to date with Move, Insert and Remove when the workflow changes
+        *
+        * @throws The cell size must be positive> if cellSize is zero, negative or not a number
+        */
+        WorkspaceBuilder::Structs::SpatialIndex BuildSpatialIndex(const WorkspaceBuilder::Structs::Workflow& workflow, float cellSize = 128.0f);
+    }
+    #pragma endregion
+}
@@ -0,0 +1,125 @@
+#include "SymbolTable.h"
+
+#include <cctype>
+
+namespace WorkspaceBuilder {
+    namespace Structs {
+
+        SymbolId SymbolTable::Intern(std::string_view text) {
+            auto found = ids.find(text);
+
+            if (found != ids.end()) {
+                return found->second;
+            }
+
+            SymbolId id = (SymbolId)names.size();
+            names.emplace_back(text);
+            ids.emplace(std::string_view(names.back()), id);
+
+            return id;
+        }
+
+        SymbolId SymbolTable::InternLower(std::string_view text) {
+            auto found = lowerIds.find(text);
+
+            if (found != lowerIds.end()) {
+                return found->second;
+            }
+
+            size_t i = 0;
+            while (i < text.size() && !isupper((unsigned char)text[i])) {
+                i++;
+            }
+
+            // Already in lower case, it is its own lower case key
+            if (i == text.size()) {
+                SymbolId id = Intern(text);
+                lowerIds.emplace(Name(id), id);
+                return id;
+            }
+
+            std::string& original = lowerKeys.emplace_back(text);
+            std::string lowerText(text.size(), '\0');
+            WorkspaceBuilder::SupportFunctions::ToLower(text, &lowerText[0]);
+
+            SymbolId id = Intern(lowerText);
+            lowerIds.emplace(std::string_view(original), id);
+
+            return id;
+        }
+
+        SymbolId SymbolTable::Find(std::string_view text) const {
+            auto found = ids.find(text);
+
+            return found != ids.end() ? found->second : InvalidSymbol;
+        }
+    }
+
+    namespace Functions {
+
+        WorkspaceBuilder::Structs::WorkflowSymbols InternWorkflow(const WorkspaceBuilder::Structs::Workflow& workflow) {
+            WorkspaceBuilder::Structs::WorkflowSymbols symbols;
+
+            symbols.blockTypes.reserve(workflow.blocks.size());
+            symbols.blockHostMachines.reserve(workflow.blocks.size());
+            for (const WorkspaceBuilder::Structs::Block& block : workflow.blocks) {
+                symbols.blockTypes.push_back(symbols.table.Intern(block.type));
+                symbols.blockHostMachines.push_back(symbols.table.Intern(block.hostMachine));
+            }
+
+            // Connection ports are already in lower case
+            symbols.connectionOutputs.reserve(workflow.connections.size());
+            symbols.connectionInputs.reserve(workflow.connections.size());
+            for (const WorkspaceBuilder::Structs::Connection& connection : workflow.connections) {
+                symbols.connectionOutputs.push_back(symbols.table.Intern(connection.outputStartBlock));
+                symbols.connectionInputs.push_back(symbols.table.Intern(connection.inputEndBlock));
+            }
+
+            return symbols;
+        }
+
+        WorkspaceBuilder::Structs::WorkflowSymbols InternWorkflowView(const WorkspaceBuilder::Structs::WorkflowView& workflow) {
+            WorkspaceBuilder::Structs::WorkflowSymbols symbols;
+
+            symbols.blockTypes.reserve(workflow.blocks.size());
+            symbols.blockHostMachines.reserve(workflow.blocks.size());
+            for (const WorkspaceBuilder::Structs::BlockView& block : workflow.blocks) {
+                symbols.blockTypes.push_back(symbols.table.Intern(block.type));
+                symbols.blockHostMachines.push_back(symbols.table.Intern(block.hostMachine));
+            }
+
+            symbols.connectionOutputs.reserve(workflow.connections.size());
+            symbols.connectionInputs.reserve(workflow.connections.size());
+            for (const WorkspaceBuilder::Structs::ConnectionView& connection : workflow.connections) {
+                symbols.connectionOutputs.push_back(symbols.table.InternLower(connection.outputStartBlock));
+                symbols.connectionInputs.push_back(symbols.table.InternLower(connection.inputEndBlock));
+            }
+
+            return symbols;
+        }
+
+        // Connections of the same port are next to each other because the ranges are sorted by port name
+        static WorkspaceBuilder::Structs::ConnectionRange FindPortRange(WorkspaceBuilder::Structs::ConnectionRange range, const std::vector<WorkspaceBuilder::Structs::SymbolId>& ports, WorkspaceBuilder::Structs::SymbolId port) {
+            const int* first = range.first;
+
+            while (first != range.last && ports[*first] != port) {
+                first++;
+            }
+
+            const int* last = first;
+            while (last != range.last && ports[*last] == port) {
+                last++;
+            }
+
+            return { first, last };
+        }
+
+        WorkspaceBuilder::Structs::ConnectionRange GetOutgoingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::WorkflowSymbols& symbols, int blockIndex, WorkspaceBuilder::Structs::SymbolId output) {
+            return FindPortRange(GetOutgoingConnections(graph, blockIndex), symbols.connectionOutputs, output);
+        }
+
+        WorkspaceBuilder::Structs::ConnectionRange GetIncomingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::WorkflowSymbols& symbols, int blockIndex, WorkspaceBuilder::Structs::SymbolId input) {
+            return FindPortRange(GetIncomingConnections(graph, blockIndex), symbols.connectionInputs, input);
+        }
+    }
+}
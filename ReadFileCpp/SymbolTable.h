@@ -0,0 +1,127 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include "WorkflowGraph.h"
+#include "WorkflowView.h"
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // Small integer that stands for an interned string
+        typedef uint32_t SymbolId;
+
+        // Workflow wide table of interned strings. Equal strings get the same id, so they can be compared and hashed as integers.
+        //   Ids are given in order starting at 0 and never change while the table lives.
+        class SymbolTable {
+        public:
+            // Id returned when a string is not in the table
+            static constexpr SymbolId InvalidSymbol = UINT32_MAX;
+
+            SymbolTable() = default;
+            // A copy would keep the lookup keys pointing to the strings of the original table
+            SymbolTable(const SymbolTable&) = delete;
+            SymbolTable& operator=(const SymbolTable&) = delete;
+            SymbolTable(SymbolTable&&) = default;
+            SymbolTable& operator=(SymbolTable&&) = default;
+
+            /**
+            * Gets the id of a string, adding it to the table when it is new
+            *
+            * @param text: The string to be interned
+            * @return The string id
+            */
+            SymbolId Intern(std::string_view text);
+
+            /**
+            * Gets the id of the lower case version of a string, adding it to the table when it is new.
+            *   The id is remembered by the original text, so a repeated port name is found with one lookup and
+            *   only a name with upper case letters that was never seen is lowered.
+            *
+            * @param text: The string to be interned
+            * @return The id of the string in lower case
+            */
+            SymbolId InternLower(std::string_view text);
+
+            /**
+            * Looks up a string without adding it
+            *
+            * @param text: The string to be found
+            * @return The string id or InvalidSymbol
+            */
+            SymbolId Find(std::string_view text) const;
+
+            // The string of an id. The view stays valid while the table lives
+            std::string_view Name(SymbolId id) const { return names[id]; }
+            // Number of interned strings
+            size_t Size() const { return names.size(); }
+
+        private:
+            // A deque never moves its elements, so the keys of ids keep pointing to valid strings
+            std::deque<std::string> names;
+            std::unordered_map<std::string_view, SymbolId> ids;
+            // Texts given to InternLower that had upper case letters, the keys of lowerIds point to them or to names
+            std::deque<std::string> lowerKeys;
+            // Id of the lower case version of each text given to InternLower
+            std::unordered_map<std::string_view, SymbolId> lowerIds;
+        };
+
+        // The repeated strings of a workflow as symbols. The vectors follow the order of Workflow::blocks and Workflow::connections.
+        struct WorkflowSymbols {
+            SymbolTable table;
+            // Block::type of every block
+            std::vector<SymbolId> blockTypes;
+            // Block::hostMachine of every block
+            std::vector<SymbolId> blockHostMachines;
+            // Connection::outputStartBlock of every connection, in lower case
+            std::vector<SymbolId> connectionOutputs;
+            // Connection::inputEndBlock of every connection, in lower case
+            std::vector<SymbolId> connectionInputs;
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Interns the glyph types, host machines and port names of a workflow
+        *
+        * @param workflow: The workflow
+        * @return The symbol table and the symbol of each block and connection
+        */
+        WorkspaceBuilder::Structs::WorkflowSymbols InternWorkflow(const WorkspaceBuilder::Structs::Workflow& workflow);
+
+        /**
+        * Interns the glyph types, host machines and port names of a workflow view.
+        *   The port names are lowered only when they are first seen.
+        *
+        * @param workflow: The workflow view
+        * @return The symbol table and the symbol of each block and connection
+        */
+        WorkspaceBuilder::Structs::WorkflowSymbols InternWorkflowView(const WorkspaceBuilder::Structs::WorkflowView& workflow);
+
+        /**
+        * Connections that start in a given output of a block, comparing symbols instead of names
+        *
+        * @param graph: The workflow graph
+        * @param symbols: The symbols of the indexed workflow
+        * @param blockIndex: The block position in Workflow::blocks
+        * @param output: The output name symbol
+        * @return The connection positions
+        */
+        WorkspaceBuilder::Structs::ConnectionRange GetOutgoingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::WorkflowSymbols& symbols, int blockIndex, WorkspaceBuilder::Structs::SymbolId output);
+
+        /**
+        * Connections that finish in a given input of a block, comparing symbols instead of names
+        *
+        * @param graph: The workflow graph
+        * @param symbols: The symbols of the indexed workflow
+        * @param blockIndex: The block position in Workflow::blocks
+        * @param input: The input name symbol
+        * @return The connection positions
+        */
+        WorkspaceBuilder::Structs::ConnectionRange GetIncomingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::WorkflowSymbols& symbols, int blockIndex, WorkspaceBuilder::Structs::SymbolId input);
+    }
+    #pragma endregion
+}
@@ -0,0 +1,146 @@
+#include "TypedParameters.h"
+
+#include <charconv>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WORKSPACE_BUILDER_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        // Position of the lowest set bit of a mask that is not 0
+        static unsigned int LowestSetBit(unsigned int mask) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return (unsigned int)index;
+#else
+            return (unsigned int)__builtin_ctz(mask);
+#endif
+        }
+
+        static bool IsListSeparator(char character) {
+            return character == ',' || character == ' ' || character == '\t';
+        }
+
+        // Position of the first list separator at or after start, or end
+        static size_t FindListSeparator(const char* text, size_t start, size_t end) {
+            size_t i = start;
+
+#ifdef WORKSPACE_BUILDER_SSE2
+            const __m128i comma = _mm_set1_epi8(',');
+            const __m128i space = _mm_set1_epi8(' ');
+            const __m128i tab = _mm_set1_epi8('\t');
+
+            // 16 characters are tested at a time, bit n of the mask is set when text[i + n] is a separator
+            for (; i + 16 <= end; i += 16) {
+                __m128i chunk = _mm_loadu_si128((const __m128i*)(text + i));
+                __m128i separators = _mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)));
+                unsigned int mask = (unsigned int)_mm_movemask_epi8(separators);
+
+                if (mask != 0) {
+                    return i + LowestSetBit(mask);
+                }
+            }
+#endif
+
+            // Scalar tail, also the whole search when SSE2 is missing
+            for (; i < end; i++) {
+                if (IsListSeparator(text[i])) return i;
+            }
+
+            return end;
+        }
+
+        bool ParseNumberArray(std::string_view text, std::vector<double>& numbers) {
+            if (text.size() < 2 || text.front() != '[' || text.back() != ']') {
+                return false;
+            }
+
+            const char* data = text.data();
+            size_t position = 1;
+            size_t end = text.size() - 1;
+            bool isNumberExpected = true;
+            size_t firstNumber = numbers.size();
+
+            while (position < end) {
+                char character = data[position];
+
+                if (character == ' ' || character == '\t') {
+                    position++;
+                }
+                else if (character == ',') {
+                    // A comma must follow a number
+                    if (isNumberExpected) return false;
+
+                    isNumberExpected = true;
+                    position++;
+                }
+                else {
+                    // Two numbers must be separated by a comma
+                    if (!isNumberExpected) return false;
+
+                    size_t numberEnd = FindListSeparator(data, position, end);
+                    double value = 0;
+                    std::from_chars_result result = std::from_chars(data + position, data + numberEnd, value);
+
+                    if (result.ec != std::errc() || result.ptr != data + numberEnd) {
+                        return false;
+                    }
+
+                    numbers.push_back(value);
+                    isNumberExpected = false;
+                    position = numberEnd;
+                }
+            }
+
+            // A trailing comma is not valid, an empty list is
+            return !isNumberExpected || numbers.size() == firstNumber;
+        }
+
+        WorkspaceBuilder::Structs::ParameterValue ParseParameterValue(std::string_view text, WorkspaceBuilder::Enums::VariableType type) {
+            WorkspaceBuilder::Structs::ParameterValue parameter;
+            const char* textEnd = text.data() + text.size();
+
+            // Quoted values are always strings
+            if (type != WorkspaceBuilder::Enums::VariableType::String && !text.empty()) {
+                if (text[0] == '[') {
+                    if (ParseNumberArray(text, parameter.doubleArray)) {
+                        parameter.type = WorkspaceBuilder::Enums::ParameterType::NumberArrayParameter;
+                        return parameter;
+                    }
+                    parameter.doubleArray.clear();
+                }
+                else {
+                    std::from_chars_result integerResult = std::from_chars(text.data(), textEnd, parameter.integerValue);
+                    if (integerResult.ec == std::errc() && integerResult.ptr == textEnd) {
+                        parameter.type = WorkspaceBuilder::Enums::ParameterType::IntegerParameter;
+                        return parameter;
+                    }
+                    parameter.integerValue = 0;
+
+                    std::from_chars_result doubleResult = std::from_chars(text.data(), textEnd, parameter.doubleValue);
+                    if (doubleResult.ec == std::errc() && doubleResult.ptr == textEnd) {
+                        parameter.type = WorkspaceBuilder::Enums::ParameterType::DoubleParameter;
+                        return parameter;
+                    }
+                    parameter.doubleValue = 0.0;
+                }
+            }
+
+            parameter.type = WorkspaceBuilder::Enums::ParameterType::StringParameter;
+
+            return parameter;
+        }
+
+        void GetFloatArray(const WorkspaceBuilder::Structs::ParameterValue& parameter, std::vector<float>& numbers) {
+            // assign keeps the capacity of the buffer, a kernel run in a loop allocates only the first time
+            numbers.assign(parameter.doubleArray.begin(), parameter.doubleArray.end());
+        }
+    }
+}
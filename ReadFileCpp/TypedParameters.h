@@ -0,0 +1,37 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include <cstdint>
+
+namespace WorkspaceBuilder {
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Decodes a numeric list like '[1, 2.5, -3e-2]'. Uses SSE2 to find the number limits when available.
+        *
+        * @param text: The list text including the brackets
+        * @param numbers: The list where the numbers are appended
+        * @return True if the whole text is a valid numeric list. When false numbers may hold part of the list
+        */
+        bool ParseNumberArray(std::string_view text, std::vector<double>& numbers);
+
+        /**
+        * Decodes a variable value into integer, double, string or numeric list. ConvertVariableViewToVariable calls it for
+        *   every variable, so Variable::parameter already holds the result
+        *
+        * @param value: The variable text, without the quotes of a string
+        * @param type: The variable type found by the parser. String values are never decoded as numbers
+        * @return The decoded value. Values that are not numbers are StringParameter and their text is the variable value
+        */
+        WorkspaceBuilder::Structs::ParameterValue ParseParameterValue(std::string_view value, WorkspaceBuilder::Enums::VariableType type);
+
+        /**
+        * Converts a numeric list parameter to float, the type of the VGL kernels. Only the double list is stored
+        *   so the conversion is made when a kernel asks for it
+        *
+        * @param parameter: A NumberArrayParameter, like the Variable::parameter of a list
+        * @param numbers: Receives the numbers as floats, empty for the other parameter types. Reuse it between calls to keep its memory
+        */
+        void GetFloatArray(const WorkspaceBuilder::Structs::ParameterValue& parameter, std::vector<float>& numbers);
+    }
+    #pragma endregion
+}
@@ -0,0 +1,282 @@
+#include "WorkflowDiff.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        static bool IsSameVariable(const WorkspaceBuilder::Structs::Variable& a, const WorkspaceBuilder::Structs::Variable& b) {
+            return a.key == b.key && a.value == b.value && a.type == b.type;
+        }
+
+        static bool IsSamePosition(WorkspaceBuilder::Structs::Vector2 a, WorkspaceBuilder::Structs::Vector2 b) {
+            return a.x == b.x && a.y == b.y;
+        }
+
+        // Inputs and outputs have the same fields
+        template <typename Port>
+        static bool IsSamePorts(const std::vector<Port>& a, const std::vector<Port>& b) {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Port& first, const Port& second) {
+                return first.name == second.name && first.type == second.type;
+            });
+        }
+
+        static bool IsSameBlock(const WorkspaceBuilder::Structs::Block& a, const WorkspaceBuilder::Structs::Block& b) {
+            return a.id == b.id && a.type == b.type && a.hostMachine == b.hostMachine && IsSamePosition(a.position, b.position)
+                && std::equal(a.variables.begin(), a.variables.end(), b.variables.begin(), b.variables.end(), IsSameVariable)
+                && IsSamePorts(a.inputs, b.inputs) && IsSamePorts(a.outputs, b.outputs);
+        }
+
+        // Ids are compared apart, they move when connections before them are added or removed
+        static bool IsSameConnection(const WorkspaceBuilder::Structs::Connection& a, const WorkspaceBuilder::Structs::Connection& b) {
+            return a.startBlock == b.startBlock && a.endBlock == b.endBlock && a.outputStartBlock == b.outputStartBlock && a.inputEndBlock == b.inputEndBlock;
+        }
+
+        // Lines are compared apart, they move when lines before them are added or removed
+        static bool IsSameComment(const WorkspaceBuilder::Structs::Comment& a, const WorkspaceBuilder::Structs::Comment& b) {
+            return a.text == b.text && IsSamePosition(a.position, b.position);
+        }
+
+        // Block position by id. Every id must be unique
+        static std::unordered_map<int, size_t> IndexBlocks(const std::vector<WorkspaceBuilder::Structs::Block>& blocks, const char* functionName) {
+            std::unordered_map<int, size_t> index;
+            index.reserve(blocks.size());
+
+            for (size_t i = 0; i < blocks.size(); i++) {
+                if (!index.emplace(blocks[i].id, i).second) {
+                    throw std::runtime_error(std::string(functionName) + " error >> Block id " + std::to_string(blocks[i].id) + " is repeated");
+                }
+            }
+
+            return index;
+        }
+
+        // Finds the range between the common prefix and the common suffix of two vectors.
+        //   keyOf gives the number that moves with the edit. The prefix must keep it and the suffix must move it by the same shift
+        template <typename Element, typename IsSame, typename KeyOf>
+        static WorkspaceBuilder::Structs::RangeChange<Element> DiffRange(const std::vector<Element>& oldElements, const std::vector<Element>& newElements, IsSame isSame, KeyOf keyOf, int& shift) {
+            WorkspaceBuilder::Structs::RangeChange<Element> change;
+            size_t common = std::min(oldElements.size(), newElements.size());
+            size_t prefix = 0;
+            size_t suffix = 0;
+
+            while (prefix < common && isSame(oldElements[prefix], newElements[prefix]) && keyOf(oldElements[prefix]) == keyOf(newElements[prefix])) {
+                prefix++;
+            }
+
+            shift = 0;
+            if (prefix < common) {
+                shift = keyOf(newElements.back()) - keyOf(oldElements.back());
+
+                while (suffix < common - prefix) {
+                    const Element& oldElement = oldElements[oldElements.size() - 1 - suffix];
+                    const Element& newElement = newElements[newElements.size() - 1 - suffix];
+
+                    if (!isSame(oldElement, newElement) || keyOf(newElement) - keyOf(oldElement) != shift) break;
+                    suffix++;
+                }
+            }
+
+            // Nothing comes after the range
+            if (suffix == 0) shift = 0;
+
+            change.first = prefix;
+            change.removedCount = oldElements.size() - prefix - suffix;
+            change.inserted.assign(newElements.begin() + prefix, newElements.end() - suffix);
+
+            return change;
+        }
+
+        // True when the replaced range of a change is inside the vector
+        template <typename Element>
+        static bool IsRangeInside(const std::vector<Element>& elements, const WorkspaceBuilder::Structs::RangeChange<Element>& change) {
+            return change.first <= elements.size() && change.removedCount <= elements.size() - change.first;
+        }
+
+        // Replaces a range and moves the key of the elements after it. The range was checked with IsRangeInside
+        template <typename Element, typename ShiftKey>
+        static void ApplyRange(std::vector<Element>& elements, const WorkspaceBuilder::Structs::RangeChange<Element>& change, int shift, ShiftKey shiftKey) {
+            size_t common = std::min(change.removedCount, change.inserted.size());
+
+            std::copy(change.inserted.begin(), change.inserted.begin() + common, elements.begin() + change.first);
+
+            if (change.removedCount > common) {
+                elements.erase(elements.begin() + (change.first + common), elements.begin() + (change.first + change.removedCount));
+            }
+            else if (change.inserted.size() > common) {
+                elements.insert(elements.begin() + (change.first + common), change.inserted.begin() + common, change.inserted.end());
+            }
+
+            if (shift != 0) {
+                for (size_t i = change.first + change.inserted.size(); i < elements.size(); i++) {
+                    shiftKey(elements[i], shift);
+                }
+            }
+        }
+
+        WorkspaceBuilder::Structs::WorkflowDiff DiffWorkflows(const WorkspaceBuilder::Structs::Workflow& oldWorkflow, const WorkspaceBuilder::Structs::Workflow& newWorkflow) {
+            WorkspaceBuilder::Structs::WorkflowDiff diff;
+            std::unordered_map<int, size_t> oldIndex = IndexBlocks(oldWorkflow.blocks, "DiffWorkflows");
+            std::unordered_map<int, size_t> newIndex = IndexBlocks(newWorkflow.blocks, "DiffWorkflows");
+
+            // Blocks by id
+            std::vector<int> oldKeptOrder;
+            for (const WorkspaceBuilder::Structs::Block& block : oldWorkflow.blocks) {
+                if (newIndex.count(block.id) == 0) {
+                    diff.removedBlocks.push_back(block.id);
+                }
+                else {
+                    oldKeptOrder.push_back(block.id);
+                }
+            }
+
+            std::vector<int> newKeptOrder;
+            for (size_t i = 0; i < newWorkflow.blocks.size(); i++) {
+                const WorkspaceBuilder::Structs::Block& block = newWorkflow.blocks[i];
+                std::unordered_map<int, size_t>::const_iterator oldBlock = oldIndex.find(block.id);
+
+                if (oldBlock == oldIndex.end()) {
+                    diff.addedBlocks.push_back({ i, block });
+                    continue;
+                }
+
+                newKeptOrder.push_back(block.id);
+                if (!IsSameBlock(oldWorkflow.blocks[oldBlock->second], block)) {
+                    diff.modifiedBlocks.push_back(block);
+                }
+            }
+
+            if (oldKeptOrder != newKeptOrder) {
+                diff.blockOrder.reserve(newWorkflow.blocks.size());
+                for (const WorkspaceBuilder::Structs::Block& block : newWorkflow.blocks) {
+                    diff.blockOrder.push_back(block.id);
+                }
+            }
+
+            diff.connections = DiffRange(oldWorkflow.connections, newWorkflow.connections, IsSameConnection,
+                [](const WorkspaceBuilder::Structs::Connection& connection) { return connection.id; }, diff.connectionIdShift);
+
+            int globalVariableShift = 0;
+            diff.globalVariables = DiffRange(oldWorkflow.globalVariables, newWorkflow.globalVariables, IsSameVariable,
+                [](const WorkspaceBuilder::Structs::Variable&) { return 0; }, globalVariableShift);
+
+            diff.comments = DiffRange(oldWorkflow.comments, newWorkflow.comments, IsSameComment,
+                [](const WorkspaceBuilder::Structs::Comment& comment) { return comment.line; }, diff.commentLineShift);
+
+            return diff;
+        }
+
+        // Throws when a block id of the diff doesn't exist in the workflow, or would be repeated after the diff
+        static void CheckBlockChanges(const std::unordered_map<int, size_t>& index, const WorkspaceBuilder::Structs::WorkflowDiff& diff) {
+            for (const WorkspaceBuilder::Structs::Block& block : diff.modifiedBlocks) {
+                if (index.count(block.id) == 0) {
+                    throw std::runtime_error("ApplyWorkflowDiff error >> Block " + std::to_string(block.id) + " doesn't exist");
+                }
+            }
+
+            std::unordered_set<int> removed;
+            for (int id : diff.removedBlocks) {
+                if (index.count(id) == 0 || !removed.insert(id).second) {
+                    throw std::runtime_error("ApplyWorkflowDiff error >> Block " + std::to_string(id) + " doesn't exist");
+                }
+            }
+
+            // Ids of the blocks after the diff
+            std::unordered_set<int> ids;
+            ids.reserve(index.size() - removed.size() + diff.addedBlocks.size());
+            for (const std::pair<const int, size_t>& block : index) {
+                if (removed.count(block.first) == 0) ids.insert(block.first);
+            }
+            for (const WorkspaceBuilder::Structs::AddedBlock& added : diff.addedBlocks) {
+                if (!ids.insert(added.block.id).second) {
+                    throw std::runtime_error("ApplyWorkflowDiff error >> Block id " + std::to_string(added.block.id) + " is repeated");
+                }
+            }
+
+            if (diff.blockOrder.empty()) return;
+
+            // The order names every block once
+            if (diff.blockOrder.size() != ids.size()) {
+                throw std::runtime_error("ApplyWorkflowDiff error >> Block order doesn't match the blocks");
+            }
+            for (int id : diff.blockOrder) {
+                if (ids.erase(id) == 0) {
+                    throw std::runtime_error("ApplyWorkflowDiff error >> Block " + std::to_string(id) + " doesn't exist");
+                }
+            }
+        }
+
+        void ApplyWorkflowDiff(WorkspaceBuilder::Structs::Workflow& workflow, const WorkspaceBuilder::Structs::WorkflowDiff& diff) {
+            std::vector<WorkspaceBuilder::Structs::Block>& blocks = workflow.blocks;
+            bool isBlockChanged = !diff.removedBlocks.empty() || !diff.modifiedBlocks.empty() || !diff.addedBlocks.empty() || !diff.blockOrder.empty();
+            std::unordered_map<int, size_t> index;
+
+            // Everything is checked before the workflow is touched, so a diff that doesn't fit leaves it unchanged
+            if (isBlockChanged) {
+                index = IndexBlocks(blocks, "ApplyWorkflowDiff");
+                CheckBlockChanges(index, diff);
+            }
+
+            if (!IsRangeInside(workflow.connections, diff.connections) || !IsRangeInside(workflow.globalVariables, diff.globalVariables)
+                || !IsRangeInside(workflow.comments, diff.comments)) {
+                throw std::runtime_error("ApplyWorkflowDiff error >> Range is out of the workflow");
+            }
+
+            if (isBlockChanged) {
+                for (const WorkspaceBuilder::Structs::Block& block : diff.modifiedBlocks) {
+                    blocks[index.find(block.id)->second] = block;
+                }
+
+                if (!diff.removedBlocks.empty()) {
+                    std::unordered_set<int> removed(diff.removedBlocks.begin(), diff.removedBlocks.end());
+
+                    blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [&](const WorkspaceBuilder::Structs::Block& block) {
+                        return removed.count(block.id) != 0;
+                    }), blocks.end());
+                }
+
+                // Kept blocks fill the positions between the added ones
+                if (!diff.addedBlocks.empty()) {
+                    std::vector<WorkspaceBuilder::Structs::Block> merged;
+                    merged.reserve(blocks.size() + diff.addedBlocks.size());
+                    size_t kept = 0;
+
+                    for (const WorkspaceBuilder::Structs::AddedBlock& added : diff.addedBlocks) {
+                        while (merged.size() < added.position && kept < blocks.size()) {
+                            merged.push_back(std::move(blocks[kept++]));
+                        }
+                        merged.push_back(added.block);
+                    }
+                    while (kept < blocks.size()) {
+                        merged.push_back(std::move(blocks[kept++]));
+                    }
+
+                    blocks = std::move(merged);
+                }
+
+                if (!diff.blockOrder.empty()) {
+                    std::unordered_map<int, size_t> current = IndexBlocks(blocks, "ApplyWorkflowDiff");
+                    std::vector<WorkspaceBuilder::Structs::Block> ordered;
+                    ordered.reserve(diff.blockOrder.size());
+
+                    for (int id : diff.blockOrder) {
+                        ordered.push_back(std::move(blocks[current.find(id)->second]));
+                    }
+
+                    blocks = std::move(ordered);
+                }
+            }
+
+            ApplyRange(workflow.connections, diff.connections, diff.connectionIdShift,
+                [](WorkspaceBuilder::Structs::Connection& connection, int shift) { connection.id += shift; });
+
+            ApplyRange(workflow.globalVariables, diff.globalVariables, 0,
+                [](WorkspaceBuilder::Structs::Variable&, int) {});
+
+            ApplyRange(workflow.comments, diff.comments, diff.commentLineShift,
+                [](WorkspaceBuilder::Structs::Comment& comment, int shift) { comment.line += shift; });
+        }
+    }
+}
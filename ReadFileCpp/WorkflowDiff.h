@@ -0,0 +1,86 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // A block that didn't exist in the old workflow
+        struct AddedBlock {
+            // Position of the block in Workflow::blocks of the new workflow
+            size_t position;
+            Block block;
+        };
+
+        // Elements first until first + removedCount of a vector are replaced by inserted
+        template <typename Element>
+        struct RangeChange {
+            size_t first = 0;
+            size_t removedCount = 0;
+            std::vector<Element> inserted;
+
+            // True when the vector didn't change
+            bool IsEmpty() const { return removedCount == 0 && inserted.empty(); }
+        };
+
+        // Changes that turn a workflow into another one. Blocks are matched by id.
+        //   Connections, global variables and comments change as one replaced range each,
+        //   which is what a single edit in the editor or in the wksp file produces. Two edits far apart
+        //   give one range from the first to the last, with the unchanged elements between them inserted again.
+        struct WorkflowDiff {
+            // Ids of the blocks that don't exist anymore
+            std::vector<int> removedBlocks;
+            // New version of the blocks that changed, matched by id
+            std::vector<Block> modifiedBlocks;
+            // New blocks, sorted by position
+            std::vector<AddedBlock> addedBlocks;
+            // Ids of every block in the new order. Only filled when blocks that were kept changed their order
+            std::vector<int> blockOrder;
+
+            RangeChange<Connection> connections;
+            // Added to the id of the connections after the replaced range
+            int connectionIdShift = 0;
+
+            RangeChange<Variable> globalVariables;
+
+            RangeChange<Comment> comments;
+            // Added to the line of the comments after the replaced range
+            int commentLineShift = 0;
+
+            // True when both workflows are equal
+            bool IsEmpty() const {
+                return removedBlocks.empty() && modifiedBlocks.empty() && addedBlocks.empty() && blockOrder.empty() && connections.IsEmpty()
+                    && connectionIdShift == 0 && globalVariables.IsEmpty() && comments.IsEmpty() && commentLineShift == 0;
+            }
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Finds the changes between two versions of a workflow in O(size of both workflows)
+        *
+        * @param oldWorkflow: The workflow before the changes
+        * @param newWorkflow: The workflow after the changes
+        * @return The changes. Applying them to oldWorkflow gives a workflow equal to newWorkflow
+        *
+        * @throws Block id is repeated> if a workflow has two blocks with the same id
+        */
+        WorkspaceBuilder::Structs::WorkflowDiff DiffWorkflows(const WorkspaceBuilder::Structs::Workflow& oldWorkflow, const WorkspaceBuilder::Structs::Workflow& newWorkflow);
+
+        /**
+        * Applies changes found by DiffWorkflows to a workflow, in place. Every block id and range is checked first,
+        *   so when it throws the workflow is unchanged
+        *
+        * @param workflow: The workflow the changes were computed from. Replaced by the changed workflow
+        * @param diff: The changes
+        *
+        * @throws Block doesn't exist> if a removed or modified block is not in the workflow, or the block order names a block that won't be
+        * @throws Block id is repeated> if the workflow has two blocks with the same id or an added block takes an id in use
+        * @throws Block order doesn't match the blocks> if the block order doesn't name every block once
+        * @throws Range is out of the workflow> if a replaced range doesn't fit in the workflow
+        */
+        void ApplyWorkflowDiff(WorkspaceBuilder::Structs::Workflow& workflow, const WorkspaceBuilder::Structs::WorkflowDiff& diff);
+    }
+    #pragma endregion
+}
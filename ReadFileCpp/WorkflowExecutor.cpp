@@ -0,0 +1,256 @@
+#include "WorkflowExecutor.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        std::vector<int> TopologicalOrder(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow) {
+            size_t blockCount = workflow.blocks.size();
+            std::vector<int> pendingInputs(blockCount);
+            std::vector<int> order;
+            order.reserve(blockCount);
+
+            for (size_t i = 0; i < blockCount; i++) {
+                pendingInputs[i] = (int)GetIncomingConnections(graph, (int)i).size();
+
+                if (pendingInputs[i] == 0) {
+                    order.push_back((int)i);
+                }
+            }
+
+            // order works as the queue of ready blocks
+            for (size_t next = 0; next < order.size(); next++) {
+                for (int connection : GetOutgoingConnections(graph, order[next])) {
+                    int endBlock = FindBlockIndex(graph, workflow.connections[connection].endBlock);
+
+                    if (--pendingInputs[endBlock] == 0) {
+                        order.push_back(endBlock);
+                    }
+                }
+            }
+
+            if (order.size() != blockCount) {
+                throw std::runtime_error("TopologicalOrder error >> The workflow has a cycle");
+            }
+
+            return order;
+        }
+
+        // Blocks ready to run owned by one pool thread. The owner takes from the back and the others steal from the front
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<int> blocks;
+        };
+
+        // State shared by the pool threads during ExecuteWorkflow
+        struct ExecutionState {
+            const WorkspaceBuilder::Structs::WorkflowGraph& graph;
+            const WorkspaceBuilder::Structs::Workflow& workflow;
+            const std::vector<const WorkspaceBuilder::Structs::GlyphFunction*>& functions;
+            WorkspaceBuilder::Structs::ExecutionReport& report;
+            std::chrono::steady_clock::time_point startTime;
+
+            std::vector<WorkQueue> queues;
+            std::unique_ptr<std::atomic<int>[]> pendingInputs;
+            // Blocks pushed in a queue and not finished yet. No more work can appear when it reaches 0
+            std::atomic<int> unfinished{ 0 };
+            // Blocks waiting in the queues
+            std::atomic<int> queued{ 0 };
+            std::atomic<bool> cancelled{ false };
+
+            std::mutex waitMutex;
+            std::condition_variable waitCondition;
+            std::mutex reportMutex;
+
+            ExecutionState(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow,
+                const std::vector<const WorkspaceBuilder::Structs::GlyphFunction*>& functions, WorkspaceBuilder::Structs::ExecutionReport& report, size_t threadCount)
+                : graph(graph), workflow(workflow), functions(functions), report(report), queues(threadCount), pendingInputs(new std::atomic<int>[workflow.blocks.size()]) {}
+
+            void Push(size_t thread, int block) {
+                {
+                    std::lock_guard<std::mutex> lock(queues[thread].mutex);
+                    queues[thread].blocks.push_back(block);
+                }
+                queued++;
+
+                // Taking the lock keeps a thread from missing the notification between its check and its wait
+                { std::lock_guard<std::mutex> lock(waitMutex); }
+                waitCondition.notify_one();
+            }
+
+            bool Pop(size_t thread, int& block) {
+                // Own queue first, newest block, which is likely to use the data just produced
+                {
+                    std::lock_guard<std::mutex> lock(queues[thread].mutex);
+                    if (!queues[thread].blocks.empty()) {
+                        block = queues[thread].blocks.back();
+                        queues[thread].blocks.pop_back();
+                        queued--;
+                        return true;
+                    }
+                }
+
+                // Then steal the oldest block of the other threads
+                for (size_t i = 1; i < queues.size(); i++) {
+                    WorkQueue& victim = queues[(thread + i) % queues.size()];
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+
+                    if (!victim.blocks.empty()) {
+                        block = victim.blocks.front();
+                        victim.blocks.pop_front();
+                        queued--;
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            void Run(size_t thread, int block) {
+                if (!cancelled) {
+                    WorkspaceBuilder::Structs::BlockTiming timing;
+                    timing.thread = (int)thread;
+                    auto blockStart = std::chrono::steady_clock::now();
+
+                    try {
+                        (*functions[block])(workflow.blocks[block], workflow);
+                        timing.executed = true;
+                    }
+                    catch (const std::exception& error) {
+                        Fail(block, error.what());
+                    }
+                    catch (...) {
+                        Fail(block, "Unknown error");
+                    }
+
+                    auto blockEnd = std::chrono::steady_clock::now();
+                    timing.start = std::chrono::duration<double, std::milli>(blockStart - startTime).count();
+                    timing.duration = std::chrono::duration<double, std::milli>(blockEnd - blockStart).count();
+
+                    {
+                        std::lock_guard<std::mutex> lock(reportMutex);
+                        report.timings[block] = timing;
+                        if (timing.executed) report.executionOrder.push_back(block);
+                    }
+
+                    if (timing.executed && !cancelled) {
+                        for (int connection : GetOutgoingConnections(graph, block)) {
+                            int endBlock = FindBlockIndex(graph, workflow.connections[connection].endBlock);
+
+                            if (--pendingInputs[endBlock] == 0) {
+                                unfinished++;
+                                Push(thread, endBlock);
+                            }
+                        }
+                    }
+                }
+
+                if (--unfinished == 0) {
+                    std::lock_guard<std::mutex> lock(waitMutex);
+                    waitCondition.notify_all();
+                }
+            }
+
+            void Fail(int block, const char* message) {
+                std::lock_guard<std::mutex> lock(reportMutex);
+
+                if (report.failedBlock < 0) {
+                    report.failedBlock = block;
+                    report.error = message;
+                }
+                cancelled = true;
+            }
+
+            void Work(size_t thread) {
+                int block;
+
+                while (true) {
+                    if (Pop(thread, block)) {
+                        Run(thread, block);
+                        continue;
+                    }
+
+                    std::unique_lock<std::mutex> lock(waitMutex);
+                    waitCondition.wait(lock, [&]() { return queued > 0 || unfinished == 0; });
+
+                    if (unfinished == 0) {
+                        return;
+                    }
+                }
+            }
+        };
+
+        WorkspaceBuilder::Structs::ExecutionReport ExecuteWorkflow(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow, const WorkspaceBuilder::Structs::GlyphExecutors& executors, int threadCount) {
+            size_t blockCount = workflow.blocks.size();
+
+            // The functions are found once before starting, so the pool threads don't look up strings
+            std::vector<const WorkspaceBuilder::Structs::GlyphFunction*> functions(blockCount);
+            for (size_t i = 0; i < blockCount; i++) {
+                auto found = executors.byType.find(workflow.blocks[i].type);
+
+                if (found != executors.byType.end() && found->second) {
+                    functions[i] = &found->second;
+                }
+                else if (executors.fallback) {
+                    functions[i] = &executors.fallback;
+                }
+                else {
+                    throw std::runtime_error("ExecuteWorkflow error >> No executor for glyph " + workflow.blocks[i].type);
+                }
+            }
+
+            WorkspaceBuilder::Structs::ExecutionReport report;
+            report.timings.resize(blockCount);
+            report.executionOrder.reserve(blockCount);
+
+            size_t count = threadCount > 0 ? (size_t)threadCount : (size_t)std::thread::hardware_concurrency();
+            if (count > blockCount) count = blockCount;
+            if (count == 0) count = 1;
+
+            ExecutionState state(graph, workflow, functions, report, count);
+            state.startTime = std::chrono::steady_clock::now();
+
+            // The blocks without inputs are spread over the threads
+            size_t rootCount = 0;
+            for (size_t i = 0; i < blockCount; i++) {
+                int inputs = (int)GetIncomingConnections(graph, (int)i).size();
+                state.pendingInputs[i] = inputs;
+
+                if (inputs == 0) {
+                    state.queues[rootCount % count].blocks.push_back((int)i);
+                    rootCount++;
+                }
+            }
+            state.unfinished = (int)rootCount;
+            state.queued = (int)rootCount;
+
+            if (rootCount > 0) {
+                std::vector<std::thread> threads;
+                threads.reserve(count - 1);
+
+                for (size_t i = 1; i < count; i++) {
+                    threads.emplace_back([&state, i]() { state.Work(i); });
+                }
+                state.Work(0);
+
+                for (std::thread& thread : threads) {
+                    thread.join();
+                }
+            }
+
+            report.totalTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - state.startTime).count();
+            report.hasCycle = report.failedBlock < 0 && report.executionOrder.size() != blockCount;
+            report.success = report.executionOrder.size() == blockCount;
+
+            return report;
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include "WorkflowGraph.h"
+#include <functional>
+#include <unordered_map>
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // Runs one glyph. It is called from the pool threads, so it must be safe to call concurrently for different blocks
+        typedef std::function<void(const Block& block, const Workflow& workflow)> GlyphFunction;
+
+        // Functions that run the glyphs of a workflow
+        struct GlyphExecutors {
+            // Function for each Block::type
+            std::unordered_map<std::string, GlyphFunction> byType;
+            // Used for the types that are not in byType. Can be empty
+            GlyphFunction fallback;
+        };
+
+        // When and where a block was executed. Times are in milliseconds since the execution started
+        struct BlockTiming {
+            bool executed = false;
+            // Pool thread that ran the block
+            int thread = -1;
+            double start = 0;
+            double duration = 0;
+        };
+
+        // Result of a workflow execution
+        struct ExecutionReport {
+            // True when every block was executed
+            bool success = false;
+            // Timing of each block, in the order of Workflow::blocks
+            std::vector<BlockTiming> timings;
+            // Blocks in the order they finished
+            std::vector<int> executionOrder;
+            // Block whose glyph threw, or -1
+            int failedBlock = -1;
+            // Message of the glyph error
+            std::string error;
+            // True when some blocks were never ready because they are in or after a cycle
+            bool hasCycle = false;
+            // Wall time of the whole execution in milliseconds
+            double totalTime = 0;
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Orders the blocks so every block comes after the blocks it receives data from.
+        *   Connections to blocks that don't exist are ignored.
+        *
+        * @param graph: The workflow graph
+        * @param workflow: The indexed workflow
+        * @return The block positions in Workflow::blocks in execution order. Blocks are kept in file order when possible
+        *
+        * @throws The workflow has a cycle> if the connections form a cycle
+        */
+        std::vector<int> TopologicalOrder(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow);
+
+        /**
+        * Executes a workflow on a work stealing thread pool. A block is dispatched as soon as all the blocks
+        *   connected to its inputs are done, so independent branches run at the same time.
+        *   After a glyph throws no new block is started and the error is returned in the report.
+        *
+        * @param graph: The workflow graph
+        * @param workflow: The indexed workflow
+        * @param executors: The functions that run each glyph type
+        * @param threadCount: Number of pool threads. 0 uses the number of hardware threads. Default = 0
+        * @return The execution report with the timing of each block
+        *
+        * @throws No executor for glyph> if a block type has no function and there is no fallback
+        */
+        WorkspaceBuilder::Structs::ExecutionReport ExecuteWorkflow(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow, const WorkspaceBuilder::Structs::GlyphExecutors& executors, int threadCount = 0);
+    }
+    #pragma endregion
+}
@@ -0,0 +1,56 @@
+#include "WorkflowGenerator.h"
+
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+using namespace std;
+
+string GenerateWorkflow(const GeneratorOptions& options) {
+    mt19937 random(options.seed);
+    uniform_int_distribution<int> position(0, 4000);
+    uniform_real_distribution<double> weight(0.0, 1.0);
+    const char* functions[] = { "vglLoadImage", "vglCreateImage", "vglClConvolution", "vglClDilate", "vglClErode", "vglSaveImage", "ShowImage" };
+    const char* ports[] = { "retval", "img", "img_input", "img_output", "image" };
+
+    ostringstream text;
+    text << "# VisionGL Visual Programming Workspace\n#\n# Synthetic workflow generated by the benchmark\n#\n\n";
+    text << "WorkspaceBegin: 1.0\n\nVariablesBegin:\nwidth_size = 2342\nheight_size = 1144\nVariablesEnd:\n\n\n";
+
+    text << fixed << setprecision(4);
+    for (int id = 1; id <= options.glyphs; id++) {
+        int function = id % 7;
+        text << "Glyph:VGL_CL:" << functions[function] << ":localhost:" << id << ":" << position(random) << ":" << position(random) << ":";
+
+        if (function == 0 || function == 5) {
+            text << " -filename 'images/image_" << id << ".png' -iscolor 1";
+        }
+        else if (function >= 2 && function <= 4) {
+            text << " -convolution_window [";
+            for (int i = 0; i < options.arrayLength; i++) {
+                text << (i == 0 ? "" : ", ") << weight(random);
+            }
+            text << "] -window_size_x 5 -window_size_y 5";
+        }
+        else if (function == 6) {
+            text << " -winname 'window_" << id << "'";
+        }
+        text << "\n";
+    }
+    text << "\n\n";
+
+    for (int i = 0; i < options.connections && options.glyphs > 1; i++) {
+        // Connections go forward so the generated graph has no cycles
+        int end = 2 + (int)(random() % (options.glyphs - 1));
+        int start = 1 + (int)(random() % (end - 1));
+        text << "NodeConnection:data:" << start << ":" << ports[random() % 5] << ":" << end << ":" << ports[random() % 5] << "\n";
+    }
+    text << "\n\nAnnotationsBegin\n";
+
+    for (int i = 0; i < options.annotations; i++) {
+        text << "#  Glyph 'Synthetic annotation " << i << "'\n";
+    }
+    text << "AnnotationsEnd\n\n\nWorkspaceEnd: 1.0\n";
+
+    return text.str();
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+
+#pragma region Synthetic workflow generator
+// Sizes of the generated workflow
+struct GeneratorOptions {
+    int glyphs = 10000;
+    int connections = 20000;
+    int arrayLength = 25;
+    int annotations = 1000;
+    unsigned int seed = 42;
+};
+
+/**
+* Builds a wksp text with the same shapes found in teste.wksp. Used by the benchmark and by the equivalence check
+*
+* @param options: The sizes of the workflow and the seed of its random positions and weights
+* @return The content of the .wksp file
+*/
+std::string GenerateWorkflow(const GeneratorOptions& options);
+#pragma endregion
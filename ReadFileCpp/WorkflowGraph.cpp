@@ -0,0 +1,273 @@
+#include "WorkflowGraph.h"
+
+#include <algorithm>
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        // Ids are stored in a table when it would be at most this many times the block count
+        static const long long DenseIndexMaxRatio = 4;
+
+        // Builds one CSR adjacency list. blockOf and portOf give the block position and port name of a connection end
+        template <typename Workflow, typename BlockOf, typename PortOf>
+        static void BuildAdjacency(const Workflow& workflow, std::vector<int>& offsets, std::vector<int>& connections, BlockOf blockOf, PortOf portOf) {
+            offsets.assign(workflow.blocks.size() + 1, 0);
+
+            // Count connections per block
+            for (size_t i = 0; i < workflow.connections.size(); i++) {
+                int block = blockOf(i);
+                if (block >= 0) offsets[block + 1]++;
+            }
+
+            for (size_t block = 0; block < workflow.blocks.size(); block++) {
+                offsets[block + 1] += offsets[block];
+            }
+
+            // Place each connection in its block range
+            connections.assign(offsets.back(), 0);
+            std::vector<int> next(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < workflow.connections.size(); i++) {
+                int block = blockOf(i);
+                if (block >= 0) connections[next[block]++] = (int)i;
+            }
+
+            // Port lookups use binary search inside the block range
+            for (size_t block = 0; block < workflow.blocks.size(); block++) {
+                std::stable_sort(connections.begin() + offsets[block], connections.begin() + offsets[block + 1], [&](int a, int b) {
+                    return portOf(a) < portOf(b);
+                });
+            }
+        }
+
+        // Connections of a block range whose port has the given name
+        template <typename PortOf>
+        static WorkspaceBuilder::Structs::ConnectionRange FindPortRange(WorkspaceBuilder::Structs::ConnectionRange range, std::string_view name, PortOf portOf) {
+            const int* first = std::lower_bound(range.first, range.last, name, [&](int connection, std::string_view value) {
+                return std::string_view(portOf(connection)) < value;
+            });
+            const int* last = std::upper_bound(first, range.last, name, [&](std::string_view value, int connection) {
+                return value < std::string_view(portOf(connection));
+            });
+
+            return { first, last };
+        }
+
+        // Breadth first walk. next(block) gives the connection range to follow and endOf(connection) the block it leads to
+        template <typename Workflow, typename Next, typename EndOf>
+        static std::vector<int> WalkBlocks(const Workflow& workflow, int blockIndex, Next next, EndOf endOf) {
+            std::vector<int> reached;
+
+            if (blockIndex < 0 || blockIndex >= (int)workflow.blocks.size()) {
+                return reached;
+            }
+
+            std::vector<bool> visited(workflow.blocks.size(), false);
+            visited[blockIndex] = true;
+
+            // The result list is also the queue of the walk
+            size_t queueStart = 0;
+            int current = blockIndex;
+            while (true) {
+                for (int connection : next(current)) {
+                    int block = endOf(connection);
+
+                    if (!visited[block]) {
+                        visited[block] = true;
+                        reached.push_back(block);
+                    }
+                }
+
+                if (queueStart == reached.size()) break;
+                current = reached[queueStart++];
+            }
+
+            return reached;
+        }
+
+        // Adds a port with the Unknown type. The allocator aware ports are built straight in the memory of their block
+        template <typename Port>
+        static void AddPort(std::vector<Port>& ports, const std::string& name) {
+            ports.push_back({ name, WorkspaceBuilder::Enums::VariableType::Unknown });
+        }
+
+        static void AddPort(std::pmr::vector<WorkspaceBuilder::Structs::PmrPort>& ports, const std::pmr::string& name) {
+            ports.emplace_back(name, WorkspaceBuilder::Enums::VariableType::Unknown);
+        }
+
+        // BuildWorkflowGraph of a Workflow or a PmrWorkflow
+        template <typename Workflow>
+        static WorkspaceBuilder::Structs::WorkflowGraph BuildGraph(Workflow& workflow) {
+            WorkspaceBuilder::Structs::WorkflowGraph graph;
+
+            // Id lookup
+            if (!workflow.blocks.empty()) {
+                int minId = workflow.blocks[0].id;
+                int maxId = workflow.blocks[0].id;
+                for (const auto& block : workflow.blocks) {
+                    minId = std::min(minId, block.id);
+                    maxId = std::max(maxId, block.id);
+                }
+
+                long long range = (long long)maxId - minId + 1;
+                graph.isDense = range <= DenseIndexMaxRatio * (long long)workflow.blocks.size();
+                graph.minId = minId;
+
+                if (graph.isDense) {
+                    graph.denseIndex.assign((size_t)range, -1);
+                }
+                else {
+                    graph.sparseIndex.reserve(workflow.blocks.size());
+                }
+
+                for (size_t i = 0; i < workflow.blocks.size(); i++) {
+                    int id = workflow.blocks[i].id;
+
+                    // The first block wins when ids repeat
+                    if (graph.isDense) {
+                        if (graph.denseIndex[id - minId] == -1) graph.denseIndex[id - minId] = (int)i;
+                    }
+                    else {
+                        graph.sparseIndex.emplace(id, (int)i);
+                    }
+                }
+            }
+
+            // Connection ends resolved once
+            std::vector<int> startBlocks(workflow.connections.size());
+            std::vector<int> endBlocks(workflow.connections.size());
+            for (size_t i = 0; i < workflow.connections.size(); i++) {
+                startBlocks[i] = FindBlockIndex(graph, workflow.connections[i].startBlock);
+                endBlocks[i] = FindBlockIndex(graph, workflow.connections[i].endBlock);
+
+                if (startBlocks[i] < 0 || endBlocks[i] < 0) {
+                    graph.danglingConnections.push_back((int)i);
+                    startBlocks[i] = -1;
+                    endBlocks[i] = -1;
+                }
+            }
+
+            BuildAdjacency(workflow, graph.outgoingOffsets, graph.outgoingConnections,
+                [&](size_t connection) { return startBlocks[connection]; },
+                [&](int connection) -> const auto& { return workflow.connections[connection].outputStartBlock; });
+            BuildAdjacency(workflow, graph.incomingOffsets, graph.incomingConnections,
+                [&](size_t connection) { return endBlocks[connection]; },
+                [&](int connection) -> const auto& { return workflow.connections[connection].inputEndBlock; });
+
+            // Block ports are the distinct names used by its connections. Connection lines don't say the port types
+            for (size_t block = 0; block < workflow.blocks.size(); block++) {
+                auto& current = workflow.blocks[block];
+                current.outputs.clear();
+                current.inputs.clear();
+
+                for (int i = graph.outgoingOffsets[block]; i < graph.outgoingOffsets[block + 1]; i++) {
+                    const auto& name = workflow.connections[graph.outgoingConnections[i]].outputStartBlock;
+
+                    if (current.outputs.empty() || current.outputs.back().name != name) {
+                        AddPort(current.outputs, name);
+                    }
+                }
+
+                for (int i = graph.incomingOffsets[block]; i < graph.incomingOffsets[block + 1]; i++) {
+                    const auto& name = workflow.connections[graph.incomingConnections[i]].inputEndBlock;
+
+                    if (current.inputs.empty() || current.inputs.back().name != name) {
+                        AddPort(current.inputs, name);
+                    }
+                }
+            }
+
+            return graph;
+        }
+
+        WorkspaceBuilder::Structs::WorkflowGraph BuildWorkflowGraph(WorkspaceBuilder::Structs::Workflow& workflow) {
+            return BuildGraph(workflow);
+        }
+
+        WorkspaceBuilder::Structs::WorkflowGraph BuildWorkflowGraph(WorkspaceBuilder::Structs::PmrWorkflow& workflow) {
+            return BuildGraph(workflow);
+        }
+
+        int FindBlockIndex(const WorkspaceBuilder::Structs::WorkflowGraph& graph, int id) {
+            if (graph.isDense) {
+                long long position = (long long)id - graph.minId;
+
+                if (position < 0 || position >= (long long)graph.denseIndex.size()) {
+                    return -1;
+                }
+
+                return graph.denseIndex[(size_t)position];
+            }
+
+            std::unordered_map<int, int>::const_iterator found = graph.sparseIndex.find(id);
+
+            return found == graph.sparseIndex.end() ? -1 : found->second;
+        }
+
+        WorkspaceBuilder::Structs::ConnectionRange GetOutgoingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, int blockIndex) {
+            const int* data = graph.outgoingConnections.data();
+
+            return { data + graph.outgoingOffsets[blockIndex], data + graph.outgoingOffsets[blockIndex + 1] };
+        }
+
+        WorkspaceBuilder::Structs::ConnectionRange GetOutgoingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow, int blockIndex, const std::string& outputName) {
+            return FindPortRange(GetOutgoingConnections(graph, blockIndex), outputName, [&](int connection) -> const auto& {
+                return workflow.connections[connection].outputStartBlock;
+            });
+        }
+
+        WorkspaceBuilder::Structs::ConnectionRange GetOutgoingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::PmrWorkflow& workflow, int blockIndex, const std::string& outputName) {
+            return FindPortRange(GetOutgoingConnections(graph, blockIndex), outputName, [&](int connection) -> const auto& {
+                return workflow.connections[connection].outputStartBlock;
+            });
+        }
+
+        WorkspaceBuilder::Structs::ConnectionRange GetIncomingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, int blockIndex) {
+            const int* data = graph.incomingConnections.data();
+
+            return { data + graph.incomingOffsets[blockIndex], data + graph.incomingOffsets[blockIndex + 1] };
+        }
+
+        WorkspaceBuilder::Structs::ConnectionRange GetIncomingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow, int blockIndex, const std::string& inputName) {
+            return FindPortRange(GetIncomingConnections(graph, blockIndex), inputName, [&](int connection) -> const auto& {
+                return workflow.connections[connection].inputEndBlock;
+            });
+        }
+
+        WorkspaceBuilder::Structs::ConnectionRange GetIncomingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::PmrWorkflow& workflow, int blockIndex, const std::string& inputName) {
+            return FindPortRange(GetIncomingConnections(graph, blockIndex), inputName, [&](int connection) -> const auto& {
+                return workflow.connections[connection].inputEndBlock;
+            });
+        }
+
+        // GetDownstreamBlocks and GetUpstreamBlocks of a Workflow or a PmrWorkflow
+        template <typename Workflow>
+        static std::vector<int> GetDownstream(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const Workflow& workflow, int blockIndex) {
+            return WalkBlocks(workflow, blockIndex,
+                [&](int block) { return GetOutgoingConnections(graph, block); },
+                [&](int connection) { return FindBlockIndex(graph, workflow.connections[connection].endBlock); });
+        }
+
+        template <typename Workflow>
+        static std::vector<int> GetUpstream(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const Workflow& workflow, int blockIndex) {
+            return WalkBlocks(workflow, blockIndex,
+                [&](int block) { return GetIncomingConnections(graph, block); },
+                [&](int connection) { return FindBlockIndex(graph, workflow.connections[connection].startBlock); });
+        }
+
+        std::vector<int> GetDownstreamBlocks(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow, int blockIndex) {
+            return GetDownstream(graph, workflow, blockIndex);
+        }
+
+        std::vector<int> GetDownstreamBlocks(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::PmrWorkflow& workflow, int blockIndex) {
+            return GetDownstream(graph, workflow, blockIndex);
+        }
+
+        std::vector<int> GetUpstreamBlocks(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow, int blockIndex) {
+            return GetUpstream(graph, workflow, blockIndex);
+        }
+
+        std::vector<int> GetUpstreamBlocks(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::PmrWorkflow& workflow, int blockIndex) {
+            return GetUpstream(graph, workflow, blockIndex);
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include "ArenaWorkflow.h"
+#include <unordered_map>
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // Index over the blocks and connections of a workflow. Blocks are referenced by their position in Workflow::blocks
+        //   and connections by their position in Workflow::connections. A PmrWorkflow is indexed the same way.
+        //   It must be built again when the workflow blocks or connections change.
+        struct WorkflowGraph {
+            // True when the ids are compact enough to be looked up in denseIndex
+            bool isDense = true;
+            // Smallest block id. denseIndex[id - minId] is the block position or -1
+            int minId = 0;
+            std::vector<int> denseIndex;
+            // Block position by id when the ids are too sparse for a table
+            std::unordered_map<int, int> sparseIndex;
+
+            // Outgoing connections of block b are outgoingConnections[outgoingOffsets[b]] until outgoingOffsets[b + 1], sorted by output name
+            std::vector<int> outgoingOffsets;
+            std::vector<int> outgoingConnections;
+            // Incoming connections of block b are incomingConnections[incomingOffsets[b]] until incomingOffsets[b + 1], sorted by input name
+            std::vector<int> incomingOffsets;
+            std::vector<int> incomingConnections;
+
+            // Connections that reference a block id that doesn't exist. They are not in the adjacency lists
+            std::vector<int> danglingConnections;
+        };
+
+        // A range of connection positions inside a WorkflowGraph
+        struct ConnectionRange {
+            const int* first;
+            const int* last;
+
+            const int* begin() const { return first; }
+            const int* end() const { return last; }
+            size_t size() const { return last - first; }
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Builds the id lookup and the adjacency lists of a workflow. Ids and list offsets take O(blocks + connections),
+        *   then the connections of each block are sorted by port name, O(connections * log(connections)) in the worst case.
+        *   Block inputs and outputs are filled from the connections that reach them, with the Unknown type.
+        *
+        * @param workflow: The workflow to be indexed. Its blocks inputs and outputs are replaced
+        * @return The workflow graph
+        */
+        WorkspaceBuilder::Structs::WorkflowGraph BuildWorkflowGraph(WorkspaceBuilder::Structs::Workflow& workflow);
+
+        /**
+        * Same as BuildWorkflowGraph for a workflow parsed into an arena. The ports are added in the arena of the workflow
+        *
+        * @param workflow: The allocator aware workflow to be indexed, like ArenaWorkflow::Workflow(). Its blocks inputs and outputs are replaced
+        * @return The workflow graph
+        */
+        WorkspaceBuilder::Structs::WorkflowGraph BuildWorkflowGraph(WorkspaceBuilder::Structs::PmrWorkflow& workflow);
+
+        /**
+        * Finds the position of a block in Workflow::blocks. When ids repeat the first block is returned.
+        *
+        * @param graph: The workflow graph
+        * @param id: The block id
+        * @return The block position or -1 if there is no block with this id
+        */
+        int FindBlockIndex(const WorkspaceBuilder::Structs::WorkflowGraph& graph, int id);
+
+        /**
+        * Connections that start in a block
+        *
+        * @param graph: The workflow graph
+        * @param blockIndex: The block position in Workflow::blocks
+        * @return The connection positions sorted by output name
+        */
+        WorkspaceBuilder::Structs::ConnectionRange GetOutgoingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, int blockIndex);
+
+        /**
+        * Connections that start in a given output of a block
+        *
+        * @param graph: The workflow graph
+        * @param workflow: The indexed workflow
+        * @param blockIndex: The block position in Workflow::blocks
+        * @param outputName: The output name in lower case
+        * @return The connection positions
+        */
+        WorkspaceBuilder::Structs::ConnectionRange GetOutgoingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow, int blockIndex, const std::string& outputName);
+        // For a workflow parsed into an arena
+        WorkspaceBuilder::Structs::ConnectionRange GetOutgoingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::PmrWorkflow& workflow, int blockIndex, const std::string& outputName);
+
+        /**
+        * Connections that finish in a block
+        *
+        * @param graph: The workflow graph
+        * @param blockIndex: The block position in Workflow::blocks
+        * @return The connection positions sorted by input name
+        */
+        WorkspaceBuilder::Structs::ConnectionRange GetIncomingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, int blockIndex);
+
+        /**
+        * Connections that finish in a given input of a block
+        *
+        * @param graph: The workflow graph
+        * @param workflow: The indexed workflow
+        * @param blockIndex: The block position in Workflow::blocks
+        * @param inputName: The input name in lower case
+        * @return The connection positions
+        */
+        WorkspaceBuilder::Structs::ConnectionRange GetIncomingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow, int blockIndex, const std::string& inputName);
+        // For a workflow parsed into an arena
+        WorkspaceBuilder::Structs::ConnectionRange GetIncomingConnections(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::PmrWorkflow& workflow, int blockIndex, const std::string& inputName);
+
+        /**
+        * Every block reachable following the connections forward from a block, in breadth first order
+        *
+        * @param graph: The workflow graph
+        * @param workflow: The indexed workflow
+        * @param blockIndex: The block position in Workflow::blocks
+        * @return The reachable block positions without the starting block
+        */
+        std::vector<int> GetDownstreamBlocks(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow, int blockIndex);
+        // For a workflow parsed into an arena
+        std::vector<int> GetDownstreamBlocks(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::PmrWorkflow& workflow, int blockIndex);
+
+        /**
+        * Every block reachable following the connections backwards from a block, in breadth first order
+        *
+        * @param graph: The workflow graph
+        * @param workflow: The indexed workflow
+        * @param blockIndex: The block position in Workflow::blocks
+        * @return The reachable block positions without the starting block
+        */
+        std::vector<int> GetUpstreamBlocks(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow, int blockIndex);
+        // For a workflow parsed into an arena
+        std::vector<int> GetUpstreamBlocks(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::PmrWorkflow& workflow, int blockIndex);
+    }
+    #pragma endregion
+}
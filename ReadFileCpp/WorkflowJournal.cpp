@@ -0,0 +1,614 @@
+#include "WorkflowJournal.h"
+#include "GzipStream.h"
+#include "IncrementalParser.h"
+#include "MappedFile.h"
+#include "ParseCache.h"
+#include "TypedParameters.h"
+#include "WorkflowWriter.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace WorkspaceBuilder {
+    namespace Structs {
+
+        static const char JournalMagic[4] = { 'W', 'K', 'S', 'J' };
+        static const uint32_t JournalVersion = 1;
+        static const uint32_t JournalByteOrderMark = 0x01020304;
+        // Magic, version, byte order mark and base hash
+        static const size_t JournalHeaderSize = 20;
+        // Payload size and payload hash
+        static const size_t RecordHeaderSize = 12;
+
+#pragma region File access
+#ifdef _WIN32
+        typedef void* JournalHandle;
+        static const JournalHandle ClosedHandle = nullptr;
+
+        // Opens a file for writing at its end. truncate empties it first
+        static JournalHandle OpenForAppend(const std::string& path, bool truncate) {
+            HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+            if (file == INVALID_HANDLE_VALUE) {
+                return ClosedHandle;
+            }
+
+            LARGE_INTEGER zero = {};
+            SetFilePointerEx(file, zero, nullptr, FILE_END);
+
+            return file;
+        }
+
+        static bool WriteAll(JournalHandle file, const char* data, size_t size) {
+            while (size > 0) {
+                DWORD chunk = size > 0x40000000 ? 0x40000000 : (DWORD)size;
+                DWORD written = 0;
+
+                if (!WriteFile(file, data, chunk, &written, nullptr) || written == 0) {
+                    return false;
+                }
+
+                data += written;
+                size -= written;
+            }
+
+            return true;
+        }
+
+        static bool SyncFile(JournalHandle file) {
+            return FlushFileBuffers(file) != 0;
+        }
+
+        static void CloseFile(JournalHandle file) {
+            CloseHandle(file);
+        }
+
+        // The rename is already durable once MoveFileEx returns on NTFS
+        static void SyncDirectory(const std::string&) {}
+#else
+        typedef int JournalHandle;
+        static const JournalHandle ClosedHandle = -1;
+
+        // Opens a file for writing at its end. truncate empties it first
+        static JournalHandle OpenForAppend(const std::string& path, bool truncate) {
+            int file = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0), 0644);
+
+            return file < 0 ? ClosedHandle : file;
+        }
+
+        static bool WriteAll(JournalHandle file, const char* data, size_t size) {
+            while (size > 0) {
+                ssize_t written = write(file, data, size);
+
+                if (written < 0 && errno == EINTR) continue;
+                if (written <= 0) return false;
+
+                data += written;
+                size -= (size_t)written;
+            }
+
+            return true;
+        }
+
+        static bool SyncFile(JournalHandle file) {
+            return fsync(file) == 0;
+        }
+
+        static void CloseFile(JournalHandle file) {
+            close(file);
+        }
+
+        // A rename is only durable after the directory that holds the file is synced
+        static void SyncDirectory(const std::string& path) {
+            std::filesystem::path directory = std::filesystem::path(path).parent_path();
+            int file = open(directory.empty() ? "." : directory.string().c_str(), O_RDONLY);
+
+            if (file >= 0) {
+                fsync(file);
+                close(file);
+            }
+        }
+#endif
+
+        // Writes a whole file and forces it to the disk before returning
+        static bool WriteFileDurably(const std::string& path, const std::string& content) {
+            JournalHandle file = OpenForAppend(path, true);
+
+            if (file == ClosedHandle) {
+                return false;
+            }
+
+            bool isWritten = WriteAll(file, content.data(), content.size()) && SyncFile(file);
+            CloseFile(file);
+
+            return isWritten;
+        }
+#pragma endregion
+
+#pragma region Record encoding
+        template <typename Value>
+        static void AppendValue(std::string& output, Value value) {
+            output.append((const char*)&value, sizeof(value));
+        }
+
+        static void AppendText(std::string& output, const std::string& text) {
+            AppendValue(output, (uint32_t)text.size());
+            output.append(text);
+        }
+
+        static void AppendVariable(std::string& output, const WorkspaceBuilder::Structs::Variable& variable) {
+            AppendText(output, variable.key);
+            AppendText(output, variable.value);
+            AppendValue(output, (uint32_t)variable.type);
+        }
+
+        template <typename Port>
+        static void AppendPorts(std::string& output, const std::vector<Port>& ports) {
+            AppendValue(output, (uint32_t)ports.size());
+            for (const Port& port : ports) {
+                AppendText(output, port.name);
+                AppendValue(output, (uint32_t)port.type);
+            }
+        }
+
+        static void AppendBlock(std::string& output, const WorkspaceBuilder::Structs::Block& block) {
+            AppendValue(output, (int32_t)block.id);
+            AppendText(output, block.type);
+            AppendText(output, block.hostMachine);
+            AppendValue(output, block.position.x);
+            AppendValue(output, block.position.y);
+
+            AppendValue(output, (uint32_t)block.variables.size());
+            for (const WorkspaceBuilder::Structs::Variable& variable : block.variables) {
+                AppendVariable(output, variable);
+            }
+
+            AppendPorts(output, block.inputs);
+            AppendPorts(output, block.outputs);
+        }
+
+        static void AppendConnection(std::string& output, const WorkspaceBuilder::Structs::Connection& connection) {
+            AppendValue(output, (int32_t)connection.id);
+            AppendValue(output, (int32_t)connection.startBlock);
+            AppendText(output, connection.outputStartBlock);
+            AppendValue(output, (int32_t)connection.endBlock);
+            AppendText(output, connection.inputEndBlock);
+        }
+
+        static void AppendComment(std::string& output, const WorkspaceBuilder::Structs::Comment& comment) {
+            AppendValue(output, (int32_t)comment.line);
+            AppendText(output, comment.text);
+            AppendValue(output, comment.position.x);
+            AppendValue(output, comment.position.y);
+        }
+
+        template <typename Element, typename AppendElement>
+        static void AppendRange(std::string& output, const WorkspaceBuilder::Structs::RangeChange<Element>& change, AppendElement appendElement) {
+            AppendValue(output, (uint32_t)change.first);
+            AppendValue(output, (uint32_t)change.removedCount);
+            AppendValue(output, (uint32_t)change.inserted.size());
+            for (const Element& element : change.inserted) {
+                appendElement(output, element);
+            }
+        }
+
+        static void AppendDiff(std::string& output, const WorkspaceBuilder::Structs::WorkflowDiff& diff) {
+            AppendValue(output, (uint32_t)diff.removedBlocks.size());
+            for (int id : diff.removedBlocks) {
+                AppendValue(output, (int32_t)id);
+            }
+
+            AppendValue(output, (uint32_t)diff.modifiedBlocks.size());
+            for (const WorkspaceBuilder::Structs::Block& block : diff.modifiedBlocks) {
+                AppendBlock(output, block);
+            }
+
+            AppendValue(output, (uint32_t)diff.addedBlocks.size());
+            for (const WorkspaceBuilder::Structs::AddedBlock& added : diff.addedBlocks) {
+                AppendValue(output, (uint32_t)added.position);
+                AppendBlock(output, added.block);
+            }
+
+            AppendValue(output, (uint32_t)diff.blockOrder.size());
+            for (int id : diff.blockOrder) {
+                AppendValue(output, (int32_t)id);
+            }
+
+            AppendRange(output, diff.connections, AppendConnection);
+            AppendValue(output, (int32_t)diff.connectionIdShift);
+            AppendRange(output, diff.globalVariables, AppendVariable);
+            AppendRange(output, diff.comments, AppendComment);
+            AppendValue(output, (int32_t)diff.commentLineShift);
+        }
+
+        // Reads the fields of a record in order. Reading past its end throws
+        struct RecordReader {
+            const char* data;
+            size_t size;
+            size_t offset = 0;
+
+            template <typename Value>
+            Value Read() {
+                Value value;
+                Take(&value, sizeof(value));
+                return value;
+            }
+
+            std::string ReadText() {
+                uint32_t length = Read<uint32_t>();
+                if (length > size - offset) Fail();
+
+                std::string text(data + offset, length);
+                offset += length;
+                return text;
+            }
+
+            // Element count of a vector. Each element needs at least minimumSize bytes, so a broken count can't allocate too much
+            uint32_t ReadCount(size_t minimumSize) {
+                uint32_t count = Read<uint32_t>();
+                if ((uint64_t)count * minimumSize > size - offset) Fail();
+                return count;
+            }
+
+            void Take(void* value, size_t length) {
+                if (length > size - offset) Fail();
+
+                memcpy(value, data + offset, length);
+                offset += length;
+            }
+
+            [[noreturn]] void Fail() {
+                throw std::runtime_error("WorkflowJournal error >> Record is truncated");
+            }
+        };
+
+        static WorkspaceBuilder::Structs::Variable ReadVariable(RecordReader& reader) {
+            WorkspaceBuilder::Structs::Variable variable;
+            variable.key = reader.ReadText();
+            variable.value = reader.ReadText();
+            variable.type = (WorkspaceBuilder::Enums::VariableType)reader.Read<uint32_t>();
+
+            // Only the text is recorded, the value is decoded again like the parsers do
+            variable.parameter = WorkspaceBuilder::Functions::ParseParameterValue(variable.value, variable.type);
+            return variable;
+        }
+
+        template <typename Port>
+        static void ReadPorts(RecordReader& reader, std::vector<Port>& ports) {
+            ports.resize(reader.ReadCount(8));
+            for (Port& port : ports) {
+                port.name = reader.ReadText();
+                port.type = (WorkspaceBuilder::Enums::VariableType)reader.Read<uint32_t>();
+            }
+        }
+
+        static WorkspaceBuilder::Structs::Block ReadBlock(RecordReader& reader) {
+            WorkspaceBuilder::Structs::Block block;
+            block.id = reader.Read<int32_t>();
+            block.type = reader.ReadText();
+            block.hostMachine = reader.ReadText();
+            block.position.x = reader.Read<float>();
+            block.position.y = reader.Read<float>();
+
+            block.variables.resize(reader.ReadCount(12));
+            for (WorkspaceBuilder::Structs::Variable& variable : block.variables) {
+                variable = ReadVariable(reader);
+            }
+
+            ReadPorts(reader, block.inputs);
+            ReadPorts(reader, block.outputs);
+            return block;
+        }
+
+        static WorkspaceBuilder::Structs::Connection ReadConnection(RecordReader& reader) {
+            WorkspaceBuilder::Structs::Connection connection;
+            connection.id = reader.Read<int32_t>();
+            connection.startBlock = reader.Read<int32_t>();
+            connection.outputStartBlock = reader.ReadText();
+            connection.endBlock = reader.Read<int32_t>();
+            connection.inputEndBlock = reader.ReadText();
+            return connection;
+        }
+
+        static WorkspaceBuilder::Structs::Comment ReadComment(RecordReader& reader) {
+            WorkspaceBuilder::Structs::Comment comment;
+            comment.line = reader.Read<int32_t>();
+            comment.text = reader.ReadText();
+            comment.position.x = reader.Read<float>();
+            comment.position.y = reader.Read<float>();
+            return comment;
+        }
+
+        template <typename Element, typename ReadElement>
+        static void ReadRange(RecordReader& reader, WorkspaceBuilder::Structs::RangeChange<Element>& change, size_t minimumSize, ReadElement readElement) {
+            change.first = reader.Read<uint32_t>();
+            change.removedCount = reader.Read<uint32_t>();
+            change.inserted.resize(reader.ReadCount(minimumSize));
+            for (Element& element : change.inserted) {
+                element = readElement(reader);
+            }
+        }
+
+        static WorkspaceBuilder::Structs::WorkflowDiff ReadDiff(RecordReader& reader) {
+            WorkspaceBuilder::Structs::WorkflowDiff diff;
+
+            diff.removedBlocks.resize(reader.ReadCount(4));
+            for (int& id : diff.removedBlocks) {
+                id = reader.Read<int32_t>();
+            }
+
+            diff.modifiedBlocks.resize(reader.ReadCount(32));
+            for (WorkspaceBuilder::Structs::Block& block : diff.modifiedBlocks) {
+                block = ReadBlock(reader);
+            }
+
+            diff.addedBlocks.resize(reader.ReadCount(36));
+            for (WorkspaceBuilder::Structs::AddedBlock& added : diff.addedBlocks) {
+                added.position = reader.Read<uint32_t>();
+                added.block = ReadBlock(reader);
+            }
+
+            diff.blockOrder.resize(reader.ReadCount(4));
+            for (int& id : diff.blockOrder) {
+                id = reader.Read<int32_t>();
+            }
+
+            ReadRange(reader, diff.connections, 20, ReadConnection);
+            diff.connectionIdShift = reader.Read<int32_t>();
+            ReadRange(reader, diff.globalVariables, 12, ReadVariable);
+            ReadRange(reader, diff.comments, 16, ReadComment);
+            diff.commentLineShift = reader.Read<int32_t>();
+
+            return diff;
+        }
+#pragma endregion
+
+        static std::string GetJournalPath(const std::string& path) {
+            return path + ".journal";
+        }
+
+        static void AppendJournalHeader(std::string& output, uint64_t baseHash) {
+            output.append(JournalMagic, sizeof(JournalMagic));
+            AppendValue(output, JournalVersion);
+            AppendValue(output, JournalByteOrderMark);
+            AppendValue(output, baseHash);
+        }
+
+        /**
+        * Applies the records of a journal to the workflow loaded from its wksp file
+        *
+        * @param journalPath: The journal file
+        * @param baseHash: Hash of the wksp file content
+        * @param workflow: The workflow of the wksp file. The records are applied to it
+        * @return Bytes of the journal that hold valid records, header included. 0 when the journal is missing, broken or belongs to another base
+        */
+        static size_t ReplayJournal(const std::string& journalPath, uint64_t baseHash, WorkspaceBuilder::Structs::Workflow& workflow) {
+            std::ifstream journalFile(journalPath, std::ios::in | std::ios::binary);
+
+            if (!journalFile) {
+                return 0;
+            }
+
+            std::string journal((std::istreambuf_iterator<char>(journalFile)), std::istreambuf_iterator<char>());
+            std::string expectedHeader;
+            AppendJournalHeader(expectedHeader, baseHash);
+
+            if (journal.compare(0, JournalHeaderSize, expectedHeader) != 0) {
+                return 0;
+            }
+
+            size_t offset = JournalHeaderSize;
+            while (journal.size() - offset >= RecordHeaderSize) {
+                uint32_t payloadSize;
+                uint64_t payloadHash;
+                memcpy(&payloadSize, journal.data() + offset, sizeof(payloadSize));
+                memcpy(&payloadHash, journal.data() + offset + 4, sizeof(payloadHash));
+
+                // A record cut by a crash ends the journal
+                if (payloadSize > journal.size() - offset - RecordHeaderSize) break;
+
+                std::string_view payload(journal.data() + offset + RecordHeaderSize, payloadSize);
+                if (WorkspaceBuilder::SupportFunctions::HashLine(payload) != payloadHash) break;
+
+                RecordReader reader = { payload.data(), payload.size() };
+                WorkspaceBuilder::Structs::WorkflowDiff diff;
+                try {
+                    diff = ReadDiff(reader);
+
+                    // A record that doesn't fit the workflow ends the journal like a broken one. It leaves the workflow unchanged
+                    WorkspaceBuilder::Functions::ApplyWorkflowDiff(workflow, diff);
+                }
+                catch (const std::runtime_error&) {
+                    break;
+                }
+
+                offset += RecordHeaderSize + payloadSize;
+            }
+
+            return offset;
+        }
+
+        WorkflowJournal::WorkflowJournal(const std::string& path, JournalOptions options) : path(path), journalPath(GetJournalPath(path)), options(options) {
+            std::error_code error;
+
+            // Compacting rewrites the file as text, which would leave plain text under a .gz name
+            if (WorkspaceBuilder::SupportFunctions::IsGzipPath(path)) {
+                throw std::runtime_error("WorkflowJournal error >> A .gz file can't be journaled, save it as .wksp");
+            }
+
+            if (std::filesystem::exists(path, error)) {
+                WorkspaceBuilder::SupportFunctions::MappedFile file(path);
+                baseHash = WorkspaceBuilder::SupportFunctions::HashLine(file.View());
+                workflow = WorkspaceBuilder::Functions::ParseWorkflowBuffer(file.View());
+            }
+            else {
+                baseHash = WorkspaceBuilder::SupportFunctions::HashLine(std::string_view());
+            }
+
+            journalSize = ReplayJournal(journalPath, baseHash, workflow);
+
+            // The records after a crash are dropped, so new records follow the last valid one
+            if (journalSize > 0 && std::filesystem::file_size(journalPath, error) != journalSize) {
+                std::filesystem::resize_file(journalPath, journalSize, error);
+                if (error) journalSize = 0;
+            }
+        }
+
+        WorkflowJournal::~WorkflowJournal() {
+            if (journalHandle != ClosedHandle) {
+                if (unsyncedRecords > 0) SyncFile(journalHandle);
+                CloseFile(journalHandle);
+            }
+        }
+
+        bool WorkflowJournal::StartJournal() {
+            // A journal without valid records is started again for the current base
+            if (journalSize == 0) {
+                std::string header;
+                AppendJournalHeader(header, baseHash);
+
+                journalHandle = OpenForAppend(journalPath, true);
+                if (journalHandle == ClosedHandle) {
+                    return false;
+                }
+
+                if (!WriteAll(journalHandle, header.data(), header.size()) || !SyncFile(journalHandle)) {
+                    CloseFile(journalHandle);
+                    journalHandle = ClosedHandle;
+                    return false;
+                }
+
+                journalSize = header.size();
+                return true;
+            }
+
+            journalHandle = OpenForAppend(journalPath, false);
+            return journalHandle != ClosedHandle;
+        }
+
+        bool WorkflowJournal::Save(const WorkspaceBuilder::Structs::Workflow& newWorkflow) {
+            WorkspaceBuilder::Structs::WorkflowDiff diff = WorkspaceBuilder::Functions::DiffWorkflows(workflow, newWorkflow);
+
+            if (diff.IsEmpty()) {
+                return true;
+            }
+
+            if (journalHandle == ClosedHandle && !StartJournal()) {
+                return false;
+            }
+
+            // The record header is filled once the payload size is known
+            record.assign(RecordHeaderSize, '\0');
+            AppendDiff(record, diff);
+
+            uint32_t payloadSize = (uint32_t)(record.size() - RecordHeaderSize);
+            uint64_t payloadHash = WorkspaceBuilder::SupportFunctions::HashLine(std::string_view(record).substr(RecordHeaderSize));
+            memcpy(&record[0], &payloadSize, sizeof(payloadSize));
+            memcpy(&record[4], &payloadHash, sizeof(payloadHash));
+
+            if (!WriteAll(journalHandle, record.data(), record.size())) {
+                // A partial record would hide every record appended after it
+                CloseFile(journalHandle);
+                journalHandle = ClosedHandle;
+
+                std::error_code error;
+                std::filesystem::resize_file(journalPath, journalSize, error);
+                if (error) journalSize = 0;
+
+                return false;
+            }
+
+            journalSize += record.size();
+            WorkspaceBuilder::Functions::ApplyWorkflowDiff(workflow, diff);
+
+            bool isSaved = true;
+            if (++unsyncedRecords >= options.recordsPerSync) {
+                isSaved = Sync();
+            }
+
+            if (journalSize > options.compactionSize) {
+                Compact();
+            }
+
+            return isSaved;
+        }
+
+        bool WorkflowJournal::Sync() {
+            if (journalHandle == ClosedHandle || unsyncedRecords == 0) {
+                return true;
+            }
+
+            if (!SyncFile(journalHandle)) {
+                return false;
+            }
+
+            unsyncedRecords = 0;
+            return true;
+        }
+
+        bool WorkflowJournal::Compact() {
+            std::string text;
+            WorkspaceBuilder::Functions::SerializeWorkflow(workflow, text);
+
+            std::string temporaryPath = WorkspaceBuilder::SupportFunctions::GetTemporaryPath(path);
+            std::error_code error;
+            bool isWritten = WriteFileDurably(temporaryPath, text);
+
+            if (isWritten) {
+                std::filesystem::rename(temporaryPath, path, error);
+                isWritten = !error;
+            }
+            if (!isWritten) {
+                std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
+
+            SyncDirectory(path);
+
+            // From here the old journal doesn't match the wksp file hash, a crash before it is replaced can't apply it twice
+            baseHash = WorkspaceBuilder::SupportFunctions::HashLine(text);
+
+            // The saved workflow becomes what a load of the new file gives, since the text doesn't keep every field
+            workflow = WorkspaceBuilder::Functions::ParseWorkflowBuffer(text);
+
+            if (journalHandle != ClosedHandle) {
+                CloseFile(journalHandle);
+                journalHandle = ClosedHandle;
+            }
+            journalSize = 0;
+            unsyncedRecords = 0;
+
+            return StartJournal();
+        }
+    }
+
+    namespace Functions {
+
+        WorkspaceBuilder::Structs::Workflow LoadJournaledWorkflow(const std::string& path) {
+            // WorkflowJournal refuses compressed files, so they never have a journal and are parsed while they are inflated
+            if (WorkspaceBuilder::SupportFunctions::IsGzipPath(path)) {
+                return LoadWorkflow(path);
+            }
+
+            WorkspaceBuilder::SupportFunctions::MappedFile file(path);
+            uint64_t baseHash = WorkspaceBuilder::SupportFunctions::HashLine(file.View());
+            WorkspaceBuilder::Structs::Workflow workflow = ParseWorkflowBuffer(file.View());
+
+            WorkspaceBuilder::Structs::ReplayJournal(WorkspaceBuilder::Structs::GetJournalPath(path), baseHash, workflow);
+
+            return workflow;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include "WorkflowDiff.h"
+#include <cstdint>
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        /*
+        * Edit journal (<wksp path>.journal). Every field is in the host byte order:
+        *   Header: magic 'WKSJ', version, byte order mark and the hash of the wksp file the journal applies to
+        *   Records: payload size, payload hash and a WorkflowDiff from the previous state, appended on every save
+        * A record cut by a crash fails its size or hash check and is dropped with everything after it.
+        * A journal whose base hash doesn't match the wksp file was already compacted into it and is ignored.
+        */
+
+        // When the journal is synced and compacted
+        struct JournalOptions {
+            // Records appended before the journal is synced to the disk. 1 syncs every save
+            int recordsPerSync = 16;
+            // The journal is compacted into the wksp file when it passes this size in bytes
+            size_t compactionSize = 4 * 1024 * 1024;
+        };
+
+        // A wksp file saved through an append only journal. Saving writes only what changed since the previous save
+        //   and the whole file is rewritten only when the journal is compacted.
+        class WorkflowJournal {
+        public:
+            /**
+            * Loads a wksp file and replays its journal. A missing wksp file starts an empty workflow
+            *
+            * @param path: The wksp file path. The journal is kept next to it
+            * @param options: When the journal is synced and compacted
+            *
+            * @throws A .gz file can't be journaled > if the path ends with ".gz" || Not a valid format > if the wksp file is not a valid workflow
+            */
+            explicit WorkflowJournal(const std::string& path, JournalOptions options = JournalOptions());
+            // Syncs the records not synced yet
+            ~WorkflowJournal();
+
+            WorkflowJournal(const WorkflowJournal&) = delete;
+            WorkflowJournal& operator=(const WorkflowJournal&) = delete;
+
+            // The saved workflow: the wksp file with every journal record applied
+            const WorkspaceBuilder::Structs::Workflow& Workflow() const { return workflow; }
+            // Bytes in the journal file
+            size_t JournalSize() const { return journalSize; }
+
+            /**
+            * Appends the changes from the saved workflow to the given one. Compacts the journal when it is too big
+            *
+            * @param newWorkflow: The workflow to be saved
+            * @return A boolean telling if the changes were written or not. The saved workflow only changes when they were
+            *
+            * @throws Block id is repeated> if the workflow has two blocks with the same id
+            */
+            bool Save(const WorkspaceBuilder::Structs::Workflow& newWorkflow);
+
+            /**
+            * Forces the appended records to the disk
+            *
+            * @return A boolean telling if the journal was synced or not
+            */
+            bool Sync();
+
+            /**
+            * Writes the saved workflow into a temporary file, renames it over the wksp file and starts an empty journal
+            *
+            * @return A boolean telling if the wksp file was replaced or not. The journal is kept when it wasn't
+            */
+            bool Compact();
+
+        private:
+            bool StartJournal();
+
+            std::string path;
+            std::string journalPath;
+            JournalOptions options;
+            WorkspaceBuilder::Structs::Workflow workflow;
+            // Hash of the wksp file content
+            uint64_t baseHash = 0;
+            size_t journalSize = 0;
+            int unsyncedRecords = 0;
+            // Reused between saves
+            std::string record;
+#ifdef _WIN32
+            void* journalHandle = nullptr;
+#else
+            int journalHandle = -1;
+#endif
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Loads a wksp file and replays its journal without changing any file. A .wksp.gz file never has a journal, it is only loaded
+        *
+        * @param path: The wksp file path
+        * @return The workflow as it was last saved
+        *
+        * @throws Unable to open file> if the wksp file doesn't exist || Not a valid format > if it is not a valid workflow
+        */
+        WorkspaceBuilder::Structs::Workflow LoadJournaledWorkflow(const std::string& path);
+    }
+    #pragma endregion
+}
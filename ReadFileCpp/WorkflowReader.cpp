@@ -0,0 +1,128 @@
+#include "WorkflowReader.h"
+#include "Metrics.h"
+
+#include <cstring>
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        // Line sink of DispatchLine that parses only what the callbacks listen to
+        struct ReaderLineSink {
+            const WorkspaceBuilder::Structs::WorkflowReaderCallbacks& callbacks;
+            bool verbose;
+            int connectionCount;
+            // Reused for the variables of every glyph
+            std::vector<WorkspaceBuilder::Structs::VariableView> glyphVariables;
+
+            void OnGlobalVariable(std::string_view line, [[maybe_unused]] int lineNumber) {
+                if (callbacks.onVariable) {
+                    callbacks.onVariable(ParseGlobalVariableLineView(line));
+                }
+            }
+
+            void OnComment(std::string_view text, int lineNumber) {
+                static const WorkspaceBuilder::Structs::Vector2 nullPosition = { 0.0, 0.0 };
+                if (callbacks.onComment) {
+                    callbacks.onComment({ lineNumber, text, nullPosition });
+                }
+            }
+
+            void OnGlyph(std::string_view line, int lineNumber) {
+                WORKSPACE_BUILDER_VERBOSE(verbose, "Found Glyph on line " << lineNumber << ">>> " << line << '\n');
+
+                if (callbacks.onGlyph) {
+                    glyphVariables.clear();
+                    callbacks.onGlyph(ParseBlockLineView(line, glyphVariables, verbose), glyphVariables);
+                }
+            }
+
+            void OnConnection(std::string_view line, [[maybe_unused]] int lineNumber) {
+                // Ids are counted even when nobody listens so they match ParseWorkflowConnections
+                if (callbacks.onConnection) {
+                    callbacks.onConnection(ParseConnectionLineView(line, connectionCount, verbose));
+                }
+                connectionCount++;
+            }
+        };
+
+        int ReadWorkflow(std::istream& stream, const WorkspaceBuilder::Structs::WorkflowReaderCallbacks& callbacks, size_t chunkSize, bool verbose) {
+            if (chunkSize == 0) {
+                throw std::runtime_error("ReadWorkflow error >> Chunk size must be greater than zero");
+            }
+
+            WorkspaceBuilder::Structs::LineCursor cursor;
+            ReaderLineSink sink = { callbacks, verbose, 0, {} };
+
+            // Holds the current chunk plus the unfinished line of the previous one
+            std::vector<char> buffer(chunkSize);
+            size_t used = 0;
+
+            auto handleLine = [&](std::string_view chunkLine) {
+                size_t lineOffset = 0;
+                // Removes the '\r' of Windows line endings
+                std::string_view line = WorkspaceBuilder::SupportFunctions::NextLine(chunkLine, lineOffset);
+                WorkspaceBuilder::Structs::LineClass lineClass = WorkspaceBuilder::SupportFunctions::AdvanceLine(line, cursor);
+
+                WorkspaceBuilder::SupportFunctions::DispatchLine(line, lineClass, cursor.lineNumber, sink);
+            };
+
+            while (true) {
+                // A line longer than the buffer makes it grow
+                if (used == buffer.size()) {
+                    buffer.resize(buffer.size() * 2);
+                }
+
+                stream.read(buffer.data() + used, buffer.size() - used);
+                size_t readCount = (size_t)stream.gcount();
+                size_t scanStart = used;
+                used += readCount;
+
+                size_t lineStart = 0;
+                for (const char* lineEnd = (const char*)memchr(buffer.data() + scanStart, '\n', used - scanStart);
+                    lineEnd != nullptr;
+                    lineEnd = (const char*)memchr(buffer.data() + lineStart, '\n', used - lineStart)) {
+                    size_t lineEndIndex = lineEnd - buffer.data();
+
+                    handleLine(std::string_view(buffer.data() + lineStart, lineEndIndex - lineStart));
+                    lineStart = lineEndIndex + 1;
+                }
+
+                if (readCount == 0) {
+                    // Last line without line break
+                    if (lineStart < used) {
+                        handleLine(std::string_view(buffer.data() + lineStart, used - lineStart));
+                    }
+                    break;
+                }
+
+                // Keeps the unfinished line in the front of the buffer
+                used -= lineStart;
+                memmove(buffer.data(), buffer.data() + lineStart, used);
+            }
+
+            return cursor.lineNumber;
+        }
+
+        int ReadWorkflowFile(const std::string& path, const WorkspaceBuilder::Structs::WorkflowReaderCallbacks& callbacks, size_t chunkSize, bool verbose) {
+            // Compressed files are read in the chunks of the inflater, each line is sent to the callbacks as soon as it is inflated
+            if (WorkspaceBuilder::SupportFunctions::IsGzipPath(path)) {
+                WorkspaceBuilder::Structs::LineCursor cursor;
+                ReaderLineSink sink = { callbacks, verbose, 0, {} };
+
+                WorkspaceBuilder::SupportFunctions::DispatchGzipLines(path, cursor, sink);
+
+                return cursor.lineNumber;
+            }
+
+            // Binary mode so the chunks are not translated, line endings are handled by the reader
+            std::ifstream myFile(path, std::ios::in | std::ios::binary);
+
+            // Tell the runtime that an error ocurred while opening the file
+            if (myFile.fail()) {
+                throw std::runtime_error("ReadWorkflowFile error >> Unable to open file");
+            }
+
+            return ReadWorkflow(myFile, callbacks, chunkSize, verbose);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include <functional>
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // Functions called by ReadWorkflow for each element found in a wksp file.
+        //   Empty callbacks are skipped and their lines are not parsed.
+        //   The views are only valid during the call, copy what must be kept.
+        struct WorkflowReaderCallbacks {
+            // Called for each Glyph line. The block variables are in the given list starting at index 0
+            std::function<void(const BlockView& block, const std::vector<VariableView>& variables)> onGlyph;
+            // Called for each NodeConnection line. Port names are kept as written in the file
+            std::function<void(const ConnectionView& connection)> onConnection;
+            // Called for each global variable
+            std::function<void(const VariableView& variable)> onVariable;
+            // Called for each comment line
+            std::function<void(const CommentView& comment)> onComment;
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Reads a wksp stream in fixed size chunks and reports every element through callbacks.
+        *   Neither the file lines nor the workflow are kept, memory only grows with the longest line.
+        *
+        * @param stream: The stream with the wksp content. Should be opened in binary mode
+        * @param callbacks: Functions called for each element found
+        * @param chunkSize: Bytes read from the stream at a time. Default = 64KB
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return The number of lines read
+        *
+        * @throws Not a valid format > if a variable is declared and is not following the pattern 'key value'
+        */
+        int ReadWorkflow(std::istream& stream, const WorkspaceBuilder::Structs::WorkflowReaderCallbacks& callbacks, size_t chunkSize = 64 * 1024, bool verbose = false);
+
+        /**
+        * Opens a wksp file and reads it with ReadWorkflow. A .wksp.gz file is read while it is inflated, in 64KB chunks
+        *
+        * @param path: The string address of a valid file
+        * @param callbacks: Functions called for each element found
+        * @param chunkSize: Bytes read from the file at a time, not used for a .wksp.gz file. Default = 64KB
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return The number of lines read
+        *
+        * @throws Unable to open file> if the given path is invalid || Not a valid gzip file> if a .gz file is broken
+        */
+        int ReadWorkflowFile(const std::string& path, const WorkspaceBuilder::Structs::WorkflowReaderCallbacks& callbacks, size_t chunkSize = 64 * 1024, bool verbose = false);
+    }
+    #pragma endregion
+}
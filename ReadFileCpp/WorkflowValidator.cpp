@@ -0,0 +1,195 @@
+#include "WorkflowValidator.h"
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        // Name of a variable type used in the issue messages
+        static const char* GetVariableTypeName(WorkspaceBuilder::Enums::VariableType type) {
+            switch (type) {
+            case WorkspaceBuilder::Enums::VariableType::Integer: return "integer";
+            case WorkspaceBuilder::Enums::VariableType::Double: return "double";
+            case WorkspaceBuilder::Enums::VariableType::String: return "string";
+            case WorkspaceBuilder::Enums::VariableType::Image: return "image";
+            case WorkspaceBuilder::Enums::VariableType::Data: return "data";
+            case WorkspaceBuilder::Enums::VariableType::Array: return "array";
+            case WorkspaceBuilder::Enums::VariableType::Unknown: return "unknown";
+            }
+            return "unknown";
+        }
+
+        // Port with the given name, or null. Glyphs have a handful of ports so a linear search is the fastest lookup
+        template <typename Port>
+        static const Port* FindPort(const std::vector<Port>& ports, const std::string& name) {
+            for (const Port& port : ports) {
+                if (port.name == name) return &port;
+            }
+            return nullptr;
+        }
+
+        static void AddIssue(WorkspaceBuilder::Structs::ValidationReport& report, WorkspaceBuilder::Enums::ValidationIssueType type, int blockIndex, int connectionIndex, std::string message) {
+            report.issues.push_back({ type, blockIndex, connectionIndex, std::move(message) });
+        }
+
+        void AddGlyphSignature(WorkspaceBuilder::Structs::GlyphCatalogue& catalogue, const std::string& type,
+            const std::vector<std::pair<std::string, std::string>>& inputs, const std::vector<std::pair<std::string, std::string>>& outputs) {
+            WorkspaceBuilder::Structs::GlyphSignature signature;
+
+            // Connection port names are stored in lower case
+            for (const std::pair<std::string, std::string>& input : inputs) {
+                signature.inputs.push_back(ParseInput(input.first, input.second));
+                WorkspaceBuilder::SupportFunctions::ToLower(signature.inputs.back().name);
+            }
+
+            for (const std::pair<std::string, std::string>& output : outputs) {
+                signature.outputs.push_back(ParseOutput(output.first, output.second));
+                WorkspaceBuilder::SupportFunctions::ToLower(signature.outputs.back().name);
+            }
+
+            catalogue[type] = std::move(signature);
+        }
+
+        WorkspaceBuilder::Structs::ValidationReport ValidateWorkflow(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow,
+            const WorkspaceBuilder::Structs::GlyphCatalogue& catalogue) {
+            WorkspaceBuilder::Structs::ValidationReport report;
+            size_t blockCount = workflow.blocks.size();
+            bool checkPorts = !catalogue.empty();
+
+            // Blocks: repeated ids and signatures, resolved once per block
+            std::vector<const WorkspaceBuilder::Structs::GlyphSignature*> signatures(blockCount, nullptr);
+            for (size_t i = 0; i < blockCount; i++) {
+                const WorkspaceBuilder::Structs::Block& block = workflow.blocks[i];
+                int firstIndex = FindBlockIndex(graph, block.id);
+
+                if (firstIndex != (int)i) {
+                    AddIssue(report, WorkspaceBuilder::Enums::ValidationIssueType::DuplicateBlockId, (int)i, -1,
+                        "Block " + std::to_string(block.id) + " has the same id of the block in position " + std::to_string(firstIndex));
+                }
+
+                if (checkPorts) {
+                    WorkspaceBuilder::Structs::GlyphCatalogue::const_iterator signature = catalogue.find(block.type);
+
+                    if (signature == catalogue.end()) {
+                        AddIssue(report, WorkspaceBuilder::Enums::ValidationIssueType::UnknownGlyph, (int)i, -1,
+                            "Block " + std::to_string(block.id) + " has the unknown glyph type " + block.type);
+                    }
+                    else {
+                        signatures[i] = &signature->second;
+                    }
+                }
+            }
+
+            // Connections: dangling ends, ports and types
+            for (size_t i = 0; i < workflow.connections.size(); i++) {
+                const WorkspaceBuilder::Structs::Connection& connection = workflow.connections[i];
+                int startBlock = FindBlockIndex(graph, connection.startBlock);
+                int endBlock = FindBlockIndex(graph, connection.endBlock);
+
+                if (startBlock < 0) {
+                    AddIssue(report, WorkspaceBuilder::Enums::ValidationIssueType::DanglingStartBlock, -1, (int)i,
+                        "Connection " + std::to_string(connection.id) + " starts in block " + std::to_string(connection.startBlock) + " that doesn't exist");
+                }
+
+                if (endBlock < 0) {
+                    AddIssue(report, WorkspaceBuilder::Enums::ValidationIssueType::DanglingEndBlock, -1, (int)i,
+                        "Connection " + std::to_string(connection.id) + " finishes in block " + std::to_string(connection.endBlock) + " that doesn't exist");
+                }
+
+                const WorkspaceBuilder::Structs::Output* output = nullptr;
+                const WorkspaceBuilder::Structs::Input* input = nullptr;
+
+                if (startBlock >= 0 && signatures[startBlock] != nullptr) {
+                    output = FindPort(signatures[startBlock]->outputs, connection.outputStartBlock);
+
+                    if (output == nullptr) {
+                        AddIssue(report, WorkspaceBuilder::Enums::ValidationIssueType::MissingOutput, startBlock, (int)i,
+                            "Connection " + std::to_string(connection.id) + " starts in output " + connection.outputStartBlock + " that glyph " + workflow.blocks[startBlock].type + " doesn't have");
+                    }
+                }
+
+                if (endBlock >= 0 && signatures[endBlock] != nullptr) {
+                    input = FindPort(signatures[endBlock]->inputs, connection.inputEndBlock);
+
+                    if (input == nullptr) {
+                        AddIssue(report, WorkspaceBuilder::Enums::ValidationIssueType::MissingInput, endBlock, (int)i,
+                            "Connection " + std::to_string(connection.id) + " finishes in input " + connection.inputEndBlock + " that glyph " + workflow.blocks[endBlock].type + " doesn't have");
+                    }
+                }
+
+                if (output != nullptr && input != nullptr && output->type != input->type) {
+                    AddIssue(report, WorkspaceBuilder::Enums::ValidationIssueType::TypeMismatch, endBlock, (int)i,
+                        "Connection " + std::to_string(connection.id) + " sends " + GetVariableTypeName(output->type) + " from output " + connection.outputStartBlock
+                        + " to input " + connection.inputEndBlock + " that expects " + GetVariableTypeName(input->type));
+                }
+            }
+
+            // Inputs fed twice. Incoming connections are sorted by input name, so repeated names are neighbours
+            for (size_t block = 0; block < blockCount; block++) {
+                WorkspaceBuilder::Structs::ConnectionRange incoming = GetIncomingConnections(graph, (int)block);
+
+                for (const int* connection = incoming.begin(); connection != incoming.end(); connection++) {
+                    if (connection != incoming.begin() && workflow.connections[*connection].inputEndBlock == workflow.connections[*(connection - 1)].inputEndBlock) {
+                        AddIssue(report, WorkspaceBuilder::Enums::ValidationIssueType::InputConnectedTwice, (int)block, *connection,
+                            "Input " + workflow.connections[*connection].inputEndBlock + " of block " + std::to_string(workflow.blocks[block].id) + " receives more than one connection");
+                    }
+                }
+            }
+
+            // Cycles: Kahn's algorithm removes every block that doesn't depend on a cycle,
+            //   then the same walk backwards removes the blocks that only come after one
+            std::vector<int> pendingInputs(blockCount);
+            std::vector<int> pendingOutputs(blockCount);
+            std::vector<bool> removed(blockCount, false);
+            std::vector<int> queue;
+            queue.reserve(blockCount);
+
+            for (size_t i = 0; i < blockCount; i++) {
+                pendingInputs[i] = (int)GetIncomingConnections(graph, (int)i).size();
+                if (pendingInputs[i] == 0) queue.push_back((int)i);
+            }
+
+            for (size_t next = 0; next < queue.size(); next++) {
+                removed[queue[next]] = true;
+
+                for (int connection : GetOutgoingConnections(graph, queue[next])) {
+                    int endBlock = FindBlockIndex(graph, workflow.connections[connection].endBlock);
+                    if (--pendingInputs[endBlock] == 0) queue.push_back(endBlock);
+                }
+            }
+
+            if (queue.size() != blockCount) {
+                queue.clear();
+
+                // Only connections between the remaining blocks count
+                for (size_t i = 0; i < blockCount; i++) {
+                    if (removed[i]) continue;
+
+                    for (int connection : GetOutgoingConnections(graph, (int)i)) {
+                        if (!removed[FindBlockIndex(graph, workflow.connections[connection].endBlock)]) pendingOutputs[i]++;
+                    }
+                    if (pendingOutputs[i] == 0) queue.push_back((int)i);
+                }
+
+                for (size_t next = 0; next < queue.size(); next++) {
+                    removed[queue[next]] = true;
+
+                    for (int connection : GetIncomingConnections(graph, queue[next])) {
+                        int startBlock = FindBlockIndex(graph, workflow.connections[connection].startBlock);
+                        if (!removed[startBlock] && --pendingOutputs[startBlock] == 0) queue.push_back(startBlock);
+                    }
+                }
+
+                for (size_t i = 0; i < blockCount; i++) {
+                    if (removed[i]) continue;
+
+                    report.cycleBlocks.push_back((int)i);
+                    AddIssue(report, WorkspaceBuilder::Enums::ValidationIssueType::CycleBlock, (int)i, -1,
+                        "Block " + std::to_string(workflow.blocks[i].id) + " is part of a cycle");
+                }
+            }
+
+            report.isValid = report.issues.empty();
+
+            return report;
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include "WorkflowGraph.h"
+#include <unordered_map>
+#include <utility>
+
+namespace WorkspaceBuilder {
+    #pragma region Enums
+    namespace Enums {
+        // Problems found by ValidateWorkflow
+        enum ValidationIssueType {
+            // Two blocks share the same id. Connections reach the first one
+            DuplicateBlockId,
+            // The connection starts in a block id that doesn't exist
+            DanglingStartBlock,
+            // The connection finishes in a block id that doesn't exist
+            DanglingEndBlock,
+            // The block type is not in the glyph catalogue
+            UnknownGlyph,
+            // The connection starts in an output the glyph doesn't have
+            MissingOutput,
+            // The connection finishes in an input the glyph doesn't have
+            MissingInput,
+            // The output and input types of the connection are different
+            TypeMismatch,
+            // More than one connection finishes in the same input
+            InputConnectedTwice,
+            // The block is part of a cycle
+            CycleBlock
+        };
+    }
+    #pragma endregion
+
+    #pragma region Structs
+    namespace Structs {
+        // Ports a glyph declares. Port names are in lower case, like in the connections
+        struct GlyphSignature {
+            std::vector<Input> inputs;
+            std::vector<Output> outputs;
+        };
+
+        // Signature of each Block::type
+        typedef std::unordered_map<std::string, GlyphSignature> GlyphCatalogue;
+
+        // One problem found in a workflow
+        struct ValidationIssue {
+            WorkspaceBuilder::Enums::ValidationIssueType type;
+            // Block position in Workflow::blocks, or -1
+            int blockIndex;
+            // Connection position in Workflow::connections, or -1
+            int connectionIndex;
+            std::string message;
+        };
+
+        // Result of a workflow validation
+        struct ValidationReport {
+            // True when no issue was found
+            bool isValid = true;
+            // Issues grouped by kind: blocks first, then connections, then cycles
+            std::vector<ValidationIssue> issues;
+            // Blocks that are in a cycle or in a path between two cycles, in file order
+            std::vector<int> cycleBlocks;
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Adds the ports of a glyph to a catalogue, replacing any previous signature of the same type
+        *
+        * @param catalogue: The catalogue to be filled
+        * @param type: The Block::type of the glyph
+        * @param inputs: Pairs of input name and type string, like { "img", "image" }
+        * @param outputs: Pairs of output name and type string
+        */
+        void AddGlyphSignature(WorkspaceBuilder::Structs::GlyphCatalogue& catalogue, const std::string& type,
+            const std::vector<std::pair<std::string, std::string>>& inputs, const std::vector<std::pair<std::string, std::string>>& outputs);
+
+        /**
+        * Checks block ids, connection ends, ports, port types and cycles in O(blocks + connections).
+        *   Ports and types are only checked when the catalogue is not empty.
+        *
+        * @param graph: The workflow graph
+        * @param workflow: The indexed workflow
+        * @param catalogue: The signatures of the glyphs used by the workflow
+        * @return Every issue found. The validation doesn't stop in the first one
+        */
+        WorkspaceBuilder::Structs::ValidationReport ValidateWorkflow(const WorkspaceBuilder::Structs::WorkflowGraph& graph, const WorkspaceBuilder::Structs::Workflow& workflow,
+            const WorkspaceBuilder::Structs::GlyphCatalogue& catalogue = WorkspaceBuilder::Structs::GlyphCatalogue());
+    }
+    #pragma endregion
+}
@@ -0,0 +1,119 @@
+#include "WorkflowView.h"
+#include "GzipStream.h"
+#include "Metrics.h"
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        // Line sink of DispatchLine that adds slices of each line to the view lists
+        struct ViewLineSink {
+            WorkspaceBuilder::Structs::WorkflowView& view;
+            bool verbose;
+
+            void OnGlobalVariable(std::string_view line, [[maybe_unused]] int lineNumber) {
+                view.globalVariables.push_back(ParseGlobalVariableLineView(line));
+            }
+
+            void OnComment(std::string_view text, int lineNumber) {
+                static const WorkspaceBuilder::Structs::Vector2 nullPosition = { 0.0, 0.0 };
+                view.comments.push_back({ lineNumber, text, nullPosition });
+            }
+
+            void OnGlyph(std::string_view line, int lineNumber) {
+                WORKSPACE_BUILDER_VERBOSE(verbose, "Found Glyph on line " << lineNumber << ">>> " << line << '\n');
+
+                view.blocks.push_back(ParseBlockLineView(line, view.blockVariables, verbose));
+            }
+
+            void OnConnection(std::string_view line, [[maybe_unused]] int lineNumber) {
+                view.connections.push_back(ParseConnectionLineView(line, (int)view.connections.size(), verbose));
+            }
+        };
+
+        // Fills the view lists with slices of buffer. The buffer must already be owned by the view
+        static void ParseIntoWorkflowView(WorkspaceBuilder::Structs::WorkflowView& view, std::string_view buffer, bool verbose) {
+            WorkspaceBuilder::Structs::LineCursor cursor;
+            ViewLineSink sink = { view, verbose };
+
+            WorkspaceBuilder::SupportFunctions::DispatchLines(buffer, cursor, sink);
+        }
+
+        WorkspaceBuilder::Structs::WorkflowView ParseWorkflowView(std::string_view buffer, bool verbose) {
+            WorkspaceBuilder::Structs::WorkflowView view;
+
+            view.ownedBuffer.assign(buffer.begin(), buffer.end());
+            ParseIntoWorkflowView(view, std::string_view(view.ownedBuffer.data(), view.ownedBuffer.size()), verbose);
+
+            return view;
+        }
+
+        WorkspaceBuilder::Structs::WorkflowView LoadWorkflowView(const std::string& path, bool verbose) {
+            WorkspaceBuilder::Structs::WorkflowView view;
+
+            // The views need the whole text, so unlike the other loaders a compressed file is inflated whole into the owned buffer
+            if (WorkspaceBuilder::SupportFunctions::IsGzipPath(path)) {
+                WorkspaceBuilder::SupportFunctions::InflateGzipFile(path, [&](const char* data, size_t size) {
+                    view.ownedBuffer.insert(view.ownedBuffer.end(), data, data + size);
+                });
+                ParseIntoWorkflowView(view, std::string_view(view.ownedBuffer.data(), view.ownedBuffer.size()), verbose);
+
+                return view;
+            }
+
+            view.mappedBuffer = WorkspaceBuilder::SupportFunctions::MappedFile(path);
+            ParseIntoWorkflowView(view, view.mappedBuffer.View(), verbose);
+
+            return view;
+        }
+
+        WorkspaceBuilder::Structs::Workflow ConvertWorkflowViewToWorkflow(const WorkspaceBuilder::Structs::WorkflowView& view) {
+            WorkspaceBuilder::Structs::Workflow workflow;
+
+            workflow.globalVariables.reserve(view.globalVariables.size());
+            for (const WorkspaceBuilder::Structs::VariableView& variable : view.globalVariables) {
+                workflow.globalVariables.push_back(WorkspaceBuilder::Functions::ConvertVariableViewToVariable(variable));
+            }
+
+            workflow.blocks.reserve(view.blocks.size());
+            for (const WorkspaceBuilder::Structs::BlockView& blockView : view.blocks) {
+                WorkspaceBuilder::Structs::Block block;
+                block.id = blockView.id;
+                block.type = std::string(blockView.type);
+                block.hostMachine = std::string(blockView.hostMachine);
+                block.position = blockView.position;
+
+                block.variables.reserve(blockView.variableCount);
+                for (size_t i = blockView.firstVariable; i < blockView.firstVariable + blockView.variableCount; i++) {
+                    const WorkspaceBuilder::Structs::VariableView& variable = view.blockVariables[i];
+                    block.variables.push_back(WorkspaceBuilder::Functions::ConvertVariableViewToVariable(variable));
+                }
+
+                workflow.blocks.push_back(std::move(block));
+            }
+
+            workflow.connections.reserve(view.connections.size());
+            for (const WorkspaceBuilder::Structs::ConnectionView& connectionView : view.connections) {
+                WorkspaceBuilder::Structs::Connection connection = {
+                    connectionView.id,
+                    connectionView.startBlock,
+                    std::string(connectionView.outputStartBlock.size(), '\0'),
+                    connectionView.endBlock,
+                    std::string(connectionView.inputEndBlock.size(), '\0')
+                };
+
+                // Port names are case insensitive, they are lowered while copied
+                WorkspaceBuilder::SupportFunctions::ToLower(connectionView.outputStartBlock, &connection.outputStartBlock[0]);
+                WorkspaceBuilder::SupportFunctions::ToLower(connectionView.inputEndBlock, &connection.inputEndBlock[0]);
+
+                workflow.connections.push_back(std::move(connection));
+            }
+
+            workflow.comments.reserve(view.comments.size());
+            for (const WorkspaceBuilder::Structs::CommentView& comment : view.comments) {
+                workflow.comments.push_back({ comment.line, std::string(comment.text), comment.position });
+            }
+
+            return workflow;
+        }
+    }
+}
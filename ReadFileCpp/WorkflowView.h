@@ -0,0 +1,64 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include "MappedFile.h"
+
+namespace WorkspaceBuilder {
+    #pragma region Structs
+    namespace Structs {
+        // Read only workflow whose texts are slices of a single buffer.
+        //   The buffer is owned by the view, so it can be moved but not copied.
+        struct WorkflowView {
+            // Variables that can be used in any function/block
+            std::vector<VariableView> globalVariables;
+            // The blocks represents a VGL function that is called in the workflow
+            std::vector<BlockView> blocks;
+            // The connections between the blocks inside a workflow
+            std::vector<ConnectionView> connections;
+            // Comments of the workflow file
+            std::vector<CommentView> comments;
+            // Variables of every block. Each block points to its range with firstVariable and variableCount
+            std::vector<VariableView> blockVariables;
+
+            // Copy of the parsed text when it didn't come from a file, or the inflated text of a .gz file
+            std::vector<char> ownedBuffer;
+            // Mapping of the parsed file
+            WorkspaceBuilder::SupportFunctions::MappedFile mappedBuffer;
+        };
+    }
+    #pragma endregion
+
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Parses a wksp file content into a read only workflow. The content is copied once into the view.
+        *
+        * @param buffer: The wksp file content
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return A workflow view that owns a copy of the buffer
+        */
+        WorkspaceBuilder::Structs::WorkflowView ParseWorkflowView(std::string_view buffer, bool verbose = false);
+
+        /**
+        * Memory maps a wksp file and parses it into a read only workflow without copying any text.
+        *   A .wksp.gz file is not streamed: the views point into the text, so the whole file is inflated into the view owned
+        *   buffer before parsing and stays there as long as the view
+        *
+        * @param path: The string address of a valid file
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return A workflow view that owns the file mapping or the inflated text
+        *
+        * @throws Unable to open file> if the given path is invalid || Not a valid gzip file> if a .gz file is broken
+        */
+        WorkspaceBuilder::Structs::WorkflowView LoadWorkflowView(const std::string& path, bool verbose = false);
+
+        /**
+        * Copies a workflow view into an owning workflow structure.
+        *   Connection port names are converted to lower case like ParseConnectionLine does.
+        *
+        * @param view: The workflow view to be copied
+        * @return A VGL Workflow structure
+        */
+        WorkspaceBuilder::Structs::Workflow ConvertWorkflowViewToWorkflow(const WorkspaceBuilder::Structs::WorkflowView& view);
+    }
+    #pragma endregion
+}
@@ -0,0 +1,195 @@
+#include "WorkflowWriter.h"
+#include "GzipStream.h"
+#include "Metrics.h"
+
+#include <charconv>
+#include <limits>
+
+namespace WorkspaceBuilder {
+    namespace Functions {
+
+        static void AppendInteger(std::string& output, int value) {
+            char digits[16];
+            std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+
+            output.append(digits, result.ptr - digits);
+        }
+
+        // Finishes the line started at lineStart the same way SaveWkspfile does: one trailing space is removed and '\n' is added
+        static void EndLine(std::string& output, size_t lineStart) {
+            if (output.size() > lineStart && output.back() == ' ') {
+                output.pop_back();
+            }
+
+            output.push_back('\n');
+        }
+
+        static void AppendLine(std::string& output, const char* text) {
+            size_t lineStart = output.size();
+            output.append(text);
+            EndLine(output, lineStart);
+        }
+
+        static void AppendEmptyLines(std::string& output, int count) {
+            output.append(count, '\n');
+        }
+
+        // Variable values are quoted back when they are strings
+        template <typename Variable>
+        static void AppendValue(std::string& output, const Variable& var) {
+            if (var.type == WorkspaceBuilder::Enums::String) {
+                output.push_back('\'');
+                output.append(var.value);
+                output.push_back('\'');
+            }
+            else {
+                output.append(var.value);
+            }
+        }
+
+        // Writes the whole workflow calling flush every time output passes batchSize. Workflow is Workflow or PmrWorkflow
+        template <typename Workflow, typename Flush>
+        static void SerializeWorkflowInBatches(const Workflow& workflow, std::string& output, size_t batchSize, Flush flush) {
+            // Insert header
+            AppendLine(output, "# VisionGL Visual Programming Workspace");
+            AppendLine(output, "# ");
+            AppendLine(output, "# This is an auto generated file.");
+            AppendLine(output, "# All the code has been written by @luanxpg9 during the Thesis Conclusion Project from UFS");
+            AppendLine(output, "# ");
+            AppendEmptyLines(output, 3);
+
+            AppendLine(output, "WorkspaceBegin: 1.0");
+            AppendEmptyLines(output, 1);
+
+            // Insert Variables
+            AppendLine(output, "VariablesBegin: ");
+            for (const auto& var : workflow.globalVariables) {
+                size_t lineStart = output.size();
+
+                output.append(var.key).append(" = ");
+                AppendValue(output, var);
+                EndLine(output, lineStart);
+            }
+            AppendLine(output, "VariablesEnd: ");
+            AppendEmptyLines(output, 2);
+
+            // Insert Glyphs
+            for (const auto& block : workflow.blocks) {
+                size_t lineStart = output.size();
+
+                output.append("Glyph:VGL_CL:");
+                output.append(block.type).push_back(':');
+                output.append(block.hostMachine).push_back(':');
+                AppendInteger(output, block.id);
+                output.push_back(':');
+                AppendInteger(output, (int)block.position.x);
+                output.push_back(':');
+                AppendInteger(output, (int)block.position.y);
+                output.append(": ");
+
+                for (const auto& var : block.variables) {
+                    output.push_back('-');
+                    output.append(var.key).push_back(' ');
+                    AppendValue(output, var);
+                    output.push_back(' ');
+                }
+
+                EndLine(output, lineStart);
+
+                if (output.size() >= batchSize) flush(output);
+            }
+            AppendEmptyLines(output, 2);
+
+            // Insert Connections
+            for (const auto& connection : workflow.connections) {
+                size_t lineStart = output.size();
+
+                output.append("NodeConnection:data:");
+                AppendInteger(output, connection.startBlock);
+                output.push_back(':');
+                output.append(connection.outputStartBlock).push_back(':');
+                AppendInteger(output, connection.endBlock);
+                output.push_back(':');
+                output.append(connection.inputEndBlock);
+                EndLine(output, lineStart);
+
+                if (output.size() >= batchSize) flush(output);
+            }
+            AppendEmptyLines(output, 2);
+
+            // Insert Comments
+            AppendLine(output, "AnnotationsBegin");
+            for (const auto& comment : workflow.comments) {
+                size_t lineStart = output.size();
+
+                output.push_back('#');
+                output.append(comment.text);
+                EndLine(output, lineStart);
+
+                if (output.size() >= batchSize) flush(output);
+            }
+            AppendLine(output, "AnnotationsEnd");
+            AppendEmptyLines(output, 2);
+
+            AppendLine(output, "WorkspaceEnd: 1.0");
+        }
+
+        void SerializeWorkflow(const WorkspaceBuilder::Structs::Workflow& workflow, std::string& output) {
+            WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::SerializePhase);
+            output.clear();
+
+            SerializeWorkflowInBatches(workflow, output, std::numeric_limits<size_t>::max(), [](std::string&) {});
+        }
+
+        void SerializeWorkflow(const WorkspaceBuilder::Structs::PmrWorkflow& workflow, std::string& output) {
+            WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::SerializePhase);
+            output.clear();
+
+            SerializeWorkflowInBatches(workflow, output, std::numeric_limits<size_t>::max(), [](std::string&) {});
+        }
+
+        bool WriteWorkflowFile(const std::string& filename, const WorkspaceBuilder::Structs::Workflow& workflow, std::string& buffer, size_t batchSize) {
+            WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::SerializePhase);
+
+            buffer.clear();
+            buffer.reserve(batchSize);
+
+            // Each batch is compressed as it is written, like SaveWkspfile does for .gz files
+            if (WorkspaceBuilder::SupportFunctions::IsGzipPath(filename)) {
+                WorkspaceBuilder::SupportFunctions::GzipWriter writer(filename);
+
+                if (!writer.IsOpen()) {
+                    return false;
+                }
+
+                SerializeWorkflowInBatches(workflow, buffer, batchSize, [&](std::string& output) {
+                    writer.Write(output);
+                    output.clear();
+                });
+
+                writer.Write(buffer);
+                buffer.clear();
+
+                return writer.Close();
+            }
+
+            // Text mode like SaveWkspfile so the line endings are the same
+            std::ofstream myFile(filename, std::ios::out);
+
+            if (!myFile) {
+                return false;
+            }
+
+            SerializeWorkflowInBatches(workflow, buffer, batchSize, [&](std::string& output) {
+                myFile.write(output.data(), output.size());
+                output.clear();
+            });
+
+            myFile.write(buffer.data(), buffer.size());
+            buffer.clear();
+            myFile.close();
+
+            return !myFile.fail();
+        }
+    }
+}
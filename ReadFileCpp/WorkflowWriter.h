@@ -0,0 +1,39 @@
+#pragma once
+#include "WorkspaceBuilder.h"
+#include "ArenaWorkflow.h"
+
+namespace WorkspaceBuilder {
+    #pragma region Functions
+    namespace Functions {
+        /**
+        * Writes a workflow in the wksp format straight into a text buffer.
+        *   The text is the same SaveWorkflow writes, without building a vector of lines.
+        *
+        * @param workflow: A reference to the VGL workflow struct.
+        * @param output: The buffer that receives the text. It is cleared first so its memory can be reused between calls
+        */
+        void SerializeWorkflow(const WorkspaceBuilder::Structs::Workflow& workflow, std::string& output);
+
+        /**
+        * Writes a workflow parsed into an arena in the wksp format, without copying it into a Workflow first
+        *
+        * @param workflow: The allocator aware workflow, like ArenaWorkflow::Workflow()
+        * @param output: The buffer that receives the text. It is cleared first so its memory can be reused between calls
+        */
+        void SerializeWorkflow(const WorkspaceBuilder::Structs::PmrWorkflow& workflow, std::string& output);
+
+        /**
+        * Saves a workflow to the given filename writing it in batches through a reusable buffer.
+        *   Existing file in this path shall be overridden. A filename ending with ".gz" is gzip compressed batch by batch.
+        *
+        * @param filename: The path where the file will be saved
+        * @param workflow: A reference to the VGL workflow struct.
+        * @param buffer: Memory used for the batches. Keep it between saves to avoid new allocations
+        * @param batchSize: The buffer is written to the file every time it passes this size. Default = 1MB
+        *
+        * @return A boolean telling if the file was completely written or not.
+        */
+        bool WriteWorkflowFile(const std::string& filename, const WorkspaceBuilder::Structs::Workflow& workflow, std::string& buffer, size_t batchSize = 1024 * 1024);
+    }
+    #pragma endregion
+}
@@ -1,12 +1,25 @@
 #pragma once
 #include "WorkspaceBuilder.h"
+#include "GlyphTokenizer.h"
+#include "GzipStream.h"
+#include "MappedFile.h"
+#include "Metrics.h"
+#include "TypedParameters.h"
+#include "WorkflowWriter.h"
+
+#include <cctype>
+#include <charconv>
 
 namespace WorkspaceBuilder {
 	namespace SupportFunctions {
 
 		void ToLower(std::string& str) {
-			for (int i = 0; i < str.size(); i++) {
-				str[i] = tolower(str[i]);
+			ToLower(str, &str[0]);
+		}
+
+		void ToLower(std::string_view text, char* output) {
+			for (size_t i = 0; i < text.size(); i++) {
+				output[i] = (char)tolower((unsigned char)text[i]);
 			}
 		}
 
@@ -35,18 +48,38 @@ namespace WorkspaceBuilder {
             int res = in1.compare(in2);
 
             if (res == 0) {
-                if (verbose) std::cout << "The strings are the same";
+                WORKSPACE_BUILDER_VERBOSE(verbose, "The strings are the same");
                 return 1;
             }
             else {
-                if (verbose) std::cout << "The strings don't match";
+                WORKSPACE_BUILDER_VERBOSE(verbose, "The strings don't match");
                 return 0;
             }
         }
 
         std::vector<std::string> GetLinesFromFile(const std::string& path) {
-            std::ifstream myFile(path);
+            WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::ReadPhase);
             std::vector<std::string> myLines;
+
+            // Compressed files are inflated in chunks and give the same lines getline would
+            if (WorkspaceBuilder::SupportFunctions::IsGzipPath(path)) {
+                WorkspaceBuilder::SupportFunctions::ReadGzipLines(path, [&](std::string_view line) {
+#ifdef _WIN32
+                    // Like an ifstream in text mode
+                    if (!line.empty() && line.back() == '\r') {
+                        line.remove_suffix(1);
+                    }
+#endif
+                    myLines.emplace_back(line);
+                });
+
+                // The getline loop below always ends with one more empty line, with or without a last '\n'
+                myLines.emplace_back();
+
+                return myLines;
+            }
+
+            std::ifstream myFile(path);
             std::string myLine;
 
             // Tell the runtime that an error ocurred while opening the file
@@ -66,6 +99,145 @@ namespace WorkspaceBuilder {
             return myLines;
         }
 
+        std::string_view NextLine(std::string_view buffer, size_t& offset) {
+            size_t lineStart = offset;
+            size_t lineEnd = buffer.find('\n', lineStart);
+
+            if (lineEnd == std::string_view::npos) {
+                lineEnd = buffer.size();
+                offset = buffer.size();
+            }
+            else {
+                offset = lineEnd + 1;
+            }
+
+            // Windows line endings are removed the same way an ifstream in text mode does
+            if (lineEnd > lineStart && buffer[lineEnd - 1] == '\r') {
+                lineEnd--;
+            }
+
+            return buffer.substr(lineStart, lineEnd - lineStart);
+        }
+
+        WorkspaceBuilder::Enums::LineType ClassifyLine(std::string_view line) {
+            if (line.empty())
+                return WorkspaceBuilder::Enums::LineType::BlankLine;
+
+            // The first character is enough to tell the line types apart
+            switch (line[0]) {
+            case '#':
+                return WorkspaceBuilder::Enums::LineType::CommentLine;
+            case 'G':
+                if (line.compare(0, 5, "Glyph") == 0)
+                    return WorkspaceBuilder::Enums::LineType::GlyphLine;
+                break;
+            case 'N':
+                if (line.compare(0, 14, "NodeConnection") == 0)
+                    return WorkspaceBuilder::Enums::LineType::ConnectionLine;
+                break;
+            case 'V':
+                if (line == "VariablesBegin:")
+                    return WorkspaceBuilder::Enums::LineType::VariablesBeginLine;
+                if (line == "VariablesEnd:")
+                    return WorkspaceBuilder::Enums::LineType::VariablesEndLine;
+                break;
+            }
+
+            return WorkspaceBuilder::Enums::LineType::OtherLine;
+        }
+
+        WorkspaceBuilder::Structs::LineClass AdvanceLine(std::string_view line, WorkspaceBuilder::Structs::LineCursor& cursor) {
+            WorkspaceBuilder::Structs::LineClass lineClass = { ClassifyLine(line), false };
+            cursor.lineNumber++;
+
+            // Global variables are checked apart from the line type because any line inside the section is a variable.
+            // Only the first section is read, like ParseWorkflowGlobalVariables does
+            if (!cursor.isVariableSectionDone) {
+                if (lineClass.type == WorkspaceBuilder::Enums::LineType::VariablesEndLine) {
+                    cursor.isVariableParserUp = false;
+                    cursor.isVariableSectionDone = true;
+                }
+                else if (cursor.isVariableParserUp && !line.empty() && line[0] != ' ' && line[0] != '#' && line[0] != '\0') {
+                    lineClass.isGlobalVariable = true;
+                }
+
+                // Must be in the end for the parser code doesn't catch the 'VariablesBegin:'
+                if (lineClass.type == WorkspaceBuilder::Enums::LineType::VariablesBeginLine) {
+                    cursor.isVariableParserUp = true;
+                }
+            }
+
+            return lineClass;
+        }
+
+        WorkspaceBuilder::Enums::ParseError TryParseInteger(std::string_view text, int& value) {
+            size_t start = 0;
+
+            // std::stoi skips leading white spaces and accepts an explicit '+'
+            while (start < text.size() && isspace((unsigned char)text[start])) {
+                start++;
+            }
+            if (start + 1 < text.size() && text[start] == '+' && text[start + 1] != '-') {
+                start++;
+            }
+
+            value = 0;
+            std::from_chars_result result = std::from_chars(text.data() + start, text.data() + text.size(), value);
+
+            if (result.ec == std::errc::invalid_argument) {
+                return WorkspaceBuilder::Enums::ParseError::InvalidInteger;
+            }
+            if (result.ec == std::errc::result_out_of_range) {
+                return WorkspaceBuilder::Enums::ParseError::IntegerOutOfRange;
+            }
+
+            return WorkspaceBuilder::Enums::ParseError::NoParseError;
+        }
+
+        int ParseInteger(std::string_view text) {
+            int value;
+            WorkspaceBuilder::Enums::ParseError error = TryParseInteger(text, value);
+
+            if (error != WorkspaceBuilder::Enums::ParseError::NoParseError) {
+                ThrowParseError(error);
+            }
+
+            return value;
+        }
+
+        const char* GetParseErrorMessage(WorkspaceBuilder::Enums::ParseError error) {
+            switch (error) {
+            case WorkspaceBuilder::Enums::ParseError::NoParseError: return "No error";
+            case WorkspaceBuilder::Enums::ParseError::InvalidInteger: return "Not a valid integer";
+            case WorkspaceBuilder::Enums::ParseError::IntegerOutOfRange: return "Integer out of range";
+            case WorkspaceBuilder::Enums::ParseError::InvalidVariableFormat: return "Not a valid format. Format must be a string like 'MyVariable MyValue'";
+            case WorkspaceBuilder::Enums::ParseError::MissingVariableValue: return "The variable has no value";
+            case WorkspaceBuilder::Enums::ParseError::MissingGlobalVariableValue: return "The global variable has no value after '= '";
+            case WorkspaceBuilder::Enums::ParseError::UnableToOpenFile: return "Unable to open file";
+            case WorkspaceBuilder::Enums::ParseError::MissingField: return "The line ends before all its fields";
+            case WorkspaceBuilder::Enums::ParseError::InvalidGzipFile: return "Not a valid gzip file";
+            default: return "Unknown error";
+            }
+        }
+
+        void ThrowParseError(WorkspaceBuilder::Enums::ParseError error) {
+            // Same exception types the parsers threw before they reported errors as codes
+            switch (error) {
+            case WorkspaceBuilder::Enums::ParseError::InvalidInteger:
+                throw std::invalid_argument("ParseInteger error >> Not a valid integer");
+            case WorkspaceBuilder::Enums::ParseError::IntegerOutOfRange:
+                throw std::out_of_range("ParseInteger error >> Integer out of range");
+            case WorkspaceBuilder::Enums::ParseError::InvalidVariableFormat:
+                throw std::runtime_error("Parse Variable error >> Not a valid format. Format must be a string like 'MyVariable MyValue'");
+            case WorkspaceBuilder::Enums::ParseError::MissingVariableValue:
+                throw std::out_of_range("ParseVariable error >> The variable has no value");
+            case WorkspaceBuilder::Enums::ParseError::MissingGlobalVariableValue:
+                throw std::out_of_range("ParseGlobalVariableLine error >> The global variable has no value");
+            default:
+                throw std::runtime_error(std::string("Parse error >> ") + GetParseErrorMessage(error));
+            }
+        }
+
         void PushEndline(std::vector<std::string>& stringVector, int endlineCount) {
             if (endlineCount < 0) endlineCount*(-1);
             
@@ -77,6 +249,27 @@ namespace WorkspaceBuilder {
         }
 
         bool SaveWkspfile(std::string filename, const std::vector<std::string>& lines) {
+            WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::SerializePhase);
+
+            if (WorkspaceBuilder::SupportFunctions::IsGzipPath(filename)) {
+                WorkspaceBuilder::SupportFunctions::GzipWriter writer(filename);
+
+                if (!writer.IsOpen()) {
+                    return false;
+                }
+
+                for (const std::string& line : lines) {
+                    std::string_view text = line;
+                    if (!text.empty() && text.back() == ' ') {
+                        text.remove_suffix(1);
+                    }
+                    writer.Write(text);
+                    writer.Write("\n");
+                }
+
+                return writer.Close();
+            }
+
             std::fstream myFile;
 
             myFile.open(filename, std::ios::out);
@@ -85,24 +278,29 @@ namespace WorkspaceBuilder {
                 return false;
             }
             else {
-                for (std::string line : lines) {
-                    if (line.back() == ' ') {
-                        line.pop_back();
+                for (const std::string& line : lines) {
+                    // The trailing space left by the converter is not written
+                    size_t length = line.size();
+                    if (length > 0 && line[length - 1] == ' ') {
+                        length--;
                     }
-                    line.append("\n");
-                    myFile << line;
+                    myFile.write(line.data(), length);
+                    myFile.put('\n');
                 }
 
                 myFile.close();
             }
 
-            return true;
+            // A full disk or a lost device only shows up in the stream state
+            return !myFile.fail();
         }
 	}
 
     namespace Functions {
         
         std::vector<WorkspaceBuilder::Structs::Comment> ParseWorkflowComments(const std::vector<std::string>& workflowLines, bool verbose) {
+            WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::CommentPhase);
+
             // Throw error if there is no line
             //      Prevents from initializing vectors and structs
             if (workflowLines.empty()) {
@@ -131,9 +329,7 @@ namespace WorkspaceBuilder {
                     comments.push_back(newComment);
 
                     // Print function comments if verbose parameter is true
-                    if (verbose) {
-                        std::cout << "Comment detected: \n" << "\t-> Line: " << i + 1 << "\n\t-> Comment: " << comment << '\n';
-                    }
+                    WORKSPACE_BUILDER_VERBOSE(verbose, "Comment detected: \n" << "\t-> Line: " << i + 1 << "\n\t-> Comment: " << comment << '\n');
                 }
             }
 
@@ -141,6 +337,8 @@ namespace WorkspaceBuilder {
         }
 
         std::vector<WorkspaceBuilder::Structs::Variable> ParseWorkflowGlobalVariables(const std::vector<std::string>& workflowLines, bool verbose) {
+            WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::GlobalVariablePhase);
+
             // List of variables for return
             std::vector<WorkspaceBuilder::Structs::Variable> variables;
             // Flag active when the VariableBegin is found
@@ -157,25 +355,7 @@ namespace WorkspaceBuilder {
 
                 // Formating variable
                 if (isVariableParserUp && workflowLines[i][0] != '\n' && workflowLines[i][0] != ' ' && workflowLines[i][0] != '#' && workflowLines[i][0] != '\0') {
-
-                    // To test: maybe a for will be faster than using find two times for getting indexes
-                    std::string variableKey = workflowLines[i].substr(0, workflowLines[i].find_first_of(' '));
-                    std::string variableValue = workflowLines[i].substr(workflowLines[i].find_first_of('=') + 2, workflowLines[i].size());
-
-                    WorkspaceBuilder::Enums::VariableType type = WorkspaceBuilder::Enums::VariableType::Integer;
-
-                    WorkspaceBuilder::Structs::Variable newVariable = {
-                        variableKey,
-                        variableValue,
-                        type
-                    };
-
-                    // Found variable log
-                    if (verbose) {
-                        std::cout << "\tNew variable found: \n" << "\t\t->Key: '" << variableKey << "'\n" << "\t\t->Value: '" << variableValue << "'\n\n";
-                    }
-
-                    variables.push_back(newVariable);
+                    variables.push_back(ParseGlobalVariableLine(workflowLines[i], verbose));
                 }
 
                 // Sinalizes that the search for variables has begun
@@ -189,26 +369,65 @@ namespace WorkspaceBuilder {
             return variables;
         }
 
-        WorkspaceBuilder::Structs::Variable ParseVariable(const std::string& variable) {
+        WorkspaceBuilder::Enums::ParseError TryParseGlobalVariableLineView(std::string_view line, WorkspaceBuilder::Structs::VariableView& variable) {
+            // Without a '=' the value starts at 1, like the std::string version did
+            size_t valueStart = line.find_first_of('=') + 2;
+
+            if (valueStart > line.size()) {
+                return WorkspaceBuilder::Enums::ParseError::MissingGlobalVariableValue;
+            }
+
+            // To test: maybe a for will be faster than using find two times for getting indexes
+            variable = {
+                line.substr(0, line.find_first_of(' ')),
+                line.substr(valueStart, line.size()),
+                WorkspaceBuilder::Enums::VariableType::Integer
+            };
+
+            return WorkspaceBuilder::Enums::ParseError::NoParseError;
+        }
+
+        WorkspaceBuilder::Structs::VariableView ParseGlobalVariableLineView(std::string_view line) {
+            WorkspaceBuilder::Structs::VariableView newVariable;
+            WorkspaceBuilder::Enums::ParseError error = TryParseGlobalVariableLineView(line, newVariable);
+
+            if (error != WorkspaceBuilder::Enums::ParseError::NoParseError) {
+                WorkspaceBuilder::SupportFunctions::ThrowParseError(error);
+            }
+
+            return newVariable;
+        }
+
+        WorkspaceBuilder::Structs::Variable ParseGlobalVariableLine(std::string_view line, bool verbose) {
+            WorkspaceBuilder::Structs::VariableView view = ParseGlobalVariableLineView(line);
+
+            // Found variable log
+            WORKSPACE_BUILDER_VERBOSE(verbose, "\tNew variable found: \n" << "\t\t->Key: '" << view.key << "'\n" << "\t\t->Value: '" << view.value << "'\n\n");
+
+            return ConvertVariableViewToVariable(view);
+        }
+
+        WorkspaceBuilder::Enums::ParseError TryParseVariableView(std::string_view variable, WorkspaceBuilder::Structs::VariableView& var) {
             int separator = variable.find_first_of(' ');
 
             if (separator == 0) {
-                throw std::runtime_error("Parse Variable error >> Not a valid format. Format must be a string like 'MyVariable MyValue'");
+                return WorkspaceBuilder::Enums::ParseError::InvalidVariableFormat;
             }
 
-            WorkspaceBuilder::Structs::Variable var;
-
             // Key and type will not be parsed
             var.key = variable.substr(0, separator);
 
+            // The view has no terminator, a missing value reads as '\0' like std::string does
+            char valueStart = separator + 1 < (int)variable.size() ? variable[separator + 1] : '\0';
+
             // Defines the variable type
-            if (variable[separator + 1] == '\'') {
+            if (valueStart == '\'') {
                 var.type = WorkspaceBuilder::Enums::VariableType::String;
             }
-            else if (variable[separator + 1] == '[') {
-                var.type = WorkspaceBuilder::Enums::VariableType::Image;
+            else if (valueStart == '[') {
+                var.type = WorkspaceBuilder::Enums::VariableType::Array;
             }
-            else if (isdigit(variable[separator + 1])) {
+            else if (isdigit((unsigned char)valueStart)) {
                 var.type = WorkspaceBuilder::Enums::VariableType::Integer;
             }
             else {
@@ -220,6 +439,10 @@ namespace WorkspaceBuilder {
                 // Start of value will be separator +2 so so remove the ' character we must add 1 and end up with three
                 int endPosition = variable.size() - separator - 3;
 
+                if (separator + 2 > (int)variable.size()) {
+                    return WorkspaceBuilder::Enums::ParseError::MissingVariableValue;
+                }
+
                 var.value = variable.substr(separator + 2, endPosition);
             }
             else {
@@ -227,174 +450,157 @@ namespace WorkspaceBuilder {
                 var.value = variable.substr(separator + 1, variable.size() - separator - 1);
             }
 
+            return WorkspaceBuilder::Enums::ParseError::NoParseError;
+        }
+
+        WorkspaceBuilder::Structs::VariableView ParseVariableView(std::string_view variable) {
+            WorkspaceBuilder::Structs::VariableView var;
+            WorkspaceBuilder::Enums::ParseError error = TryParseVariableView(variable, var);
+
+            if (error != WorkspaceBuilder::Enums::ParseError::NoParseError) {
+                WorkspaceBuilder::SupportFunctions::ThrowParseError(error);
+            }
+
             return var;
         }
 
-        WorkspaceBuilder::Structs::Block ParseBlockLine(const std::string& line, bool verbose) {
+        WorkspaceBuilder::Structs::Variable ParseVariable(std::string_view variable) {
+            return ConvertVariableViewToVariable(ParseVariableView(variable));
+        }
+
+        WorkspaceBuilder::Structs::Variable ConvertVariableViewToVariable(const WorkspaceBuilder::Structs::VariableView& view) {
+            WorkspaceBuilder::Structs::Variable variable = {
+                std::string(view.key),
+                std::string(view.value),
+                view.type,
+                WorkspaceBuilder::Functions::ParseParameterValue(view.value, view.type)
+            };
+
+            return variable;
+        }
+
+        WorkspaceBuilder::Enums::ParseError TryParseBlockLineView(std::string_view line, const WorkspaceBuilder::Structs::GlyphTokens& tokens, const std::vector<WorkspaceBuilder::Structs::FieldSpan>& variableSpans, std::vector<WorkspaceBuilder::Structs::VariableView>& variables, WorkspaceBuilder::Structs::BlockView& block, int& errorColumn, bool verbose) {
             // Glyph line composition:
                     //  Glyph tag > Lib > Function > hostmachine > Glyph Id > X position > Y position > args 
 
-            // Init variables positions
-            WorkspaceBuilder::Structs::Vector2 functionNameIndex = { 0, 0 };
-            WorkspaceBuilder::Structs::Vector2 hostMachineIndex = { 0, 0 };
-            WorkspaceBuilder::Structs::Vector2 glyphIdIndex = { 0, 0 };
-            WorkspaceBuilder::Structs::Vector2 xPositionIndex = { 0, 0 };
-            WorkspaceBuilder::Structs::Vector2 yPositionIndex = { 0, 0 };
-            WorkspaceBuilder::Structs::Vector2 functionArgsIndex = { 0, 0 };
-            int variableStart = 0;
-
             // Init variables
             int blockId = 0;
-            std::string variableRaw;
-            std::string blockType;
-            std::string blockHost;
+            std::string_view blockType;
+            std::string_view blockHost;
             WorkspaceBuilder::Structs::Vector2 blockPosition = { 0, 0 };
-            std::vector<WorkspaceBuilder::Structs::Variable> blockVariables;
-
-            int lineLength = line.size();
+            size_t firstVariable = variables.size();
+            int integerValue = 0;
+            WorkspaceBuilder::Structs::VariableView variableView;
+            WorkspaceBuilder::Enums::ParseError error = WorkspaceBuilder::Enums::ParseError::NoParseError;
+
+            // The variables of a broken line are not kept
+            auto fail = [&](uint32_t column) {
+                errorColumn = (int)column + 1;
+                variables.resize(firstVariable);
+                return error;
+            };
 
+            if (tokens.fieldCount > 0) {
+                blockType = line.substr(tokens.function.start, tokens.function.length);
 
-            for (int i = 13; i < lineLength; i++) {
-                // Defines split pattern
-                bool separator = line[i] == ':' && line[i - 1] != ':';
-                bool doubleSeparator = line[i] == ':' && line[i + 1] == ':';
-                bool variableSeparator = line[i] == ' ' && line[i + 1] == '-';
+                // Logs a detected function name
+                WORKSPACE_BUILDER_VERBOSE(verbose, "\tFunction name>> " << blockType << '\n');
+            }
+            if (tokens.fieldCount > 1) {
+                blockHost = line.substr(tokens.hostMachine.start, tokens.hostMachine.length);
 
-                // Logs which character is being parsed
-                /*if (verbose)
-                    std::cout << "Char " << i << ": " << line[i] << std::endl;*/
+                // Logs found hostname
+                WORKSPACE_BUILDER_VERBOSE(verbose, "\tHostname>> " << blockHost << '\n');
+            }
 
-                // Start position of function name
-                functionNameIndex.x = 13;
+            // Numbers and arguments are converted in line order, so the error reported is the first one of the line
+            const WorkspaceBuilder::Structs::FieldSpan* numberFields[3] = { &tokens.id, &tokens.x, &tokens.y };
+            size_t nextVariable = 0;
 
-                // Defines Function name
-                if (functionNameIndex.y == 0 && separator) {
-                    // End position of function name
-                    functionNameIndex.y = i;
+            for (int field = 2; field <= 5; field++) {
+                uint32_t fieldEnd = field < tokens.fieldCount ? tokens.fieldEnd[field] : UINT32_MAX;
 
-                    // The 13 number is the character count for 'Glyph:VGL_CL:'
-                    blockType = line.substr(functionNameIndex.x, functionNameIndex.y - 13);
+                for (; nextVariable < variableSpans.size() && variableSpans[nextVariable].start + variableSpans[nextVariable].length < fieldEnd; nextVariable++) {
+                    const WorkspaceBuilder::Structs::FieldSpan& span = variableSpans[nextVariable];
 
-                    // Logs a detected function name
-                    if (verbose)
-                        std::cout << "\tFunction name>> " << blockType << std::endl;
+                    // Add the found variable to the block variables list
+                    error = TryParseVariableView(line.substr(span.start, span.length), variableView);
+                    if (error != WorkspaceBuilder::Enums::ParseError::NoParseError) return fail(span.start);
+                    variables.push_back(variableView);
 
-                    // Defines initial position for hostmachine
-                    if (doubleSeparator) {
-                        hostMachineIndex.x = i + 2;
-                    }
-                    else {
-                        hostMachineIndex.x = i + 1;
-                    }
+                    // Logs the Function Variable
+                    WORKSPACE_BUILDER_VERBOSE(verbose, "\tFunction Variable>> " << line.substr(span.start, span.length) << '\n');
                 }
-                // Defines hostmachine
-                else if (hostMachineIndex.x != 0 && hostMachineIndex.y == 0 && separator) {
-                    // End position of hostmachine
-                    hostMachineIndex.y = i;
 
-                    blockHost = line.substr(hostMachineIndex.x, hostMachineIndex.y - hostMachineIndex.x);
-
-                    // Logs found hostname
-                    if (verbose)
-                        std::cout << "\tHostname>> " << blockHost << std::endl;
-
-                    // Defines initial position for GlyphId
-                    if (doubleSeparator) {
-                        glyphIdIndex.x = i + 2;
-                    }
-                    else {
-                        glyphIdIndex.x = i + 1;
-                    }
+                if (field == 5 || field >= tokens.fieldCount) {
+                    continue;
                 }
-                // Defines Glyph Id
-                else if (glyphIdIndex.x != 0 && glyphIdIndex.y == 0 && separator) {
-                    // End position of GlyphId
-                    glyphIdIndex.y = i;
 
-                    // stoi convert string to int
-                    blockId = std::stoi(line.substr(glyphIdIndex.x, i - glyphIdIndex.x));
+                // Convert string to int
+                const WorkspaceBuilder::Structs::FieldSpan& span = *numberFields[field - 2];
+                error = WorkspaceBuilder::SupportFunctions::TryParseInteger(line.substr(span.start, span.length), integerValue);
+                if (error != WorkspaceBuilder::Enums::ParseError::NoParseError) return fail(span.start);
 
-                    // Logs found Glyph Id
-                    if (verbose)
-                        std::cout << "\tGlyph Id>> " << blockId << std::endl;
+                if (field == 2) blockId = integerValue;
+                else if (field == 3) blockPosition.x = integerValue;
+                else blockPosition.y = integerValue;
 
-                    // Defines initial position for X Position in grid
-                    if (doubleSeparator) {
-                        xPositionIndex.x = i + 2;
-                    }
-                    else {
-                        xPositionIndex.x = i + 1;
-                    }
-                }
-                // Defines Position X
-                else if (xPositionIndex.x != 0 && xPositionIndex.y == 0 && separator) {
-                    // End position of X Position in grid
-                    xPositionIndex.y = i;
+                // Logs found Glyph Id and position
+                WORKSPACE_BUILDER_VERBOSE(verbose, (field == 2 ? "\tGlyph Id>> " : field == 3 ? "\tX Position>> " : "\tY Position>> ") << integerValue << '\n');
+            }
 
-                    blockPosition.x = std::stoi(line.substr(xPositionIndex.x, i - xPositionIndex.x));
+            block = {
+                blockId,
+                blockType,
+                blockHost,
+                blockPosition,
+                firstVariable,
+                variables.size() - firstVariable
+            };
 
-                    // Logs found X Position
-                    if (verbose)
-                        std::cout << "\tX Position>> " << blockPosition.x << std::endl;
+            return WorkspaceBuilder::Enums::ParseError::NoParseError;
+        }
 
-                    // Defines initial position for Y Position in grid
-                    if (doubleSeparator) {
-                        yPositionIndex.x = i + 2;
-                    }
-                    else {
-                        yPositionIndex.x = i + 1;
-                    }
-                }
-                // Defines Position Y
-                else if (yPositionIndex.x != 0 && yPositionIndex.y == 0 && separator) {
-                    // End position of Y Position in grid
-                    yPositionIndex.y = i;
+        WorkspaceBuilder::Enums::ParseError TryParseBlockLineView(std::string_view line, std::vector<WorkspaceBuilder::Structs::VariableView>& variables, WorkspaceBuilder::Structs::BlockView& block, int& errorColumn, bool verbose) {
+            // Reused between lines so tokenizing doesn't allocate
+            static thread_local std::vector<WorkspaceBuilder::Structs::FieldSpan> variableSpans;
+            WorkspaceBuilder::Structs::GlyphTokens tokens;
+            TokenizeGlyphLine(line, tokens, variableSpans);
 
-                    blockPosition.y = std::stoi(line.substr(yPositionIndex.x, i - yPositionIndex.x));
+            return TryParseBlockLineView(line, tokens, variableSpans, variables, block, errorColumn, verbose);
+        }
 
-                    // Logs found Y Position on the grid
-                    if (verbose)
-                        std::cout << "\tY Position>> " << blockPosition.y << std::endl;
-                }
-                // Get block variables
-                else if (line[i] == ' ' && line[i + 1] == '-' && variableStart == 0) {
-                    // Set the first variable start and used as a flag to warn that the following code will be variables
-                    variableStart = i + 2;
-                }
-                else if (variableSeparator && variableStart != 0) {
-                    // Set the first variable
-                    variableRaw = line.substr(variableStart, i - variableStart);
+        WorkspaceBuilder::Structs::BlockView ParseBlockLineView(std::string_view line, std::vector<WorkspaceBuilder::Structs::VariableView>& variables, bool verbose) {
+            WorkspaceBuilder::Structs::BlockView newBlock;
+            int errorColumn;
+            WorkspaceBuilder::Enums::ParseError error = TryParseBlockLineView(line, variables, newBlock, errorColumn, verbose);
 
-                    // Add the found variable to the block variables list
-                    blockVariables.push_back(ParseVariable(variableRaw));
+            if (error != WorkspaceBuilder::Enums::ParseError::NoParseError) {
+                WorkspaceBuilder::SupportFunctions::ThrowParseError(error);
+            }
 
-                    // Logs the Function Variable
-                    if (verbose)
-                        std::cout << "\tFunction Variable>> " << line.substr(variableStart, i - variableStart) << std::endl;
-                    // Points the next variable start, if there is one
-                    variableStart = i + 2;
-                }
-                else if (i == lineLength - 1 && variableStart != 0) {
-                    variableRaw = line.substr(variableStart);
+            return newBlock;
+        }
 
-                    // Add the las variable to the block variables list
-                    blockVariables.push_back(ParseVariable(variableRaw));
+        WorkspaceBuilder::Structs::Block ParseBlockLine(std::string_view line, bool verbose) {
+            std::vector<WorkspaceBuilder::Structs::VariableView> variableViews;
+            WorkspaceBuilder::Structs::BlockView view = ParseBlockLineView(line, variableViews, verbose);
 
-                    // Logs the Last function variable
-                    if (verbose)
-                        std::cout << "\tFunction Variable>> " << line.substr(variableStart) << std::endl;
-                }
+            std::vector<WorkspaceBuilder::Structs::Variable> blockVariables;
+            blockVariables.reserve(variableViews.size());
+            for (const WorkspaceBuilder::Structs::VariableView& variable : variableViews) {
+                blockVariables.push_back(ConvertVariableViewToVariable(variable));
             }
 
             std::vector<WorkspaceBuilder::Structs::Input> unitializedInputs;
             std::vector<WorkspaceBuilder::Structs::Output> unitializedOutputs;
 
             WorkspaceBuilder::Structs::Block newBlock = {
-                blockId,
-                blockType,
-                blockHost,
-                blockPosition,
-                blockVariables,
+                view.id,
+                std::string(view.type),
+                std::string(view.hostMachine),
+                view.position,
+                std::move(blockVariables),
                 unitializedInputs,
                 unitializedOutputs
             };
@@ -403,14 +609,14 @@ namespace WorkspaceBuilder {
         }
 
         std::vector<WorkspaceBuilder::Structs::Block> ParseWorkflowBlocks(const std::vector<std::string>& workflowLines, bool verbose) {
+            WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::BlockParsePhase);
             std::vector<WorkspaceBuilder::Structs::Block> blocks;
 
             // Parsing workflow file 
             for (int i = 0; i < workflowLines.size(); i++) {
-                if (workflowLines[i].substr(0, 5) == "Glyph") {
+                if (WorkspaceBuilder::SupportFunctions::ClassifyLine(workflowLines[i]) == WorkspaceBuilder::Enums::LineType::GlyphLine) {
 
-                    if (verbose)
-                        std::cout << "Found Glyph on line " << i + 1 << ">>> " << workflowLines[i] << std::endl;
+                    WORKSPACE_BUILDER_VERBOSE(verbose, "Found Glyph on line " << i + 1 << ">>> " << workflowLines[i] << '\n');
 
                     WorkspaceBuilder::Structs::Block newBlock = ParseBlockLine(workflowLines[i], verbose);
 
@@ -418,6 +624,8 @@ namespace WorkspaceBuilder {
                 }
             }
 
+            WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::BlockCounter, blocks.size());
+
             return blocks;
         }
 
@@ -439,8 +647,8 @@ namespace WorkspaceBuilder {
             return newInput;
         }
 
-        WorkspaceBuilder::Structs::Connection ParseConnectionLine(const std::string& line, int id, const std::vector<WorkspaceBuilder::Structs::Block>& blocks, bool verbose) {
-            WorkspaceBuilder::Structs::Connection newConnection;
+        WorkspaceBuilder::Enums::ParseError TryParseConnectionLineView(std::string_view line, int id, WorkspaceBuilder::Structs::ConnectionView& newConnection, int& errorColumn, bool verbose) {
+            WorkspaceBuilder::Enums::ParseError error = WorkspaceBuilder::Enums::ParseError::NoParseError;
 
             int lineSize = line.size();
 
@@ -456,13 +664,13 @@ namespace WorkspaceBuilder {
             WorkspaceBuilder::Structs::Vector2 glyphInput = { 0, 0 };
 
             // Connection variables
-            std::string dataTypeConnection;
-            std::string blockOutputIdString;
+            std::string_view dataTypeConnection;
+            std::string_view blockOutputIdString;
             int blockOutputId = 0;
-            std::string blockOutputName;
-            std::string blockInputIdString;
+            std::string_view blockOutputName;
+            std::string_view blockInputIdString;
             int blockInputId = 0;
-            std::string blockInputName;
+            std::string_view blockInputName;
 
 
             // 15 is where the variables start
@@ -476,11 +684,8 @@ namespace WorkspaceBuilder {
 
                     // Catch variable
                     dataTypeConnection = line.substr(dataType.x, dataType.y - dataType.x);
-                    // To lower
-                    WorkspaceBuilder::SupportFunctions::ToLower(dataTypeConnection);
 
-                    if (verbose)
-                        std::cout << "DataType = " << dataTypeConnection << std::endl;
+                    WORKSPACE_BUILDER_VERBOSE(verbose, "DataType = " << dataTypeConnection << '\n');
 
                 }
                 else if (glyphOutId.x == 0 && isSeparator) {
@@ -490,21 +695,22 @@ namespace WorkspaceBuilder {
                     // Catch string value
                     blockOutputIdString = line.substr(glyphOutId.x, glyphOutId.y - glyphOutId.x);
 
-                    if (verbose)
-                        std::cout << "Glyph Output Id = " << blockOutputIdString << std::endl;
+                    WORKSPACE_BUILDER_VERBOSE(verbose, "Glyph Output Id = " << blockOutputIdString << '\n');
 
                     // Convert to Integer
-                    blockOutputId = stoi(blockOutputIdString);
+                    error = WorkspaceBuilder::SupportFunctions::TryParseInteger(blockOutputIdString, blockOutputId);
+                    if (error != WorkspaceBuilder::Enums::ParseError::NoParseError) {
+                        errorColumn = glyphOutId.x + 1;
+                        return error;
+                    }
                 }
                 else if (glyphOutput.x == 0 && isSeparator) {
                     glyphOutput.x = glyphOutId.y + 1;
                     glyphOutput.y = i;
 
                     blockOutputName = line.substr(glyphOutput.x, glyphOutput.y - glyphOutput.x);
-                    WorkspaceBuilder::SupportFunctions::ToLower(blockOutputName);
 
-                    if (verbose)
-                        std::cout << "Glyph Output name = " << blockOutputName << std::endl;
+                    WORKSPACE_BUILDER_VERBOSE(verbose, "Glyph Output name = " << blockOutputName << '\n');
                 }
                 else if (glyphInId.x == 0 && isSeparator) {
                     glyphInId.x = glyphOutput.y + 1;
@@ -512,11 +718,14 @@ namespace WorkspaceBuilder {
 
                     blockInputIdString = line.substr(glyphInId.x, glyphInId.y - glyphInId.x);
 
-                    if (verbose)
-                        std::cout << "Glyph Input Id = " << blockInputIdString << std::endl;
+                    WORKSPACE_BUILDER_VERBOSE(verbose, "Glyph Input Id = " << blockInputIdString << '\n');
 
                     // Convert to Integer
-                    blockInputId = stoi(blockInputIdString);
+                    error = WorkspaceBuilder::SupportFunctions::TryParseInteger(blockInputIdString, blockInputId);
+                    if (error != WorkspaceBuilder::Enums::ParseError::NoParseError) {
+                        errorColumn = glyphInId.x + 1;
+                        return error;
+                    }
 
                 }
                 else if (glyphInput.x == 0 && isSeparator) {
@@ -524,10 +733,8 @@ namespace WorkspaceBuilder {
                     glyphInput.y = i;
 
                     blockInputName = line.substr(glyphInput.x);
-                    WorkspaceBuilder::SupportFunctions::ToLower(blockInputName);
 
-                    if (verbose)
-                        std::cout << "Glyph Input name = " << blockInputName << std::endl;
+                    WORKSPACE_BUILDER_VERBOSE(verbose, "Glyph Input name = " << blockInputName << '\n');
                 }
             }
 
@@ -540,10 +747,42 @@ namespace WorkspaceBuilder {
                 blockInputName
             };
 
+            return WorkspaceBuilder::Enums::ParseError::NoParseError;
+        }
+
+        WorkspaceBuilder::Structs::ConnectionView ParseConnectionLineView(std::string_view line, int id, bool verbose) {
+            WorkspaceBuilder::Structs::ConnectionView newConnection;
+            int errorColumn;
+            WorkspaceBuilder::Enums::ParseError error = TryParseConnectionLineView(line, id, newConnection, errorColumn, verbose);
+
+            if (error != WorkspaceBuilder::Enums::ParseError::NoParseError) {
+                WorkspaceBuilder::SupportFunctions::ThrowParseError(error);
+            }
+
+            return newConnection;
+        }
+
+        WorkspaceBuilder::Structs::Connection ParseConnectionLine(std::string_view line, int id, const std::vector<WorkspaceBuilder::Structs::Block>& blocks, bool verbose) {
+            WorkspaceBuilder::Structs::ConnectionView view = ParseConnectionLineView(line, id, verbose);
+
+            WorkspaceBuilder::Structs::Connection newConnection = {
+                view.id,
+                view.startBlock,
+                std::string(view.outputStartBlock.size(), '\0'),
+                view.endBlock,
+                std::string(view.inputEndBlock.size(), '\0')
+            };
+
+            // Port names are case insensitive, they are lowered while copied instead of copied and then lowered
+            WorkspaceBuilder::SupportFunctions::ToLower(view.outputStartBlock, &newConnection.outputStartBlock[0]);
+            WorkspaceBuilder::SupportFunctions::ToLower(view.inputEndBlock, &newConnection.inputEndBlock[0]);
+
             return newConnection;
         }
 
         std::vector<WorkspaceBuilder::Structs::Connection> ParseWorkflowConnections(const std::vector<std::string>& workflowLines, const std::vector<WorkspaceBuilder::Structs::Block>& blocks, bool verbose) {
+            WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::ConnectionParsePhase);
+
             // Throw error if there is no line
             //      Prevents from initializing vectors and structs
             if (workflowLines.empty()) {
@@ -555,7 +794,7 @@ namespace WorkspaceBuilder {
 
             // Loop for parsing the file
             for (int i = 0; i < workflowLines.size(); i++) {
-                if (workflowLines[i].substr(0, 14) == "NodeConnection") {
+                if (WorkspaceBuilder::SupportFunctions::ClassifyLine(workflowLines[i]) == WorkspaceBuilder::Enums::LineType::ConnectionLine) {
 
                     // Parssing connection
                     WorkspaceBuilder::Structs::Connection newConnection = ParseConnectionLine(workflowLines[i], connections.size(), blocks);
@@ -563,52 +802,42 @@ namespace WorkspaceBuilder {
                     connections.push_back(newConnection);
 
                     // Print function comments if verbose parameter is true
-                    if (verbose) {
-                        std::cout << "Connection detected: " << workflowLines[i] << '\n';
-                    }
+                    WORKSPACE_BUILDER_VERBOSE(verbose, "Connection detected: " << workflowLines[i] << '\n');
 
                 }
             }
 
-            if (verbose && connections.size() == 0) {
-                std::cout << "No connections where found";
-            }
+            WORKSPACE_BUILDER_VERBOSE(verbose && connections.size() == 0, "No connections where found");
+
+            WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::ConnectionCounter, connections.size());
 
             return connections;
         }
 
         WorkspaceBuilder::Structs::Workflow ParseWorkflow(const std::vector<std::string>& workflowLines, bool verbose) {
-            if (verbose)
-                std::cout << "Started parsing Workflow" << std::endl << std::endl;
+            WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::LineCounter, workflowLines.size());
+
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Started parsing Workflow\n\n");
 
 
-            if (verbose)
-                std::cout << "Started parsing Workflow Glyphs" << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Started parsing Workflow Glyphs\n");
             std::vector<WorkspaceBuilder::Structs::Block> blocks = ParseWorkflowBlocks(workflowLines, verbose);
-            if (verbose)
-                std::cout << "Finished parsing Workflow Glyphs" << std::endl << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Finished parsing Workflow Glyphs\n\n");
 
-            if (verbose)
-                std::cout << "Started parsing Workflow Connections" << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Started parsing Workflow Connections\n");
             std::vector<WorkspaceBuilder::Structs::Connection> connections = ParseWorkflowConnections(workflowLines, blocks, verbose);
-            if (verbose)
-                std::cout << "Started parsing Workflow Connections" << std::endl << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Started parsing Workflow Connections\n\n");
 
-            if (verbose)
-                std::cout << "Started parsing Workflow Comments" << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Started parsing Workflow Comments\n");
             std::vector<WorkspaceBuilder::Structs::Comment> comments = ParseWorkflowComments(workflowLines, verbose);
-            if (verbose)
-                std::cout << "Finished parsing Workflow Comments" << std::endl << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Finished parsing Workflow Comments\n\n");
 
-            if (verbose)
-                std::cout << "Started parsing Workflow Global Variables" << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Started parsing Workflow Global Variables\n");
             std::vector<WorkspaceBuilder::Structs::Variable> globalVariables = ParseWorkflowGlobalVariables(workflowLines, verbose);
-            if (verbose)
-                std::cout << "Finished parsing Global Variables" << std::endl << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Finished parsing Global Variables\n\n");
 
 
-            if (verbose)
-                std::cout << "Finished parsing Workflow" << std::endl << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Finished parsing Workflow\n\n");
 
 
             WorkspaceBuilder::Structs::Workflow workflow = {
@@ -621,14 +850,69 @@ namespace WorkspaceBuilder {
             return workflow;
         }
 
+        // cursor, byteCount and workflow are only read by the counters, which are empty without WORKSPACE_BUILDER_METRICS
+        static void FinishWorkflowParse([[maybe_unused]] const WorkspaceBuilder::Structs::LineCursor& cursor, [[maybe_unused]] size_t byteCount, [[maybe_unused]] const WorkspaceBuilder::Structs::Workflow& workflow, bool verbose) {
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Finished parsing Workflow\n\n");
+
+            WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::LineCounter, cursor.lineNumber);
+            WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::ByteCounter, byteCount);
+            WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::BlockCounter, workflow.blocks.size());
+            WORKSPACE_BUILDER_COUNT(WorkspaceBuilder::Enums::ConnectionCounter, workflow.connections.size());
+        }
+
+        WorkspaceBuilder::Structs::Workflow ParseWorkflowBuffer(std::string_view buffer, bool verbose) {
+            WorkspaceBuilder::Structs::Workflow workflow;
+            WorkspaceBuilder::Structs::LineCursor cursor;
+
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Started parsing Workflow\n\n");
+
+            // Each line is read and dispatched only once
+            WorkspaceBuilder::Structs::WorkflowLineSink sink = { workflow, 0, verbose };
+            WorkspaceBuilder::SupportFunctions::DispatchLines(buffer, cursor, sink);
+
+            FinishWorkflowParse(cursor, buffer.size(), workflow, verbose);
+
+            return workflow;
+        }
+
+        // Parses a compressed workflow while it is inflated, only the current chunk and line are in memory
+        static WorkspaceBuilder::Structs::Workflow LoadGzipWorkflow(const std::string& path, bool verbose) {
+            WorkspaceBuilder::Structs::Workflow workflow;
+            WorkspaceBuilder::Structs::LineCursor cursor;
+            WorkspaceBuilder::Structs::WorkflowLineSink sink = { workflow, 0, verbose };
+
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Started parsing Workflow\n\n");
+
+            size_t byteCount = WorkspaceBuilder::SupportFunctions::DispatchGzipLines(path, cursor, sink);
+
+            FinishWorkflowParse(cursor, byteCount, workflow, verbose);
+
+            return workflow;
+        }
+
+        WorkspaceBuilder::Structs::Workflow LoadWorkflow(const std::string& path, bool verbose) {
+            if (WorkspaceBuilder::SupportFunctions::IsGzipPath(path)) {
+                return LoadGzipWorkflow(path, verbose);
+            }
+
+            // The mapping lives until the parse ends, all strings are copied out of it
+            WorkspaceBuilder::SupportFunctions::MappedFile file;
+            {
+                WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::ReadPhase);
+                file = WorkspaceBuilder::SupportFunctions::MappedFile(path);
+            }
+
+            return ParseWorkflowBuffer(file.View(), verbose);
+        }
+
         std::vector<std::string> ConvertWorkflowToVectorString(const WorkspaceBuilder::Structs::Workflow& workflow, bool verbose) {
+            WORKSPACE_BUILDER_TRACE_PHASE(WorkspaceBuilder::Enums::SerializePhase);
             std::vector<std::string> workflowLines;
             std::string separator = ":";
 
             
             // Insert header
-            if (verbose)
-                std::cout << "Adding header" << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Adding header\n");
             
             workflowLines.push_back("# VisionGL Visual Programming Workspace");
             workflowLines.push_back("# ");
@@ -642,11 +926,10 @@ namespace WorkspaceBuilder {
             WorkspaceBuilder::SupportFunctions::PushEndline(workflowLines, 1);
             
             // Insert Variables
-            if (verbose)
-                std::cout << "Converting global variables" << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Converting global variables\n");
 
             workflowLines.push_back("VariablesBegin: ");
-            for (WorkspaceBuilder::Structs::Variable var : workflow.globalVariables) {
+            for (const WorkspaceBuilder::Structs::Variable& var : workflow.globalVariables) {
                 std::string line = var.key;
                 line.append(" = ");
                 if (var.type == WorkspaceBuilder::Enums::String) {
@@ -663,10 +946,9 @@ namespace WorkspaceBuilder {
             WorkspaceBuilder::SupportFunctions::PushEndline(workflowLines, 2);
 
             // Insert Glyphs
-            if (verbose)
-                std::cout << "Converting blocks" << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Converting blocks\n");
 
-            for (WorkspaceBuilder::Structs::Block block : workflow.blocks) {
+            for (const WorkspaceBuilder::Structs::Block& block : workflow.blocks) {
                 std::string line = "Glyph:VGL_CL:";
                 // Function type
                 line.append(block.type).append(separator);
@@ -684,10 +966,9 @@ namespace WorkspaceBuilder {
                 line.append(" ");
 
                 // Append parameters
-                if (verbose)
-                    std::cout << "\tConverting block parameter" << std::endl;
+                WORKSPACE_BUILDER_VERBOSE(verbose, "\tConverting block parameter\n");
 
-                for (WorkspaceBuilder::Structs::Variable var : block.variables) {
+                for (const WorkspaceBuilder::Structs::Variable& var : block.variables) {
                     line.append("-")
                         .append(var.key)
                         .append(" ");
@@ -707,10 +988,9 @@ namespace WorkspaceBuilder {
             WorkspaceBuilder::SupportFunctions::PushEndline(workflowLines, 2);
 
             // Insert Connections
-            if (verbose)
-                std::cout << "Converting connections" << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Converting connections\n");
 
-            for (WorkspaceBuilder::Structs::Connection connection : workflow.connections) {
+            for (const WorkspaceBuilder::Structs::Connection& connection : workflow.connections) {
                 std::string line = "NodeConnection:data:";
                 line.append(std::to_string(connection.startBlock)).append(separator);
                 line.append(connection.outputStartBlock).append(separator);
@@ -723,11 +1003,10 @@ namespace WorkspaceBuilder {
             WorkspaceBuilder::SupportFunctions::PushEndline(workflowLines, 2);
 
             // Insert Comments
-            if (verbose)
-                std::cout << "Converting comments" << std::endl;
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Converting comments\n");
 
             workflowLines.push_back("AnnotationsBegin");
-            for (WorkspaceBuilder::Structs::Comment comment : workflow.comments) {
+            for (const WorkspaceBuilder::Structs::Comment& comment : workflow.comments) {
                 std::string line = "#";
                 line.append(comment.text);
                 
@@ -743,22 +1022,56 @@ namespace WorkspaceBuilder {
         }
 
         int SaveWorkflow(std::string filename, const WorkspaceBuilder::Structs::Workflow& workflow, bool verbose) {
-            std::vector<std::string> convertedWorkflow;
+            // Reused between saves so autosaving doesn't allocate a new buffer every time
+            static thread_local std::string buffer;
             bool saved;
 
-            // Convert workspace function
-            if (verbose)
-                std::cout << "Converting workspace" << std::endl;
+            // Convert and save the workspace in batches, the text is the same as SaveWkspfile(ConvertWorkflowToVectorString)
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Saving workspace\n");
 
-            convertedWorkflow = ConvertWorkflowToVectorString(workflow, verbose);
+            saved = WriteWorkflowFile(filename, workflow, buffer);
 
-            // Save vector<string> to file adding \n to each line
-            if (verbose)
-                std::cout << "Saving workspace" << std::endl;
+            return saved;
+        }
+    }
+    namespace Structs {
+        void WorkflowLineSink::OnGlobalVariable(std::string_view line, [[maybe_unused]] int lineNumber) {
+            workflow.globalVariables.push_back(WorkspaceBuilder::Functions::ParseGlobalVariableLine(line, verbose));
 
-            saved = WorkspaceBuilder::SupportFunctions::SaveWkspfile(filename, convertedWorkflow);
+            WORKSPACE_BUILDER_LAP_PHASE(phaseTimer, WorkspaceBuilder::Enums::GlobalVariablePhase);
+        }
 
-            return saved;
+        void WorkflowLineSink::OnComment(std::string_view text, int lineNumber) {
+            // Initialize a position when the workflow file does not specifie where it should be in the Visual Workflow Editor
+            static const WorkspaceBuilder::Structs::Vector2 nullPosition = { 0.0, 0.0 };
+
+            WorkspaceBuilder::Structs::Comment newComment = {
+                lineNumber,
+                std::string(text),
+                nullPosition
+            };
+
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Comment detected: \n" << "\t-> Line: " << lineNumber << "\n\t-> Comment: " << newComment.text << '\n');
+
+            workflow.comments.push_back(std::move(newComment));
+
+            WORKSPACE_BUILDER_LAP_PHASE(phaseTimer, WorkspaceBuilder::Enums::CommentPhase);
+        }
+
+        void WorkflowLineSink::OnGlyph(std::string_view line, int lineNumber) {
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Found Glyph on line " << lineNumber << ">>> " << line << '\n');
+
+            workflow.blocks.push_back(WorkspaceBuilder::Functions::ParseBlockLine(line, verbose));
+
+            WORKSPACE_BUILDER_LAP_PHASE(phaseTimer, WorkspaceBuilder::Enums::BlockParsePhase);
+        }
+
+        void WorkflowLineSink::OnConnection(std::string_view line, [[maybe_unused]] int lineNumber) {
+            workflow.connections.push_back(WorkspaceBuilder::Functions::ParseConnectionLine(line, connectionIdOffset + (int)workflow.connections.size(), workflow.blocks));
+
+            WORKSPACE_BUILDER_VERBOSE(verbose, "Connection detected: " << line << '\n');
+
+            WORKSPACE_BUILDER_LAP_PHASE(phaseTimer, WorkspaceBuilder::Enums::ConnectionParsePhase);
         }
     }
 }
\ No newline at end of file
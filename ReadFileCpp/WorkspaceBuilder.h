@@ -1,5 +1,9 @@
 #pragma once
+#include "GzipStream.h"
+#include "Metrics.h"
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 #include <fstream>
@@ -13,18 +17,69 @@ namespace WorkspaceBuilder {
             Double,
             String,
             Image,
-            Data
+            Data,
+            // Numeric lists like '[0.0030, 0.0133]'
+            Array,
+            // The file doesn't say the type, like the block ports named only by connection lines
+            Unknown
+        };
+
+        // Describes how the value of a parameter was decoded
+        enum ParameterType {
+            IntegerParameter,
+            DoubleParameter,
+            StringParameter,
+            NumberArrayParameter
+        };
+
+        // Describes what a single line of a wksp file holds
+        enum LineType {
+            BlankLine,
+            CommentLine,
+            GlyphLine,
+            ConnectionLine,
+            VariablesBeginLine,
+            VariablesEndLine,
+            OtherLine
+        };
+
+        // Errors found by the parsers. The Try functions return them and the others throw them as exceptions
+        enum ParseError {
+            NoParseError,
+            InvalidInteger,
+            IntegerOutOfRange,
+            InvalidVariableFormat,
+            MissingVariableValue,
+            MissingGlobalVariableValue,
+            UnableToOpenFile,
+            // A Glyph or NodeConnection line ends before all its ':' separated fields
+            MissingField,
+            // A .wksp.gz file with broken or truncated data
+            InvalidGzipFile
         };
     }
     #pragma endregion
 
     #pragma region Structs
     namespace Structs {
+        // A variable value decoded from its text. Only the fields of its type are filled
+        struct ParameterValue {
+            WorkspaceBuilder::Enums::ParameterType type = WorkspaceBuilder::Enums::ParameterType::StringParameter;
+            int64_t integerValue = 0;
+            double doubleValue = 0.0;
+            // Numeric lists are stored contiguously, see GetFloatArray for the kernels that take float arrays.
+            //   Strings are not copied, their text is the variable value
+            std::vector<double> doubleArray;
+        };
+
         // Variables can be global or inside a block
         struct Variable {
             std::string key;
+            // The text as written in the file, saving writes it back unchanged
             std::string value;
             WorkspaceBuilder::Enums::VariableType type;
+            // The value decoded by the parser, see ConvertVariableViewToVariable
+            ParameterValue parameter;
         };
 
         // Used to store 2: floats X and Y
@@ -102,6 +157,90 @@ namespace WorkspaceBuilder {
             // A user can specify comments for a workflow that can be used to make a workflow more human readable
             std::vector<Comment> comments;
         };
+
+        // Non owning version of Variable. The texts point inside the parsed buffer
+        struct VariableView {
+            std::string_view key;
+            std::string_view value;
+            WorkspaceBuilder::Enums::VariableType type;
+        };
+
+        // Non owning version of Comment. The text points inside the parsed buffer
+        struct CommentView {
+            // Line position in the workflow file
+            int line;
+            // The text without the '#' character
+            std::string_view text;
+            // Grid position in the User interface
+            Vector2 position;
+        };
+
+        // Non owning version of Block. The texts point inside the parsed buffer
+        struct BlockView {
+            // Identificator
+            int id;
+            // Used to define what VGL function it represents
+            std::string_view type;
+            // hostMachine defines where will the block of code run
+            std::string_view hostMachine;
+            // The position in the 2d Grid
+            Vector2 position;
+            // Index of the first block variable in the shared variable list
+            size_t firstVariable;
+            // Number of variables that belong to this block
+            size_t variableCount;
+        };
+
+        // Non owning version of Connection. Port names are kept as written in the file
+        struct ConnectionView {
+            // Connection identificator
+            int id;
+            // The block in which the connection will begin
+            int startBlock;
+            // The output in which the connection will begin on that block
+            std::string_view outputStartBlock;
+            // The block in which the connection will finish
+            int endBlock;
+            // The input in which the connection will finish
+            std::string_view inputEndBlock;
+        };
+
+        // Keeps the state of a single pass parser between the lines of a wksp file
+        struct LineCursor {
+            // Number of the last line read, starting at 1
+            int lineNumber = 0;
+            // Active between 'VariablesBegin:' and 'VariablesEnd:'
+            bool isVariableParserUp = false;
+            // Active after the first 'VariablesEnd:'
+            bool isVariableSectionDone = false;
+        };
+
+        // What a single pass parser must do with a line
+        struct LineClass {
+            WorkspaceBuilder::Enums::LineType type;
+            // The line is inside the global variables section. It can also be of any other type
+            bool isGlobalVariable;
+        };
+
+        // Line sink of DispatchLine that appends what each line holds to an owning workflow
+        struct WorkflowLineSink {
+            Workflow& workflow;
+            // Added to the id of each connection, for parsers that fill a workflow in parts
+            int connectionIdOffset;
+            // If true prints in the console what the program is parsing
+            bool verbose;
+#ifdef WORKSPACE_BUILDER_METRICS
+            // Time of each kind of line, added to the metrics when the sink is destroyed at the end of the dispatch loop
+            WorkspaceBuilder::SupportFunctions::PhaseLapTimer phaseTimer;
+#endif
+
+            WorkflowLineSink(Workflow& workflow, int connectionIdOffset, bool verbose) : workflow(workflow), connectionIdOffset(connectionIdOffset), verbose(verbose) {}
+
+            void OnGlobalVariable(std::string_view line, int lineNumber);
+            void OnComment(std::string_view text, int lineNumber);
+            void OnGlyph(std::string_view line, int lineNumber);
+            void OnConnection(std::string_view line, int lineNumber);
+        };
     }
     #pragma endregion
 
@@ -115,6 +254,14 @@ namespace WorkspaceBuilder {
         */
         void ToLower(std::string& str);
 
+        /**
+        * Writes the lower case version of a text
+        *
+        * @param text: The text to be converted
+        * @param output: Receives text.size() characters. It may point to the text itself
+        */
+        void ToLower(std::string_view text, char* output);
+
         /**
         * Converts a string to a It's workflow enum type representative
         *
@@ -135,15 +282,181 @@ namespace WorkspaceBuilder {
 
         /**
         * Separete each line in a vector of strings on a wksp file
+        *   A .wksp.gz file is inflated in chunks while its lines are read.
         *
         * @param path: The string address of a valid file
         * @param verbose: If true prints in the console the comments found in the file. Default = false.
         * @return A vector of string containing each line on a wksp file
         *
-        * @throws Unable to open file> if the given path is invalid
+        * @throws Unable to open file> if the given path is invalid || Not a valid gzip file> if a .gz file is broken
         */
         std::vector<std::string> GetLinesFromFile(const std::string& path);
 
+        /**
+        * Reads the next line of a buffer without copying it. A trailing '\r' is removed like a text mode stream does.
+        *
+        * @param buffer: The whole wksp file content
+        * @param offset: Position where the line starts. It is moved to the start of the following line
+        * @return A view of the line without the line break
+        */
+        std::string_view NextLine(std::string_view buffer, size_t& offset);
+
+        /**
+        * Identifies what a wksp line holds by looking only at its prefix
+        *
+        * @param line: The line to be classified
+        * @return The line type
+        */
+        WorkspaceBuilder::Enums::LineType ClassifyLine(std::string_view line);
+
+        /**
+        * Classifies the next line of a single pass parse and keeps track of the global variables section
+        *
+        * @param line: The line to be classified
+        * @param cursor: The parser state. It is updated with this line
+        * @return The line type and whether it is a global variable
+        */
+        WorkspaceBuilder::Structs::LineClass AdvanceLine(std::string_view line, WorkspaceBuilder::Structs::LineCursor& cursor);
+
+        /**
+        * Sends a classified line to the sink method of what it holds. Every single pass parser uses it with its own sink,
+        *   which has OnGlobalVariable(line, lineNumber), OnComment(text, lineNumber), OnGlyph(line, lineNumber)
+        *   and OnConnection(line, lineNumber). A global variable line can also be of any other type
+        *
+        * @param line: The line without the line break
+        * @param lineClass: What the line holds, from AdvanceLine or ClassifyLine
+        * @param lineNumber: The line number, starting at 1
+        * @param sink: Receives the line. Comments are given without the '#' character
+        */
+        template <typename Sink>
+        void DispatchLine(std::string_view line, WorkspaceBuilder::Structs::LineClass lineClass, int lineNumber, Sink& sink) {
+            if (lineClass.isGlobalVariable) {
+                sink.OnGlobalVariable(line, lineNumber);
+            }
+
+            switch (lineClass.type) {
+            case WorkspaceBuilder::Enums::LineType::CommentLine:
+                sink.OnComment(line.substr(1), lineNumber);
+                break;
+            case WorkspaceBuilder::Enums::LineType::GlyphLine:
+                sink.OnGlyph(line, lineNumber);
+                break;
+            case WorkspaceBuilder::Enums::LineType::ConnectionLine:
+                sink.OnConnection(line, lineNumber);
+                break;
+            default:
+                break;
+            }
+        }
+
+        /**
+        * Reads the lines of a buffer in a single pass and sends each one to the sink, see DispatchLine
+        *
+        * @param buffer: The wksp file content
+        * @param cursor: The parser state. It is updated with every line
+        * @param sink: Receives the lines
+        */
+        template <typename Sink>
+        void DispatchLines(std::string_view buffer, WorkspaceBuilder::Structs::LineCursor& cursor, Sink& sink) {
+            size_t offset = 0;
+
+            while (offset < buffer.size()) {
+                std::string_view line = NextLine(buffer, offset);
+                WorkspaceBuilder::Structs::LineClass lineClass = AdvanceLine(line, cursor);
+
+                DispatchLine(line, lineClass, cursor.lineNumber, sink);
+            }
+        }
+
+        /**
+        * Same as DispatchGzipLines without throwing. When the data is broken the sink may have received the lines before it
+        *
+        * @param path: The string address of a gzip file
+        * @param cursor: The parser state. It is updated with every line
+        * @param sink: Receives the lines
+        * @param byteCount: Set to the size of the inflated text
+        * @return NoGzipError, or why the file could not be read
+        */
+        template <typename Sink>
+        WorkspaceBuilder::Enums::GzipError TryDispatchGzipLines(const std::string& path, WorkspaceBuilder::Structs::LineCursor& cursor, Sink& sink, size_t& byteCount) {
+            byteCount = 0;
+            bool isLineEnd;
+
+            WorkspaceBuilder::Enums::GzipError error = TryReadGzipLines(path, [&](std::string_view line) {
+                byteCount += line.size() + 1;
+
+                // Same as NextLine
+                if (!line.empty() && line.back() == '\r') {
+                    line.remove_suffix(1);
+                }
+
+                WorkspaceBuilder::Structs::LineClass lineClass = AdvanceLine(line, cursor);
+                DispatchLine(line, lineClass, cursor.lineNumber, sink);
+            }, isLineEnd);
+
+            // The last line has no '\n'
+            if (!isLineEnd) {
+                byteCount--;
+            }
+
+            return error;
+        }
+
+        /**
+        * Reads the lines of a .wksp.gz file while it is inflated and sends each one to the sink, see DispatchLine.
+        *   Only the current chunk and line are in memory
+        *
+        * @param path: The string address of a valid gzip file
+        * @param cursor: The parser state. It is updated with every line
+        * @param sink: Receives the lines
+        * @return The size of the inflated text
+        *
+        * @throws Unable to open file> if the given path is invalid || Not a valid gzip file> if the data is broken or truncated
+        */
+        template <typename Sink>
+        size_t DispatchGzipLines(const std::string& path, WorkspaceBuilder::Structs::LineCursor& cursor, Sink& sink) {
+            size_t byteCount;
+            ThrowGzipError(TryDispatchGzipLines(path, cursor, sink, byteCount));
+
+            return byteCount;
+        }
+
+        /**
+        * Converts a decimal string to int with the same rules as std::stoi, without allocating
+        *
+        * @param text: The number text. Leading white spaces are ignored
+        * @return The parsed integer
+        *
+        * @throws invalid_argument if there is no number || out_of_range if it doesn't fit in an int
+        */
+        int ParseInteger(std::string_view text);
+
+        /**
+        * Same as ParseInteger returning the error instead of throwing it
+        *
+        * @param text: The number text. Leading white spaces are ignored
+        * @param value: Receives the parsed integer
+        * @return NoParseError, InvalidInteger or IntegerOutOfRange
+        */
+        WorkspaceBuilder::Enums::ParseError TryParseInteger(std::string_view text, int& value);
+
+        /**
+        * Describes a parse error
+        *
+        * @param error: The error
+        * @return The error message
+        */
+        const char* GetParseErrorMessage(WorkspaceBuilder::Enums::ParseError error);
+
+        /**
+        * Throws a parse error as the exception the parsers always threw for it
+        *
+        * @param error: The error
+        *
+        * @throws invalid_argument for InvalidInteger || out_of_range for IntegerOutOfRange and missing values || runtime_error for the others
+        */
+        [[noreturn]] void ThrowParseError(WorkspaceBuilder::Enums::ParseError error);
+
         /**
         * Push back endline characters in the string vector.
         *
@@ -155,6 +468,7 @@ namespace WorkspaceBuilder {
 
         /**
         * Saves a vector<string> in filename as string.
+        *   When filename ends with ".gz" the text is gzip compressed as it is written, with '\n' line endings.
         *
         * @param filename: The path where the file will be saved
         * @param lines: A reference to the vector<string> that will be saved in the file.
@@ -197,7 +511,61 @@ namespace WorkspaceBuilder {
         *
         * @throws Not a valid format > if a variable is declared and is not following the pattern 'key value'
         */
-        WorkspaceBuilder::Structs::Variable ParseVariable(const std::string& variable);
+        WorkspaceBuilder::Structs::Variable ParseVariable(std::string_view variable);
+
+        /**
+        * Same as ParseVariable without copying the key and value
+        *
+        * @param variable: String address with the variable to be parsed.
+        * @return A variable pointing inside the given string
+        *
+        * @throws Not a valid format > if a variable is declared and is not following the pattern 'key value'
+        */
+        WorkspaceBuilder::Structs::VariableView ParseVariableView(std::string_view variable);
+
+        /**
+        * Same as ParseVariableView returning the error instead of throwing it
+        *
+        * @param variable: String address with the variable to be parsed.
+        * @param var: Receives the variable pointing inside the given string
+        * @return NoParseError, InvalidVariableFormat or MissingVariableValue
+        */
+        WorkspaceBuilder::Enums::ParseError TryParseVariableView(std::string_view variable, WorkspaceBuilder::Structs::VariableView& var);
+
+        /**
+        * Copies a variable view and decodes its value with ParseParameterValue. Every parser and loader makes its variables here,
+        *   so Variable::parameter always matches the text
+        *
+        * @param view: The variable pointing inside the parsed buffer
+        * @return The variable with its own key and value and the decoded parameter
+        */
+        WorkspaceBuilder::Structs::Variable ConvertVariableViewToVariable(const WorkspaceBuilder::Structs::VariableView& view);
+
+        /**
+        * Convert a global variable line "key = value" to It's VGL workspace equivalent
+        *
+        * @param line: String address with the line inside the VariablesBegin/VariablesEnd section.
+        * @param verbose: If true prints in the console the variable found. Default = false
+        * @return The parsed variable
+        */
+        WorkspaceBuilder::Structs::Variable ParseGlobalVariableLine(std::string_view line, bool verbose = false);
+
+        /**
+        * Same as ParseGlobalVariableLine without copying the key and value
+        *
+        * @param line: String address with the line inside the VariablesBegin/VariablesEnd section.
+        * @return A variable pointing inside the given line
+        */
+        WorkspaceBuilder::Structs::VariableView ParseGlobalVariableLineView(std::string_view line);
+
+        /**
+        * Same as ParseGlobalVariableLineView returning the error instead of throwing it
+        *
+        * @param line: String address with the line inside the VariablesBegin/VariablesEnd section.
+        * @param variable: Receives the variable pointing inside the given line
+        * @return NoParseError or MissingGlobalVariableValue
+        */
+        WorkspaceBuilder::Enums::ParseError TryParseGlobalVariableLineView(std::string_view line, WorkspaceBuilder::Structs::VariableView& variable);
 
         /**
         * Parses a string represinting a block to It's VGL workspace structure.
@@ -210,7 +578,31 @@ namespace WorkspaceBuilder {
         *
         * @throws Not a valid format > if a variable is declared and is not following the pattern 'key value' 
         */
-        WorkspaceBuilder::Structs::Block ParseBlockLine(const std::string& line, bool verbose = false);
+        WorkspaceBuilder::Structs::Block ParseBlockLine(std::string_view line, bool verbose = false);
+
+        /**
+        * Same as ParseBlockLine without copying the block texts
+        *
+        * @param line: String address with the represented glyph to be parsed.
+        * @param variables: List where the block variables are appended. The block keeps their position in it
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return A VGL block pointing inside the given line
+        *
+        * @throws Not a valid format > if a variable is declared and is not following the pattern 'key value'
+        */
+        WorkspaceBuilder::Structs::BlockView ParseBlockLineView(std::string_view line, std::vector<WorkspaceBuilder::Structs::VariableView>& variables, bool verbose = false);
+
+        /**
+        * Same as ParseBlockLineView returning the error instead of throwing it
+        *
+        * @param line: String address with the represented glyph to be parsed.
+        * @param variables: List where the block variables are appended. Nothing is appended when there is an error
+        * @param block: Receives the block pointing inside the given line
+        * @param errorColumn: Receives the column, starting at 1, of the field with the error
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return NoParseError or the first error of the line
+        */
+        WorkspaceBuilder::Enums::ParseError TryParseBlockLineView(std::string_view line, std::vector<WorkspaceBuilder::Structs::VariableView>& variables, WorkspaceBuilder::Structs::BlockView& block, int& errorColumn, bool verbose = false);
 
         /**
         * Parses the workflow and identify the block lines and parses them
@@ -250,7 +642,29 @@ namespace WorkspaceBuilder {
         * @param verbose: If true prints in the console what the program is parsing. Default = false
         * @return A VGL connection structure
         */
-        WorkspaceBuilder::Structs::Connection ParseConnectionLine(const std::string& line, int id,const std::vector<WorkspaceBuilder::Structs::Block>& blocks, bool verbose = false);
+        WorkspaceBuilder::Structs::Connection ParseConnectionLine(std::string_view line, int id, const std::vector<WorkspaceBuilder::Structs::Block>& blocks, bool verbose = false);
+
+        /**
+        * Same as ParseConnectionLine without copying the port names. Names are not converted to lower case.
+        *
+        * @param line: String address with the represented connection to be parsed.
+        * @param id: The connection identificator
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return A VGL connection pointing inside the given line
+        */
+        WorkspaceBuilder::Structs::ConnectionView ParseConnectionLineView(std::string_view line, int id, bool verbose = false);
+
+        /**
+        * Same as ParseConnectionLineView returning the error instead of throwing it
+        *
+        * @param line: String address with the represented connection to be parsed.
+        * @param id: The connection identificator
+        * @param connection: Receives the connection pointing inside the given line
+        * @param errorColumn: Receives the column, starting at 1, of the field with the error
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return NoParseError or the first error of the line
+        */
+        WorkspaceBuilder::Enums::ParseError TryParseConnectionLineView(std::string_view line, int id, WorkspaceBuilder::Structs::ConnectionView& connection, int& errorColumn, bool verbose = false);
 
         /**
         * Parses the workflow and identify the connection lines and parses them
@@ -271,6 +685,30 @@ namespace WorkspaceBuilder {
         */
         WorkspaceBuilder::Structs::Workflow ParseWorkflow(const std::vector<std::string>& workflowLines, bool verbose = false);
 
+        /**
+        * Convert a whole wksp file content in a workflow structure reading each line only once.
+        *   The result is the same as ParseWorkflow over the lines of the buffer. When several lines are not valid
+        *   the exception is the one of the first of them, ParseWorkflow reports the blocks before the global variables.
+        *
+        * @param buffer: The wksp file content
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return A VGL Workflow structure
+        */
+        WorkspaceBuilder::Structs::Workflow ParseWorkflowBuffer(std::string_view buffer, bool verbose = false);
+
+        /**
+        * Memory maps a wksp file and parses it in a single pass.
+        *   Replaces GetLinesFromFile + ParseWorkflow without copying the file into lines.
+        *   A .wksp.gz file is parsed line by line while it is inflated instead.
+        *
+        * @param path: The string address of a valid file
+        * @param verbose: If true prints in the console what the program is parsing. Default = false
+        * @return A VGL Workflow structure
+        *
+        * @throws Unable to open file> if the given path is invalid || Not a valid gzip file> if a .gz file is broken
+        */
+        WorkspaceBuilder::Structs::Workflow LoadWorkflow(const std::string& path, bool verbose = false);
+
         /**
         * Convert a workflow structure in a vector<string> 
         *